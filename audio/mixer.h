@@ -26,6 +26,8 @@
 #include "common/types.h"
 #include "common/noncopyable.h"
 
+#include "audio/rate.h"
+
 namespace Audio {
 
 class AudioStream;
@@ -277,6 +279,21 @@ public:
 	 * @return the output sample rate in Hz
 	 */
 	virtual uint getOutputRate() const = 0;
+
+	/**
+	 * Set the quality of the sample rate conversion. This only affects
+	 * sounds started afterwards.
+	 *
+	 * @param quality the new quality
+	 */
+	virtual void setRateConverterQuality(RateConverterQuality quality) = 0;
+
+	/**
+	 * Query the quality of the sample rate conversion.
+	 *
+	 * @return the quality used for new sounds
+	 */
+	virtual RateConverterQuality getRateConverterQuality() const = 0;
 };
 
 
@@ -57,6 +57,7 @@ private:
 	Common::Mutex _mutex;
 
 	const uint _sampleRate;
+	RateConverterQuality _rateConverterQuality;
 	bool _mixerReady;
 	uint32 _handleSeed;
 
@@ -118,6 +119,9 @@ public:
 
 	virtual uint getOutputRate() const;
 
+	virtual void setRateConverterQuality(RateConverterQuality quality);
+	virtual RateConverterQuality getRateConverterQuality() const;
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
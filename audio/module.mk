@@ -56,7 +56,8 @@ MODULE_OBJS := \
 	softsynth/eas.o \
 	softsynth/pcspk.o \
 	softsynth/sid.o \
-	softsynth/wave6581.o
+	softsynth/wave6581.o \
+	rate_sinc.o
 
 ifdef USE_ALSA
 MODULE_OBJS += \
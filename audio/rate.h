@@ -78,7 +78,16 @@ public:
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+/**
+ * Quality of the sample rate conversion, trading CPU time for less aliasing.
+ */
+enum RateConverterQuality {
+	kRateQualityLow,	///< Drop samples or interpolate linearly
+	kRateQualityMedium,	///< Windowed sinc filter with 16 taps
+	kRateQualityHigh	///< Windowed sinc filter with 48 taps
+};
+
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, RateConverterQuality quality = kRateQualityLow);
 
 } // End of namespace Audio
 
@@ -44,6 +44,7 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "audio/rate_intern.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -436,9 +437,13 @@ public:
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterQuality quality) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0) {
+		// The fixed point converters can not handle rates of 65536 Hz and
+		// above, use the filter instead.
+		if (quality != kRateQualityLow || inrate >= 65536 || outrate >= 65536) {
+			return makeSincRateConverter(inrate, outrate, stereo, reverseStereo, quality);
+		} else if ((inrate % outrate) == 0) {
 			if (stereo) {
 				if (reverseStereo)
 					return new SimpleRateConverter<true, true>(inrate, outrate);
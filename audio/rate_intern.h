@@ -0,0 +1,181 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "common/simd.h"
+#include "common/util.h"
+
+namespace Audio {
+
+/*
+ * Mixing kernels shared by all converters. They add frames to the stereo
+ * output buffer, scaling them with the channel volumes and clamping the
+ * result, exactly like clampedAdd() would do it one sample at a time.
+ *
+ * The SIMD versions take the product of a sample and its volume modulo 2^32
+ * and saturate the quotient to 16 bits before adding it. This matches the
+ * scalar code as long as the volumes do not exceed kMaxMixerVolume, which
+ * the mixer guarantees; other volumes use the scalar loop.
+ */
+
+#if defined(SCUMMVM_SSE2) && !defined(OUTPUT_UNSIGNED_AUDIO)
+
+/** Mix 8 samples, dividing the volume products by kMaxMixerVolume. */
+static inline __m128i mixSamplesSSE2(__m128i out, __m128i in, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(in, vol);
+	const __m128i hi = _mm_mulhi_epi16(in, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+	// Divide by 256, rounding towards zero like the integer division does
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_srli_epi32(_mm_srai_epi32(p0, 31), 24)), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_srli_epi32(_mm_srai_epi32(p1, 31), 24)), 8);
+
+	return _mm_adds_epi16(out, _mm_packs_epi32(p0, p1));
+}
+
+/** Mix as many whole blocks of frames as possible, returning the number of frames done. */
+template<bool stereo, bool reverseStereo>
+static st_size_t mixFramesSSE2(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, int volA, int volB) {
+	const __m128i vol = _mm_set_epi16(volB, volA, volB, volA, volB, volA, volB, volA);
+	st_size_t done = 0;
+
+	if (stereo) {
+		for (; done + 4 <= frames; done += 4) {
+			__m128i samples = _mm_loadu_si128((const __m128i *)(in + done * 2));
+			if (reverseStereo)
+				samples = _mm_shufflehi_epi16(_mm_shufflelo_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+
+			__m128i *out = (__m128i *)(obuf + done * 2);
+			_mm_storeu_si128(out, mixSamplesSSE2(_mm_loadu_si128(out), samples, vol));
+		}
+	} else {
+		for (; done + 8 <= frames; done += 8) {
+			const __m128i samples = _mm_loadu_si128((const __m128i *)(in + done));
+
+			__m128i *out = (__m128i *)(obuf + done * 2);
+			_mm_storeu_si128(out, mixSamplesSSE2(_mm_loadu_si128(out), _mm_unpacklo_epi16(samples, samples), vol));
+			_mm_storeu_si128(out + 1, mixSamplesSSE2(_mm_loadu_si128(out + 1), _mm_unpackhi_epi16(samples, samples), vol));
+		}
+	}
+
+	return done;
+}
+
+#elif defined(SCUMMVM_NEON) && !defined(OUTPUT_UNSIGNED_AUDIO)
+
+/** Mix 8 samples, dividing the volume products by kMaxMixerVolume. */
+static inline int16x8_t mixSamplesNEON(int16x8_t out, int16x8_t in, int16x8_t vol) {
+	int32x4_t p0 = vmull_s16(vget_low_s16(in), vget_low_s16(vol));
+	int32x4_t p1 = vmull_s16(vget_high_s16(in), vget_high_s16(vol));
+
+	// Divide by 256, rounding towards zero like the integer division does
+	p0 = vshrq_n_s32(vaddq_s32(p0, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p0, 31)), 24))), 8);
+	p1 = vshrq_n_s32(vaddq_s32(p1, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p1, 31)), 24))), 8);
+
+	return vqaddq_s16(out, vcombine_s16(vqmovn_s32(p0), vqmovn_s32(p1)));
+}
+
+/** Mix as many whole blocks of frames as possible, returning the number of frames done. */
+template<bool stereo, bool reverseStereo>
+static st_size_t mixFramesNEON(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, int volA, int volB) {
+	const int16 volumes[8] = { (int16)volA, (int16)volB, (int16)volA, (int16)volB, (int16)volA, (int16)volB, (int16)volA, (int16)volB };
+	const int16x8_t vol = vld1q_s16(volumes);
+	st_size_t done = 0;
+
+	if (stereo) {
+		for (; done + 4 <= frames; done += 4) {
+			int16x8_t samples = vld1q_s16(in + done * 2);
+			if (reverseStereo)
+				samples = vrev32q_s16(samples);
+
+			st_sample_t *out = obuf + done * 2;
+			vst1q_s16(out, mixSamplesNEON(vld1q_s16(out), samples, vol));
+		}
+	} else {
+		for (; done + 8 <= frames; done += 8) {
+			const int16x8_t samples = vld1q_s16(in + done);
+			const int16x8x2_t pairs = vzipq_s16(samples, samples);
+
+			st_sample_t *out = obuf + done * 2;
+			vst1q_s16(out, mixSamplesNEON(vld1q_s16(out), pairs.val[0], vol));
+			vst1q_s16(out + 8, mixSamplesNEON(vld1q_s16(out + 8), pairs.val[1], vol));
+		}
+	}
+
+	return done;
+}
+
+#endif
+
+/**
+ * Mix frames (interleaved if stereo) into the stereo output buffer obuf.
+ */
+template<bool stereo, bool reverseStereo>
+static void mixFrames(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	// Volumes of the left and right output channel
+	const int volA = reverseStereo ? vol_r : vol_l;
+	const int volB = reverseStereo ? vol_l : vol_r;
+	st_size_t done = 0;
+
+#if defined(SCUMMVM_SSE2) && !defined(OUTPUT_UNSIGNED_AUDIO)
+	if (vol_l <= Audio::Mixer::kMaxMixerVolume && vol_r <= Audio::Mixer::kMaxMixerVolume)
+		done = mixFramesSSE2<stereo, reverseStereo>(obuf, in, frames, volA, volB);
+#elif defined(SCUMMVM_NEON) && !defined(OUTPUT_UNSIGNED_AUDIO)
+	if (vol_l <= Audio::Mixer::kMaxMixerVolume && vol_r <= Audio::Mixer::kMaxMixerVolume)
+		done = mixFramesNEON<stereo, reverseStereo>(obuf, in, frames, volA, volB);
+#endif
+
+	obuf += done * 2;
+	in += done * (stereo ? 2 : 1);
+
+	for (; done < frames; ++done) {
+		st_sample_t out0, out1;
+		out0 = *in++;
+		out1 = (stereo ? *in++ : out0);
+
+		if (reverseStereo)
+			SWAP(out0, out1);
+
+		// output left channel
+		clampedAdd(obuf[0], (out0 * volA) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[1], (out1 * volB) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+	}
+}
+
+/**
+ * Create a converter based on a windowed sinc filter, which supports any
+ * pair of rates. It is shared by the generic and the ARM rate converters.
+ */
+RateConverter *makeSincRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterQuality quality);
+
+} // End of namespace Audio
+
+#endif
@@ -0,0 +1,348 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/audiostream.h"
+#include "audio/rate_intern.h"
+#include "common/algorithm.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Audio {
+
+/**
+ * The size of the intermediate input and output buffers.
+ */
+#define INTERMEDIATE_BUFFER_SIZE 512
+
+
+/**
+ * Dot product of two arrays of 16 bit values. The length must be a
+ * multiple of 8.
+ */
+static inline int32 dotProduct(const int16 *a, const int16 *b, uint len) {
+#if defined(SCUMMVM_SSE2)
+	__m128i acc = _mm_setzero_si128();
+	for (uint i = 0; i < len; i += 8)
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(a + i)), _mm_loadu_si128((const __m128i *)(b + i))));
+
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(acc);
+#elif defined(SCUMMVM_NEON)
+	int32x4_t acc = vdupq_n_s32(0);
+	for (uint i = 0; i < len; i += 8) {
+		const int16x8_t va = vld1q_s16(a + i);
+		const int16x8_t vb = vld1q_s16(b + i);
+		acc = vmlal_s16(acc, vget_low_s16(va), vget_low_s16(vb));
+		acc = vmlal_s16(acc, vget_high_s16(va), vget_high_s16(vb));
+	}
+
+	const int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+	return vget_lane_s32(vpadd_s32(sum, sum), 0);
+#else
+	int32 acc = 0;
+	for (uint i = 0; i < len; ++i)
+		acc += a[i] * b[i];
+	return acc;
+#endif
+}
+
+/** Modified Bessel function of the first kind and order zero, for the Kaiser window. */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 50 && term > sum * 1e-12; ++k) {
+		const double t = x / (2 * k);
+		term *= t * t;
+		sum += term;
+	}
+	return sum;
+}
+
+/**
+ * Audio rate converter based on a polyphase windowed sinc filter.
+ *
+ * The output position is tracked exactly as a fraction of the input rate,
+ * so any pair of rates (including those above 65535 Hz) is supported.
+ * When the reduced output rate has more than kMaxPhases steps per input
+ * sample, the filter phases are interpolated linearly.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	enum {
+		kMaxPhases = 256,
+		kMaxTaps = 512,
+		kCoefficientBits = 14
+	};
+
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** converted frames, waiting to be mixed into the output buffer */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** the filter coefficients, numTaps for each of the numPhases + 1 phases */
+	int16 *filters;
+	uint numTaps;
+	uint numPhases;
+
+	/** input samples of each channel, the filter is applied at histStart */
+	st_sample_t *history[2];
+	uint historySize;
+	uint histStart;
+	uint histEnd;
+
+	/** silent frames still to append once the input ended, to drain the filter */
+	uint padding;
+
+	/** the output position between two input samples is opos / outStep */
+	uint32 opos;
+
+	/** input and output rate, divided by their greatest common divisor */
+	uint32 inStep, outStep;
+
+	bool refill(AudioStream &input);
+	st_sample_t convert(const st_sample_t *samples) const;
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality);
+	~SincRateConverter();
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+
+/*
+ * Prepare processing.
+ */
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality) {
+	const uint32 divisor = Common::gcd(inrate, outrate);
+	inStep = inrate / divisor;
+	outStep = outrate / divisor;
+	numPhases = MIN<uint32>(outStep, kMaxPhases);
+
+	// Taps and Kaiser window parameter for upsampling. When downsampling,
+	// the filter has to be widened by the rate ratio to cut off at the
+	// output Nyquist frequency instead of the input one.
+	uint baseTaps;
+	double beta, rolloff;
+	if (quality == kRateQualityHigh) {
+		baseTaps = 48;
+		beta = 9.0;
+		rolloff = 0.95;
+	} else {
+		baseTaps = 16;
+		beta = 6.0;
+		rolloff = 0.9;
+	}
+
+	double cutoff = rolloff;
+	numTaps = baseTaps;
+	if (inStep > outStep) {
+		cutoff = rolloff * outStep / inStep;
+		numTaps = MIN<uint>((uint)(baseTaps * (double)inStep / outStep + 7) & ~7, kMaxTaps);
+	}
+
+	// The filter window must cover every input sample skipped by one output
+	numTaps = MAX<uint>(numTaps, ((inStep + outStep - 1) / outStep + 8) & ~7);
+
+	filters = new int16[numTaps * (numPhases + 1)];
+
+	const double center = numTaps / 2 - 1;
+	const double windowScale = 1.0 / besselI0(beta);
+	double *taps = new double[numTaps];
+
+	for (uint phase = 0; phase <= numPhases; ++phase) {
+		const double t = (double)phase / numPhases;
+		double sum = 0.0;
+
+		for (uint tap = 0; tap < numTaps; ++tap) {
+			const double d = tap - center - t;
+			const double x = d / (numTaps / 2);
+			const double window = (x > -1.0 && x < 1.0) ? besselI0(beta * sqrt(1.0 - x * x)) * windowScale : 0.0;
+			const double arg = M_PI * cutoff * d;
+			const double sinc = (d == 0.0) ? 1.0 : sin(arg) / arg;
+
+			taps[tap] = cutoff * sinc * window;
+			sum += taps[tap];
+		}
+
+		// Normalize each phase to unity gain. The rounding error goes to the
+		// largest coefficient, so that a constant signal passes unchanged.
+		int16 *filter = filters + phase * numTaps;
+		int total = 0;
+		uint largest = 0;
+		for (uint tap = 0; tap < numTaps; ++tap) {
+			filter[tap] = (int16)floor(taps[tap] / sum * (1 << kCoefficientBits) + 0.5);
+			total += filter[tap];
+			if (filter[tap] > filter[largest])
+				largest = tap;
+		}
+		filter[largest] += (1 << kCoefficientBits) - total;
+	}
+
+	delete[] taps;
+
+	// Start with enough silence to center the filter on the first sample
+	historySize = numTaps + INTERMEDIATE_BUFFER_SIZE;
+	for (int channel = 0; channel < 2; ++channel) {
+		history[channel] = new st_sample_t[historySize];
+		memset(history[channel], 0, historySize * sizeof(st_sample_t));
+	}
+
+	histStart = 0;
+	histEnd = numTaps / 2 - 1;
+	padding = numTaps / 2;
+	opos = 0;
+}
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::~SincRateConverter() {
+	delete[] filters;
+	delete[] history[0];
+	delete[] history[1];
+}
+
+/*
+ * Move the samples the filter still needs to the start of the history and
+ * append new input. At the end of the stream, append silence instead until
+ * the filter has been centered on the last input sample.
+ */
+template<bool stereo, bool reverseStereo>
+bool SincRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	const uint kept = histEnd - histStart;
+	for (int channel = 0; channel < (stereo ? 2 : 1); ++channel)
+		memmove(history[channel], history[channel] + histStart, kept * sizeof(st_sample_t));
+	histStart = 0;
+	histEnd = kept;
+
+	const uint frames = MIN<uint>(historySize - histEnd, ARRAYSIZE(inBuf) / (stereo ? 2 : 1));
+	const int len = input.readBuffer(inBuf, frames * (stereo ? 2 : 1));
+	if (len <= 0) {
+		if (!padding || !input.endOfStream())
+			return false;
+
+		const uint silence = MIN<uint>(padding, historySize - histEnd);
+		for (int channel = 0; channel < (stereo ? 2 : 1); ++channel)
+			memset(history[channel] + histEnd, 0, silence * sizeof(st_sample_t));
+		histEnd += silence;
+		padding -= silence;
+		return true;
+	}
+
+	const st_sample_t *inPtr = inBuf;
+	for (int frame = 0; frame < len / (stereo ? 2 : 1); ++frame) {
+		history[0][histEnd] = *inPtr++;
+		if (stereo)
+			history[1][histEnd] = *inPtr++;
+		histEnd++;
+	}
+	return true;
+}
+
+/*
+ * Apply the filter for the current output position to the given samples.
+ */
+template<bool stereo, bool reverseStereo>
+st_sample_t SincRateConverter<stereo, reverseStereo>::convert(const st_sample_t *samples) const {
+	int32 acc;
+
+	if (numPhases == outStep) {
+		acc = dotProduct(samples, filters + opos * numTaps, numTaps);
+	} else {
+		// Interpolate between the two nearest phases
+		const uint64 pos = (uint64)opos * numPhases;
+		const uint32 phase = (uint32)(pos / outStep);
+		const int64 weight = (int64)(pos % outStep);
+
+		const int32 acc0 = dotProduct(samples, filters + phase * numTaps, numTaps);
+		const int32 acc1 = dotProduct(samples, filters + (phase + 1) * numTaps, numTaps);
+		acc = acc0 + (int32)(((int64)acc1 - acc0) * weight / outStep);
+	}
+
+	acc = (acc + (1 << (kCoefficientBits - 1))) >> kCoefficientBits;
+	return (st_sample_t)CLIP<int32>(acc, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	while (obuf < oend) {
+		// Filter as many frames as fit into both outBuf and the output buffer
+		const st_size_t frames = MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(outBuf) / (stereo ? 2 : 1));
+		st_sample_t *out = outBuf;
+		st_sample_t *const outEnd = outBuf + frames * (stereo ? 2 : 1);
+		bool eos = false;
+
+		while (out < outEnd) {
+			if (histStart + numTaps > histEnd && !refill(input)) {
+				eos = true;
+				break;
+			}
+
+			while (histStart + numTaps <= histEnd && out < outEnd) {
+				*out++ = convert(history[0] + histStart);
+				if (stereo)
+					*out++ = convert(history[1] + histStart);
+
+				// Increment output position
+				opos += inStep;
+				histStart += opos / outStep;
+				opos %= outStep;
+			}
+		}
+
+		const st_size_t filtered = (out - outBuf) / (stereo ? 2 : 1);
+		mixFrames<stereo, reverseStereo>(obuf, outBuf, filtered, vol_l, vol_r);
+		obuf += filtered * 2;
+
+		if (eos)
+			break;
+	}
+	return (obuf - ostart) / 2;
+}
+
+
+#pragma mark -
+
+
+RateConverter *makeSincRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterQuality quality) {
+	if (stereo) {
+		if (reverseStereo)
+			return new SincRateConverter<true, true>(inrate, outrate, quality);
+		else
+			return new SincRateConverter<true, false>(inrate, outrate, quality);
+	} else
+		return new SincRateConverter<false, false>(inrate, outrate, quality);
+}
+
+} // End of namespace Audio
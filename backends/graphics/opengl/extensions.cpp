@@ -28,12 +28,18 @@
 namespace OpenGL {
 
 bool g_extNPOTSupported = false;
+bool g_extUnpackSubimageSupported = false;
 
 void initializeGLExtensions() {
 	const char *extString = (const char *)glGetString(GL_EXTENSIONS);
 
 	// Initialize default state.
 	g_extNPOTSupported = false;
+#ifdef USE_GLES
+	g_extUnpackSubimageSupported = false;
+#else
+	g_extUnpackSubimageSupported = true;
+#endif
 
 	Common::StringTokenizer tokenizer(extString, " ");
 	while (!tokenizer.empty()) {
@@ -41,6 +47,8 @@ void initializeGLExtensions() {
 
 		if (token == "GL_ARB_texture_non_power_of_two") {
 			g_extNPOTSupported = true;
+		} else if (token == "GL_EXT_unpack_subimage") {
+			g_extUnpackSubimageSupported = true;
 		}
 	}
 }
@@ -36,6 +36,12 @@ void initializeGLExtensions();
  */
 extern bool g_extNPOTSupported;
 
+/**
+ * Whether GL_UNPACK_ROW_LENGTH is supported, which allows to upload parts
+ * of a row. This is always true for desktop OpenGL.
+ */
+extern bool g_extUnpackSubimageSupported;
+
 } // End of namespace OpenGL
 
 #endif
@@ -25,6 +25,7 @@
 #include "backends/graphics/opengl/texture.h"
 #include "backends/graphics/opengl/debug.h"
 #include "backends/graphics/opengl/extensions.h"
+#include "backends/graphics/opengl/shader.h"
 
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -824,10 +825,13 @@ void OpenGLGraphicsManager::setActualScreenSize(uint width, uint height) {
 	++_screenChangeID;
 }
 
-void OpenGLGraphicsManager::notifyContextCreate(const Graphics::PixelFormat &defaultFormat, const Graphics::PixelFormat &defaultFormatAlpha) {
+void OpenGLGraphicsManager::notifyContextCreate(const Graphics::PixelFormat &defaultFormat, const Graphics::PixelFormat &defaultFormatAlpha, ProcAddressLookUp getProcAddress) {
 	// Initialize all extensions.
 	initializeGLExtensions();
 
+	// Set up the palette look up for CLUT8 game screens, if possible.
+	CLUT8LookUpShader::create(getProcAddress);
+
 	// Disable 3D properties.
 	GLCALL(glDisable(GL_CULL_FACE));
 	GLCALL(glDisable(GL_DEPTH_TEST));
@@ -890,6 +894,8 @@ void OpenGLGraphicsManager::notifyContextCreate(const Graphics::PixelFormat &def
 }
 
 void OpenGLGraphicsManager::notifyContextDestroy() {
+	CLUT8LookUpShader::destroy();
+
 	if (_gameScreen) {
 		_gameScreen->releaseInternalTexture();
 	}
@@ -953,6 +959,12 @@ void OpenGLGraphicsManager::setMousePosition(int x, int y) {
 Texture *OpenGLGraphicsManager::createTexture(const Graphics::PixelFormat &format, bool wantAlpha) {
 	GLenum glIntFormat, glFormat, glType;
 	if (format.bytesPerPixel == 1) {
+		// The cursor palette is modified for the key color, so it keeps
+		// being converted on the CPU.
+		if (!wantAlpha && CLUT8LookUpShader::isAvailable()) {
+			return new TextureCLUT8GPU();
+		}
+
 		const Graphics::PixelFormat &virtFormat = wantAlpha ? _defaultFormatAlpha : _defaultFormat;
 		const bool supported = getGLPixelFormat(virtFormat, glIntFormat, glFormat, glType);
 		if (!supported) {
@@ -133,8 +133,11 @@ protected:
 	 *                           (this is used for the CLUT8 game screens).
 	 * @param defaultFormatAlpha The new default format with an alpha channel
 	 *                           (this is used for the overlay and cursor).
+	 * @param getProcAddress     Looks up OpenGL functions, which are not
+	 *                           part of OpenGL 1.1. CLUT8 game screens are
+	 *                           converted on the CPU when this is 0.
 	 */
-	void notifyContextCreate(const Graphics::PixelFormat &defaultFormat, const Graphics::PixelFormat &defaultFormatAlpha);
+	void notifyContextCreate(const Graphics::PixelFormat &defaultFormat, const Graphics::PixelFormat &defaultFormatAlpha, ProcAddressLookUp getProcAddress = nullptr);
 
 	/**
 	 * Notify the manager that the OpenGL context is about to be destroyed.
@@ -54,4 +54,14 @@ using namespace Tizen::Graphics::Opengl;
 #include <GL/gl.h>
 #endif
 
+namespace OpenGL {
+
+/**
+ * Function looking up OpenGL entry points by name, like
+ * SDL_GL_GetProcAddress. It returns 0 for unknown functions.
+ */
+typedef void *(*ProcAddressLookUp)(const char *name);
+
+} // End of namespace OpenGL
+
 #endif
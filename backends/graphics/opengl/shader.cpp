@@ -0,0 +1,268 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "backends/graphics/opengl/shader.h"
+#include "backends/graphics/opengl/debug.h"
+
+#include "common/debug.h"
+#include "common/textconsole.h"
+
+namespace OpenGL {
+
+GLuint CLUT8LookUpShader::_program = 0;
+GLint CLUT8LookUpShader::_textureSizeLocation = -1;
+GLint CLUT8LookUpShader::_maxTexelLocation = -1;
+GLint CLUT8LookUpShader::_linearFilteringLocation = -1;
+
+#ifdef USE_GLES
+
+bool CLUT8LookUpShader::create(ProcAddressLookUp getProcAddress) {
+	// OpenGL ES 1 has no shaders.
+	return false;
+}
+
+void CLUT8LookUpShader::destroy() {
+}
+
+void CLUT8LookUpShader::activate(GLuint paletteTexture, uint textureWidth, uint textureHeight, uint width, uint height, bool linearFiltering) {
+}
+
+void CLUT8LookUpShader::deactivate() {
+}
+
+#else
+
+// Older OpenGL headers, like the Windows ones, only cover OpenGL 1.1.
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0 0x84C0
+#define GL_TEXTURE1 0x84C1
+#endif
+
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_COMPILE_STATUS  0x8B81
+#define GL_LINK_STATUS     0x8B82
+#endif
+
+namespace {
+
+typedef void (APIENTRY *ActiveTextureProc)(GLenum texture);
+typedef GLuint (APIENTRY *CreateShaderProc)(GLenum type);
+typedef void (APIENTRY *ShaderSourceProc)(GLuint shader, GLsizei count, const char *const *string, const GLint *length);
+typedef GLuint (APIENTRY *CreateProgramProc)();
+typedef void (APIENTRY *AttachShaderProc)(GLuint program, GLuint shader);
+typedef void (APIENTRY *ObjectProc)(GLuint object);
+typedef void (APIENTRY *GetObjectParameterProc)(GLuint object, GLenum pname, GLint *params);
+typedef void (APIENTRY *GetInfoLogProc)(GLuint object, GLsizei bufSize, GLsizei *length, char *infoLog);
+typedef GLint (APIENTRY *GetUniformLocationProc)(GLuint program, const char *name);
+typedef void (APIENTRY *Uniform1iProc)(GLint location, GLint v0);
+typedef void (APIENTRY *Uniform2fProc)(GLint location, GLfloat v0, GLfloat v1);
+
+/**
+ * The OpenGL 2.0 functions used by CLUT8LookUpShader.
+ */
+struct ShaderFunctions {
+	ActiveTextureProc activeTexture;
+	CreateShaderProc createShader;
+	ShaderSourceProc shaderSource;
+	ObjectProc compileShader;
+	GetObjectParameterProc getShaderiv;
+	GetInfoLogProc getShaderInfoLog;
+	ObjectProc deleteShader;
+	CreateProgramProc createProgram;
+	AttachShaderProc attachShader;
+	ObjectProc linkProgram;
+	GetObjectParameterProc getProgramiv;
+	GetInfoLogProc getProgramInfoLog;
+	ObjectProc deleteProgram;
+	ObjectProc useProgram;
+	GetUniformLocationProc getUniformLocation;
+	Uniform1iProc uniform1i;
+	Uniform2fProc uniform2f;
+};
+
+ShaderFunctions g_shaderFuncs;
+
+template<typename Function>
+bool lookUpFunction(ProcAddressLookUp getProcAddress, const char *name, Function &function) {
+	function = (Function)getProcAddress(name);
+	return function != 0;
+}
+
+bool lookUpShaderFunctions(ProcAddressLookUp getProcAddress) {
+	return lookUpFunction(getProcAddress, "glActiveTexture", g_shaderFuncs.activeTexture)
+	    && lookUpFunction(getProcAddress, "glCreateShader", g_shaderFuncs.createShader)
+	    && lookUpFunction(getProcAddress, "glShaderSource", g_shaderFuncs.shaderSource)
+	    && lookUpFunction(getProcAddress, "glCompileShader", g_shaderFuncs.compileShader)
+	    && lookUpFunction(getProcAddress, "glGetShaderiv", g_shaderFuncs.getShaderiv)
+	    && lookUpFunction(getProcAddress, "glGetShaderInfoLog", g_shaderFuncs.getShaderInfoLog)
+	    && lookUpFunction(getProcAddress, "glDeleteShader", g_shaderFuncs.deleteShader)
+	    && lookUpFunction(getProcAddress, "glCreateProgram", g_shaderFuncs.createProgram)
+	    && lookUpFunction(getProcAddress, "glAttachShader", g_shaderFuncs.attachShader)
+	    && lookUpFunction(getProcAddress, "glLinkProgram", g_shaderFuncs.linkProgram)
+	    && lookUpFunction(getProcAddress, "glGetProgramiv", g_shaderFuncs.getProgramiv)
+	    && lookUpFunction(getProcAddress, "glGetProgramInfoLog", g_shaderFuncs.getProgramInfoLog)
+	    && lookUpFunction(getProcAddress, "glDeleteProgram", g_shaderFuncs.deleteProgram)
+	    && lookUpFunction(getProcAddress, "glUseProgram", g_shaderFuncs.useProgram)
+	    && lookUpFunction(getProcAddress, "glGetUniformLocation", g_shaderFuncs.getUniformLocation)
+	    && lookUpFunction(getProcAddress, "glUniform1i", g_shaderFuncs.uniform1i)
+	    && lookUpFunction(getProcAddress, "glUniform2f", g_shaderFuncs.uniform2f);
+}
+
+// The palette index of a texel is in its alpha channel. Bilinear filtering
+// is done on the looked up colors, since interpolating indices makes no
+// sense. Texels outside the used part of the texture are clamped to it, to
+// avoid filtering with garbage.
+const char *const g_lookUpShaderSource =
+	"uniform sampler2D indices;\n"
+	"uniform sampler2D palette;\n"
+	"uniform vec2 textureSize;\n"
+	"uniform vec2 maxTexel;\n"
+	"uniform bool linearFiltering;\n"
+	"\n"
+	"vec4 lookUp(vec2 texel) {\n"
+	"	vec2 position = (clamp(texel, vec2(0.0), maxTexel) + 0.5) / textureSize;\n"
+	"	float index = texture2D(indices, position).a;\n"
+	"	return texture2D(palette, vec2(index * (255.0 / 256.0) + (0.5 / 256.0), 0.5));\n"
+	"}\n"
+	"\n"
+	"void main() {\n"
+	"	vec2 position = gl_TexCoord[0].xy * textureSize;\n"
+	"	vec4 color;\n"
+	"	if (linearFiltering) {\n"
+	"		position -= 0.5;\n"
+	"		vec2 texel = floor(position);\n"
+	"		vec2 weight = position - texel;\n"
+	"		color = mix(mix(lookUp(texel), lookUp(texel + vec2(1.0, 0.0)), weight.x),\n"
+	"		            mix(lookUp(texel + vec2(0.0, 1.0)), lookUp(texel + vec2(1.0, 1.0)), weight.x),\n"
+	"		            weight.y);\n"
+	"	} else {\n"
+	"		color = lookUp(floor(position));\n"
+	"	}\n"
+	"	gl_FragColor = color * gl_Color;\n"
+	"}\n";
+
+bool checkStatus(GLuint object, GLenum pname, GetObjectParameterProc getParameter, GetInfoLogProc getInfoLog, const char *what) {
+	GLint status = GL_FALSE;
+	GLCALL(getParameter(object, pname, &status));
+	if (status == GL_TRUE) {
+		return true;
+	}
+
+	char log[512];
+	GLsizei length = 0;
+	GLCALL(getInfoLog(object, sizeof(log) - 1, &length, log));
+	log[length] = '\0';
+	warning("CLUT8LookUpShader: Could not %s the palette look up shader: %s", what, log);
+	return false;
+}
+
+} // End of anonymous namespace
+
+bool CLUT8LookUpShader::create(ProcAddressLookUp getProcAddress) {
+	// A possible program belongs to an old context, which is gone.
+	_program = 0;
+
+	if (!getProcAddress) {
+		return false;
+	}
+
+	// Some ways to look up functions succeed even when the context does
+	// not support them. Thus, check the version first.
+	const char *version = (const char *)glGetString(GL_VERSION);
+	int majorVersion = 0;
+	for (const char *c = version; c && *c >= '0' && *c <= '9'; ++c) {
+		majorVersion = majorVersion * 10 + (*c - '0');
+	}
+
+	if (majorVersion < 2 || !lookUpShaderFunctions(getProcAddress)) {
+		return false;
+	}
+
+	const GLuint shader = g_shaderFuncs.createShader(GL_FRAGMENT_SHADER);
+	GLCALL(g_shaderFuncs.shaderSource(shader, 1, &g_lookUpShaderSource, 0));
+	GLCALL(g_shaderFuncs.compileShader(shader));
+	if (!checkStatus(shader, GL_COMPILE_STATUS, g_shaderFuncs.getShaderiv, g_shaderFuncs.getShaderInfoLog, "compile")) {
+		GLCALL(g_shaderFuncs.deleteShader(shader));
+		return false;
+	}
+
+	const GLuint program = g_shaderFuncs.createProgram();
+	GLCALL(g_shaderFuncs.attachShader(program, shader));
+	GLCALL(g_shaderFuncs.linkProgram(program));
+	// The program keeps the shader alive as long as it needs it.
+	GLCALL(g_shaderFuncs.deleteShader(shader));
+	if (!checkStatus(program, GL_LINK_STATUS, g_shaderFuncs.getProgramiv, g_shaderFuncs.getProgramInfoLog, "link")) {
+		GLCALL(g_shaderFuncs.deleteProgram(program));
+		return false;
+	}
+
+	_program = program;
+	_textureSizeLocation = g_shaderFuncs.getUniformLocation(_program, "textureSize");
+	_maxTexelLocation = g_shaderFuncs.getUniformLocation(_program, "maxTexel");
+	_linearFilteringLocation = g_shaderFuncs.getUniformLocation(_program, "linearFiltering");
+
+	// The texture units never change.
+	GLCALL(g_shaderFuncs.useProgram(_program));
+	GLCALL(g_shaderFuncs.uniform1i(g_shaderFuncs.getUniformLocation(_program, "indices"), 0));
+	GLCALL(g_shaderFuncs.uniform1i(g_shaderFuncs.getUniformLocation(_program, "palette"), 1));
+	GLCALL(g_shaderFuncs.useProgram(0));
+
+	debug(5, "OpenGL: Using a shader for CLUT8 palette look ups");
+	return true;
+}
+
+void CLUT8LookUpShader::destroy() {
+	if (_program) {
+		GLCALL(g_shaderFuncs.deleteProgram(_program));
+		_program = 0;
+	}
+}
+
+void CLUT8LookUpShader::activate(GLuint paletteTexture, uint textureWidth, uint textureHeight, uint width, uint height, bool linearFiltering) {
+	if (!_program) {
+		return;
+	}
+
+	GLCALL(g_shaderFuncs.useProgram(_program));
+	GLCALL(g_shaderFuncs.uniform2f(_textureSizeLocation, textureWidth, textureHeight));
+	GLCALL(g_shaderFuncs.uniform2f(_maxTexelLocation, width - 1.0f, height - 1.0f));
+	GLCALL(g_shaderFuncs.uniform1i(_linearFilteringLocation, linearFiltering));
+
+	GLCALL(g_shaderFuncs.activeTexture(GL_TEXTURE1));
+	GLCALL(glBindTexture(GL_TEXTURE_2D, paletteTexture));
+	GLCALL(g_shaderFuncs.activeTexture(GL_TEXTURE0));
+}
+
+void CLUT8LookUpShader::deactivate() {
+	if (_program) {
+		GLCALL(g_shaderFuncs.useProgram(0));
+	}
+}
+
+#endif
+
+} // End of namespace OpenGL
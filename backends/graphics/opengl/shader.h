@@ -0,0 +1,83 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_OPENGL_SHADER_H
+#define BACKENDS_GRAPHICS_OPENGL_SHADER_H
+
+#include "backends/graphics/opengl/opengl-sys.h"
+
+namespace OpenGL {
+
+/**
+ * A fragment program which looks up the colors of a CLUT8 texture in a
+ * palette texture while drawing. The CLUT8 texture holds the palette
+ * indices in its alpha channel, the palette texture is 256x1 pixels big.
+ *
+ * This needs OpenGL 2.0, which is looked up at run time. It is never
+ * available with OpenGL ES.
+ */
+class CLUT8LookUpShader {
+public:
+	/**
+	 * Set up the program for the current context.
+	 *
+	 * @param getProcAddress Used to look up the OpenGL 2.0 functions. The
+	 *                       program is unavailable when this is 0.
+	 * @return Whether the program is available.
+	 */
+	static bool create(ProcAddressLookUp getProcAddress);
+
+	/**
+	 * Free the program of the current context.
+	 */
+	static void destroy();
+
+	static bool isAvailable() { return _program != 0; }
+
+	/**
+	 * Draw with the program until deactivate() is called. The CLUT8
+	 * texture needs to be bound to texture unit 0 for drawing.
+	 *
+	 * @param paletteTexture  The palette texture name.
+	 * @param textureWidth    The width of the CLUT8 texture.
+	 * @param textureHeight   The height of the CLUT8 texture.
+	 * @param width           The width of the used part of the texture.
+	 * @param height          The height of the used part of the texture.
+	 * @param linearFiltering Whether to filter the looked up colors.
+	 */
+	static void activate(GLuint paletteTexture, uint textureWidth, uint textureHeight, uint width, uint height, bool linearFiltering);
+
+	/**
+	 * Go back to the fixed function pipeline.
+	 */
+	static void deactivate();
+
+private:
+	static GLuint _program;
+	static GLint _textureSizeLocation;
+	static GLint _maxTexelLocation;
+	static GLint _linearFilteringLocation;
+};
+
+} // End of namespace OpenGL
+
+#endif
@@ -23,10 +23,16 @@
 #include "backends/graphics/opengl/texture.h"
 #include "backends/graphics/opengl/extensions.h"
 #include "backends/graphics/opengl/debug.h"
+#include "backends/graphics/opengl/shader.h"
 
 #include "common/rect.h"
 #include "common/textconsole.h"
 
+// OpenGL ES only has this with the GL_EXT_unpack_subimage extension.
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
+
 namespace OpenGL {
 
 static GLuint nextHigher2(GLuint v) {
@@ -133,14 +139,8 @@ void Texture::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcP
 	assert(x + w <= dstSurf->w);
 	assert(y + h <= dstSurf->h);
 
-	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
-	// parameters is an empty rect. Thus, we check whether the current dirty
-	// area is valid. In case it is not we simply use the parameters as new
-	// dirty area. Otherwise, we simply call extend.
-	if (_dirtyArea.isEmpty()) {
-		_dirtyArea = Common::Rect(x, y, x + w, y + h);
-	} else {
-		_dirtyArea.extend(Common::Rect(x, y, x + w, y + h));
+	if (w > 0 && h > 0) {
+		addDirtyArea(Common::Rect(x, y, x + w, y + h));
 	}
 
 	const byte *src = (const byte *)srcPtr;
@@ -207,8 +207,42 @@ void Texture::updateTexture() {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	// Set the texture.
+	GLCALL(glBindTexture(GL_TEXTURE_2D, _glTexture));
+
+	// Update the actual texture.
+	// With GL_UNPACK_ROW_LENGTH we can tell glTexSubImage2D the pitch of our
+	// texture buffer, and thus only upload the dirty areas. OpenGL ES 1.0
+	// does not support it without the GL_EXT_unpack_subimage extension
+	// though. In that case we upload the whole texture lines of the bounding
+	// box of all dirty areas. This is what we always did before and avoids
+	// uploading lines more than once. Uploading each line separately is much
+	// slower, and copying the dirty areas to a temporary buffer is more
+	// complicated.
+	const Common::Array<Common::Rect> dirtyAreas = getDirtyAreas();
+
+	if (g_extUnpackSubimageSupported) {
+		GLCALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, _textureData.pitch / _textureData.format.bytesPerPixel));
+
+		for (uint i = 0; i < dirtyAreas.size(); ++i) {
+			updateArea(dirtyAreas[i]);
+		}
+
+		GLCALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+	} else {
+		Common::Rect boundingBox = dirtyAreas[0];
+		for (uint i = 1; i < dirtyAreas.size(); ++i) {
+			boundingBox.extend(dirtyAreas[i]);
+		}
+
+		updateArea(boundingBox);
+	}
+
+	// We should have handled everything, thus not dirty anymore.
+	clearDirty();
+}
 
+void Texture::updateArea(Common::Rect dirtyArea) {
 	// In case we use linear filtering we might need to duplicate the last
 	// pixel row/column to avoid glitches with filtering.
 	if (_glFilter == GL_LINEAR) {
@@ -238,39 +272,54 @@ void Texture::updateTexture() {
 		}
 	}
 
-	// Set the texture.
-	GLCALL(glBindTexture(GL_TEXTURE_2D, _glTexture));
+	if (g_extUnpackSubimageSupported) {
+		GLCALL(glTexSubImage2D(GL_TEXTURE_2D, 0, dirtyArea.left, dirtyArea.top, dirtyArea.width(), dirtyArea.height(),
+		                       _glFormat, _glType, _textureData.getBasePtr(dirtyArea.left, dirtyArea.top)));
+	} else {
+		GLCALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, dirtyArea.top, _textureData.w, dirtyArea.height(),
+		                       _glFormat, _glType, _textureData.getBasePtr(0, dirtyArea.top)));
+	}
+}
 
-	// Update the actual texture.
-	// Although we keep track of the dirty part of the texture buffer we
-	// cannot take advantage of the left/right boundries here because it is
-	// not possible to specify a pitch to glTexSubImage2D. To be precise, with
-	// plain OpenGL we could set GL_UNPACK_ROW_LENGTH to achieve this. However,
-	// OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH. Thus, we are left
-	// with the following options:
-	//
-	// 1) (As we do right now) Simply always update the whole texture lines of
-	//    rect changed. This is simplest to implement. In case performance is
-	//    really an issue we can think of switching to another method.
-	//
-	// 2) Copy the dirty rect to a temporary buffer and upload that by using
-	//    glTexSubImage2D. This is what the Android backend does. It is more
-	//    complicated though.
-	//
-	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
-	//    graphics manager did but it is much slower! Thus, we do not use it.
-	GLCALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, dirtyArea.top, _textureData.w, dirtyArea.height(),
-	                       _glFormat, _glType, _textureData.getBasePtr(0, dirtyArea.top)));
+void Texture::addDirtyArea(const Common::Rect &area) {
+	if (_allDirty) {
+		return;
+	}
 
-	// We should have handled everything, thus not dirty anymore.
-	clearDirty();
+	// Merge the new area with all the areas it overlaps or touches. Since
+	// the merged area grows, this needs to start over after every merge.
+	Common::Rect merged = area;
+	for (uint i = 0; i < _dirtyAreas.size();) {
+		const Common::Rect &other = _dirtyAreas[i];
+		if (merged.left <= other.right && other.left <= merged.right
+		    && merged.top <= other.bottom && other.top <= merged.bottom) {
+			merged.extend(other);
+			_dirtyAreas.remove_at(i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	if (_dirtyAreas.size() < kMaxDirtyAreas) {
+		_dirtyAreas.push_back(merged);
+	} else {
+		for (uint i = 0; i < _dirtyAreas.size(); ++i) {
+			merged.extend(_dirtyAreas[i]);
+		}
+
+		_dirtyAreas.clear();
+		_dirtyAreas.push_back(merged);
+	}
 }
 
-Common::Rect Texture::getDirtyArea() const {
+Common::Array<Common::Rect> Texture::getDirtyAreas() const {
 	if (_allDirty) {
-		return Common::Rect(_userPixelData.w, _userPixelData.h);
+		Common::Array<Common::Rect> all;
+		all.push_back(Common::Rect(_userPixelData.w, _userPixelData.h));
+		return all;
 	} else {
-		return _dirtyArea;
+		return _dirtyAreas;
 	}
 }
 
@@ -351,24 +400,102 @@ void TextureCLUT8::updateTexture() {
 	// Do the palette look up
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	Common::Rect dirtyArea = getDirtyArea();
-
-	if (outSurf->format.bytesPerPixel == 2) {
-		doPaletteLookUp<uint16>((uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        dirtyArea.width(), dirtyArea.height(),
-		                        outSurf->pitch, _clut8Data.pitch, (const uint16 *)_palette);
-	} else if (outSurf->format.bytesPerPixel == 4) {
-		doPaletteLookUp<uint32>((uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        dirtyArea.width(), dirtyArea.height(),
-		                        outSurf->pitch, _clut8Data.pitch, (const uint32 *)_palette);
-	} else {
-		warning("TextureCLUT8::updateTexture: Unsupported pixel depth: %d", outSurf->format.bytesPerPixel);
+	const Common::Array<Common::Rect> dirtyAreas = getDirtyAreas();
+
+	for (uint i = 0; i < dirtyAreas.size(); ++i) {
+		const Common::Rect &dirtyArea = dirtyAreas[i];
+
+		if (outSurf->format.bytesPerPixel == 2) {
+			doPaletteLookUp<uint16>((uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        dirtyArea.width(), dirtyArea.height(),
+			                        outSurf->pitch, _clut8Data.pitch, (const uint16 *)_palette);
+		} else if (outSurf->format.bytesPerPixel == 4) {
+			doPaletteLookUp<uint32>((uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        dirtyArea.width(), dirtyArea.height(),
+			                        outSurf->pitch, _clut8Data.pitch, (const uint32 *)_palette);
+		} else {
+			warning("TextureCLUT8::updateTexture: Unsupported pixel depth: %d", outSurf->format.bytesPerPixel);
+		}
 	}
 
 	// Do generic handling of updating the texture.
 	Texture::updateTexture();
 }
 
+TextureCLUT8GPU::TextureCLUT8GPU()
+    : Texture(GL_ALPHA, GL_ALPHA, GL_UNSIGNED_BYTE, Graphics::PixelFormat::createFormatCLUT8()),
+      _glPaletteTexture(0), _paletteDirty(false), _linearFiltering(false) {
+	memset(_palette, 0, sizeof(_palette));
+	createPaletteTexture();
+}
+
+TextureCLUT8GPU::~TextureCLUT8GPU() {
+	GLCALL(glDeleteTextures(1, &_glPaletteTexture));
+}
+
+void TextureCLUT8GPU::releaseInternalTexture() {
+	Texture::releaseInternalTexture();
+
+	GLCALL(glDeleteTextures(1, &_glPaletteTexture));
+	_glPaletteTexture = 0;
+}
+
+void TextureCLUT8GPU::recreateInternalTexture() {
+	Texture::recreateInternalTexture();
+	createPaletteTexture();
+}
+
+void TextureCLUT8GPU::enableLinearFiltering(bool enable) {
+	// Interpolating palette indices makes no sense. The shader does the
+	// filtering on the looked up colors instead.
+	Texture::enableLinearFiltering(false);
+	_linearFiltering = enable;
+}
+
+void TextureCLUT8GPU::createPaletteTexture() {
+	// Release old texture name in case it exists.
+	GLCALL(glDeleteTextures(1, &_glPaletteTexture));
+
+	GLCALL(glGenTextures(1, &_glPaletteTexture));
+	GLCALL(glBindTexture(GL_TEXTURE_2D, _glPaletteTexture));
+	GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+	GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+	GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	GLCALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, _palette));
+
+	_paletteDirty = false;
+}
+
+void TextureCLUT8GPU::setPalette(uint start, uint colors, const byte *palData) {
+	byte *dst = _palette + start * 4;
+	while (colors-- > 0) {
+		dst[0] = palData[0];
+		dst[1] = palData[1];
+		dst[2] = palData[2];
+		dst[3] = 0xFF;
+
+		dst += 4;
+		palData += 3;
+	}
+
+	// Unlike TextureCLUT8 only the palette itself needs to be uploaded.
+	_paletteDirty = true;
+}
+
+void TextureCLUT8GPU::draw(GLfloat x, GLfloat y, GLfloat w, GLfloat h) {
+	if (_paletteDirty) {
+		GLCALL(glBindTexture(GL_TEXTURE_2D, _glPaletteTexture));
+		GLCALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 1, GL_RGBA, GL_UNSIGNED_BYTE, _palette));
+		_paletteDirty = false;
+	}
+
+	const Graphics::Surface &textureData = getTextureData();
+	CLUT8LookUpShader::activate(_glPaletteTexture, textureData.w, textureData.h, getWidth(), getHeight(), _linearFiltering);
+	Texture::draw(x, y, w, h);
+	CLUT8LookUpShader::deactivate();
+}
+
 } // End of namespace OpenGL
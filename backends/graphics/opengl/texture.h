@@ -28,6 +28,7 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 namespace OpenGL {
@@ -52,19 +53,19 @@ public:
 	/**
 	 * Destroy the OpenGL texture name.
 	 */
-	void releaseInternalTexture();
+	virtual void releaseInternalTexture();
 
 	/**
 	 * Create the OpenGL texture name and flag the whole texture as dirty.
 	 */
-	void recreateInternalTexture();
+	virtual void recreateInternalTexture();
 
 	/**
 	 * Enable or disable linear texture filtering.
 	 *
 	 * @param enable true to enable and false to disable.
 	 */
-	void enableLinearFiltering(bool enable);
+	virtual void enableLinearFiltering(bool enable);
 
 	/**
 	 * Allocate texture space for the desired dimensions. This wraps any
@@ -79,10 +80,10 @@ public:
 
 	void fill(uint32 color);
 
-	void draw(GLfloat x, GLfloat y, GLfloat w, GLfloat h);
+	virtual void draw(GLfloat x, GLfloat y, GLfloat w, GLfloat h);
 
 	void flagDirty() { _allDirty = true; }
-	bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	bool isDirty() const { return _allDirty || !_dirtyAreas.empty(); }
 
 	uint getWidth() const { return _userPixelData.w; }
 	uint getHeight() const { return _userPixelData.h; }
@@ -123,8 +124,30 @@ public:
 protected:
 	virtual void updateTexture();
 
-	Common::Rect getDirtyArea() const;
+	/**
+	 * @return The areas of the texture which changed since the last update.
+	 *         They do not overlap.
+	 */
+	Common::Array<Common::Rect> getDirtyAreas() const;
+
+	/**
+	 * Upload one changed area of the texture data to the OpenGL texture.
+	 * The texture needs to be bound already.
+	 */
+	void updateArea(Common::Rect dirtyArea);
+
+	const Graphics::Surface &getTextureData() const { return _textureData; }
 private:
+	enum {
+		/**
+		 * The maximum number of separate dirty areas. When there are more,
+		 * they are merged into their bounding box.
+		 */
+		kMaxDirtyAreas = 8
+	};
+
+	void addDirtyArea(const Common::Rect &area);
+
 	const GLenum _glIntFormat;
 	const GLenum _glFormat;
 	const GLenum _glType;
@@ -137,8 +160,8 @@ private:
 	Graphics::Surface _userPixelData;
 
 	bool _allDirty;
-	Common::Rect _dirtyArea;
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	Common::Array<Common::Rect> _dirtyAreas;
+	void clearDirty() { _allDirty = false; _dirtyAreas.clear(); }
 
 	static GLint _maxTextureSize;
 };
@@ -170,6 +193,39 @@ private:
 	byte *_palette;
 };
 
+/**
+ * A CLUT8 texture whose colors are looked up while drawing, see
+ * CLUT8LookUpShader. Only the palette indices are uploaded, and palette
+ * changes only need the palette to be uploaded again.
+ */
+class TextureCLUT8GPU : public Texture {
+public:
+	TextureCLUT8GPU();
+	virtual ~TextureCLUT8GPU();
+
+	virtual void releaseInternalTexture();
+	virtual void recreateInternalTexture();
+	virtual void enableLinearFiltering(bool enable);
+
+	virtual void draw(GLfloat x, GLfloat y, GLfloat w, GLfloat h);
+
+	virtual bool hasPalette() const { return true; }
+
+	virtual void setPalette(uint start, uint colors, const byte *palData);
+
+	virtual void *getPalette() { return _palette; }
+	virtual const void *getPalette() const { return _palette; }
+
+private:
+	void createPaletteTexture();
+
+	GLuint _glPaletteTexture;
+	bool _paletteDirty;
+	bool _linearFiltering;
+	/** The palette in RGBA8888 with the bytes in that order. */
+	byte _palette[256 * 4];
+};
+
 } // End of namespace OpenGL
 
 #endif
@@ -391,7 +391,7 @@ bool OpenGLSdlGraphicsManager::setupMode(uint width, uint height) {
 		return false;
 	}
 
-	notifyContextCreate(rgba8888, rgba8888);
+	notifyContextCreate(rgba8888, rgba8888, SDL_GL_GetProcAddress);
 	int actualWidth, actualHeight;
 	getWindowDimensions(&actualWidth, &actualHeight);
 	setActualScreenSize(actualWidth, actualHeight);
@@ -438,7 +438,7 @@ bool OpenGLSdlGraphicsManager::setupMode(uint width, uint height) {
 	_lastVideoModeLoad = SDL_GetTicks();
 
 	if (_hwScreen) {
-		notifyContextCreate(rgba8888, rgba8888);
+		notifyContextCreate(rgba8888, rgba8888, SDL_GL_GetProcAddress);
 		setActualScreenSize(_hwScreen->w, _hwScreen->h);
 	}
 
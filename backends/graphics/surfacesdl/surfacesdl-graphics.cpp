@@ -88,6 +88,31 @@ static const int s_gfxModeSwitchTable[][4] = {
 static int cursorStretch200To240(uint8 *buf, uint32 pitch, int width, int height, int srcX, int srcY, int origSrcY);
 #endif
 
+static inline bool rectsOverlap(const SDL_Rect &a, const SDL_Rect &b) {
+	return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+/**
+ * Whether the two rects, which must not overlap, exactly fill their
+ * bounding box, i.e. they share a whole edge.
+ */
+static inline bool rectsTile(const SDL_Rect &a, const SDL_Rect &b) {
+	if (a.x == b.x && a.w == b.w)
+		return a.y + a.h == b.y || b.y + b.h == a.y;
+	if (a.y == b.y && a.h == b.h)
+		return a.x + a.w == b.x || b.x + b.w == a.x;
+	return false;
+}
+
+static inline void extendRect(SDL_Rect &rect, const SDL_Rect &other) {
+	const int x2 = MAX<int>(rect.x + rect.w, other.x + other.w);
+	const int y2 = MAX<int>(rect.y + rect.h, other.y + other.h);
+	rect.x = MIN(rect.x, other.x);
+	rect.y = MIN(rect.y, other.y);
+	rect.w = x2 - rect.x;
+	rect.h = y2 - rect.y;
+}
+
 AspectRatio::AspectRatio(int w, int h) {
 	// TODO : Validation and so on...
 	// Currently, we just ensure the program don't instantiate non-supported aspect ratios
@@ -156,6 +181,9 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 
 	memset(&_mouseCurState, 0, sizeof(_mouseCurState));
 
+	_numDirtyRects = 0;
+	memset(&_frameStats, 0, sizeof(_frameStats));
+
 	_graphicsMutex = g_system->createMutex();
 
 #ifdef USE_SDL_DEBUG_FOCUSRECT
@@ -1098,6 +1126,10 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		_dirtyRectList[0].h = height;
 	}
 
+	_frameStats.numRects = _numDirtyRects;
+	_frameStats.pixelsScaled = 0;
+	_frameStats.pixelsUploaded = 0;
+
 	// Only draw anything if necessary
 	if (_numDirtyRects > 0 || _mouseNeedsRedraw) {
 		SDL_Rect *r;
@@ -1144,6 +1176,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				assert(scalerProc != NULL);
 				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
 					(byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h);
+				_frameStats.pixelsScaled += r->w * dst_h;
 			}
 
 			r->x = rx1;
@@ -1249,7 +1282,13 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		// Finally, blit all our changes to the screen
 		if (!_displayDisabled) {
 			SDL_UpdateRects(_hwscreen, _numDirtyRects, _dirtyRectList);
+
+			for (r = _dirtyRectList; r != _dirtyRectList + _numDirtyRects; ++r)
+				_frameStats.pixelsUploaded += r->w * r->h;
 		}
+
+		debug(9, "SurfaceSdlGraphicsManager::internUpdateScreen: Scaled %u pixels in %d rects, uploaded %u pixels",
+			_frameStats.pixelsScaled, _frameStats.numRects, _frameStats.pixelsUploaded);
 	}
 
 	_numDirtyRects = 0;
@@ -1393,11 +1432,6 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	if (_forceFull)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
-		_forceFull = true;
-		return;
-	}
-
 	int height, width;
 
 	if (!_overlayVisible && !realCoordinates) {
@@ -1408,14 +1442,10 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 		height = _videoMode.overlayHeight;
 	}
 
-	// Extend the dirty region by 1 pixel for scalers
-	// that "smear" the screen, e.g. 2xSAI
-	if (!realCoordinates) {
-		x--;
-		y--;
-		w+=2;
-		h+=2;
-	}
+	// Extend the dirty region for scalers that "smear" the screen, e.g. 2xSAI,
+	// and for the aspect ratio correction
+	if (!_overlayVisible && !realCoordinates)
+		extendScalerRect(_scalerProc, _videoMode.aspectRatioCorrection, x, y, w, h);
 
 	// clip
 	if (x < 0) {
@@ -1442,19 +1472,56 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	}
 #endif
 
-	if (w == width && h == height) {
-		_forceFull = true;
+	if (w <= 0 || h <= 0)
 		return;
+
+	SDL_Rect rect;
+	rect.x = x;
+	rect.y = y;
+	rect.w = w;
+	rect.h = h;
+
+	// When the list is full, merge the new rect with the one whose bounding
+	// box grows the least, instead of giving up and redrawing everything.
+	if (_numDirtyRects == NUM_DIRTY_RECT) {
+		int best = 0;
+		int bestGrowth = 0;
+		for (int i = 0; i < _numDirtyRects; ++i) {
+			SDL_Rect merged = _dirtyRectList[i];
+			extendRect(merged, rect);
+			const int growth = merged.w * merged.h - _dirtyRectList[i].w * _dirtyRectList[i].h;
+			if (i == 0 || growth < bestGrowth) {
+				best = i;
+				bestGrowth = growth;
+			}
+		}
+
+		extendRect(rect, _dirtyRectList[best]);
+		_dirtyRectList[best] = _dirtyRectList[--_numDirtyRects];
 	}
 
-	if (w > 0 && h > 0) {
-		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+	// Merge the rect with all the rects it overlaps or tiles with. The
+	// merged rect may overlap further rects, so start over after every
+	// merge.
+	for (int i = 0; i < _numDirtyRects;) {
+		const SDL_Rect &other = _dirtyRectList[i];
+		if (rectsOverlap(rect, other) || rectsTile(rect, other)) {
+			extendRect(rect, other);
+			_dirtyRectList[i] = _dirtyRectList[--_numDirtyRects];
+			i = 0;
+		} else {
+			++i;
+		}
+	}
 
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
+	// Rects in real coordinates are added while drawing, after the full
+	// redraw has been set up. Thus, they always need to end up in the list.
+	if (rect.w == width && rect.h == height && !realCoordinates) {
+		_forceFull = true;
+		return;
 	}
+
+	_dirtyRectList[_numDirtyRects++] = rect;
 }
 
 int16 SurfaceSdlGraphicsManager::getHeight() {
@@ -259,10 +259,19 @@ protected:
 		MAX_SCALING = 3
 	};
 
-	// Dirty rect management
+	// Dirty rect management. The rects in the list never overlap, so that
+	// no pixel gets scaled twice.
 	SDL_Rect _dirtyRectList[NUM_DIRTY_RECT];
 	int _numDirtyRects;
 
+	/** What the last screen update did, for performance analysis. */
+	struct FrameStats {
+		int numRects;
+		uint32 pixelsScaled;
+		uint32 pixelsUploaded;
+	};
+	FrameStats _frameStats;
+
 	struct MousePos {
 		// The mouse position, using either virtual (game) or real
 		// (overlay) coordinates.
@@ -117,7 +117,14 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 	// Open the file for saving
 	Common::WriteStream *sf = file.createWriteStream();
 
-	return compress ? Common::wrapCompressedWriteStream(sf) : sf;
+	return compress ? Common::wrapCompressedWriteStream(sf, getCompressionLevel()) : sf;
+}
+
+int DefaultSaveFileManager::getCompressionLevel() const {
+	if (!ConfMan.hasKey("save_compression_level"))
+		return -1;
+
+	return CLIP(ConfMan.getInt("save_compression_level"), 0, 9);
 }
 
 bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
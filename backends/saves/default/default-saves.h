@@ -54,6 +54,12 @@ protected:
 	 * Sets the internal error and error message accordingly.
 	 */
 	virtual void checkPath(const Common::FSNode &dir);
+
+	/**
+	 * Get the zlib compression level for savefiles from the
+	 * "save_compression_level" config setting, or -1 for zlib's default.
+	 */
+	int getCompressionLevel() const;
 };
 
 #endif
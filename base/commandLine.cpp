@@ -27,6 +27,7 @@
 
 #include <limits.h>
 
+#include "engines/detectioncache.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
 #include "base/plugins.h"
@@ -43,6 +44,9 @@
 #include "audio/musicplugin.h"
 
 #define DETECTOR_TESTING_HACK
+#ifdef ENABLE_BENCHMARKS
+#define DETECTOR_BENCHMARK_HACK
+#endif
 #define UPGRADE_ALL_TARGETS_HACK
 
 namespace Base {
@@ -189,6 +193,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("sfx_mute", false);
 	ConfMan.registerDefault("speech_mute", false);
 	ConfMan.registerDefault("mute", false);
+	ConfMan.registerDefault("resampler_quality", "low");
 
 	ConfMan.registerDefault("multi_midi", false);
 	ConfMan.registerDefault("native_mt32", false);
@@ -248,6 +253,8 @@ void registerDefaults() {
 
 	ConfMan.registerDefault("gui_browser_show_hidden", false);
 
+	ConfMan.registerDefault("detection_cache", true);
+
 #ifdef USE_FLUIDSYNTH
 	// The settings are deliberately stored the same way as in Qsynth. The
 	// FluidSynth music driver is responsible for transforming them into
@@ -393,6 +400,13 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			END_COMMAND
 #endif
 
+#ifdef DETECTOR_BENCHMARK_HACK
+			// Only built with --enable-benchmarks, see the configure help
+			DO_LONG_OPTION("benchmark-detector")
+				return "benchmark-detector";
+			END_OPTION
+#endif
+
 #ifdef UPGRADE_ALL_TARGETS_HACK
 			// HACK FIXME TODO: This command is intentionally *not* documented!
 			DO_LONG_COMMAND("upgrade-targets")
@@ -816,6 +830,58 @@ static void runDetectorTest() {
 }
 #endif
 
+#ifdef DETECTOR_BENCHMARK_HACK
+static void collectDirectories(const Common::FSNode &dir, Common::FSList &dirs) {
+	dirs.push_back(dir);
+
+	Common::FSList children;
+	if (!dir.getChildren(children, Common::FSNode::kListDirectoriesOnly))
+		return;
+
+	for (Common::FSList::const_iterator child = children.begin(); child != children.end(); ++child)
+		collectDirectories(*child, dirs);
+}
+
+static void runDetectorBenchmark(const Common::String &path) {
+	// HACK: Times EngineManager::detectGames() over every directory below the
+	// given path, similar to what the launcher's mass add does. The first
+	// pass starts with an empty detection cache, the second one reuses the
+	// MD5 sums cached by the first. devtools/make-detection-tree.py creates
+	// a synthetic game library for this.
+
+	Common::FSNode root(path);
+	if (!root.isDirectory()) {
+		printf("'%s' is not a directory\n", path.c_str());
+		return;
+	}
+
+	Common::FSList dirs;
+	collectDirectories(root, dirs);
+	printf("Benchmarking detection over %d directories in '%s'\n", dirs.size(), path.c_str());
+
+	for (int pass = 0; pass < 2; ++pass) {
+		if (pass == 0)
+			DetectionCacheMan.clear();
+
+		const uint hitsBefore = DetectionCacheMan.getHits();
+		const uint missesBefore = DetectionCacheMan.getMisses();
+		uint games = 0;
+
+		const uint32 start = g_system->getMillis();
+		for (Common::FSList::const_iterator dir = dirs.begin(); dir != dirs.end(); ++dir) {
+			Common::FSList files;
+			if (!dir->getChildren(files, Common::FSNode::kListAll))
+				continue;
+			games += EngineMan.detectGames(files).size();
+		}
+		const uint32 elapsed = g_system->getMillis() - start;
+
+		printf("%s: %u ms, %u games, cache hits %u, misses %u\n", pass == 0 ? "Cold" : "Warm",
+		       elapsed, games, DetectionCacheMan.getHits() - hitsBefore, DetectionCacheMan.getMisses() - missesBefore);
+	}
+}
+#endif
+
 #ifdef UPGRADE_ALL_TARGETS_HACK
 void upgradeTargets() {
 	// HACK: The following upgrades all your targets to the latest and
@@ -978,6 +1044,12 @@ bool processSettings(Common::String &command, Common::StringMap &settings, Commo
 		return true;
 	}
 #endif
+#ifdef DETECTOR_BENCHMARK_HACK
+	else if (command == "benchmark-detector") {
+		runDetectorBenchmark(settings["benchmark-detector"]);
+		return true;
+	}
+#endif
 #ifdef UPGRADE_ALL_TARGETS_HACK
 	else if (command == "upgrade-targets") {
 		upgradeTargets();
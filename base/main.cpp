@@ -240,6 +240,8 @@ static Common::Error runGame(const EnginePlugin *plugin, OSystem &system, const
 	// Inform backend that the engine is about to be run
 	system.engineInit();
 
+	SearchMan.resetStats();
+
 	// Run the engine
 	Common::Error result = engine->run();
 
@@ -255,6 +257,11 @@ static Common::Error runGame(const EnginePlugin *plugin, OSystem &system, const
 	// We clear all debug levels again even though the engine should do it
 	DebugMan.clearAllDebugChannels();
 
+	// Report how the game looked up its files
+	const Common::SearchSet::Stats &searchStats = SearchMan.getStats();
+	debug(1, "SearchMan: %u lookups, %u answered by the member index, %u misses, %u files opened, %u index builds, %u names indexed",
+	      searchStats.lookups, searchStats.indexHits, searchStats.misses, searchStats.opens, searchStats.indexBuilds, searchStats.indexSize);
+
 	// Reset the file/directory mappings
 	SearchMan.clear();
 
@@ -62,6 +62,15 @@ int Archive::listMatchingMembers(ArchiveMemberList &list, const String &pattern)
 
 
 
+SearchSet::SearchSet() : _indexValid(false) {
+	resetStats();
+}
+
+void SearchSet::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+	_stats.indexSize = _indexValid ? _index.size() : 0;
+}
+
 SearchSet::ArchiveNodeList::iterator SearchSet::find(const String &name) {
 	ArchiveNodeList::iterator it = _list.begin();
 	for ( ; it != _list.end(); ++it) {
@@ -92,6 +101,7 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	invalidateIndex();
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -174,6 +184,7 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateIndex();
 	}
 }
 
@@ -188,6 +199,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateIndex();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -206,17 +218,73 @@ void SearchSet::setPriority(const String &name, int priority) {
 	insert(node);
 }
 
+void SearchSet::buildIndex() const {
+	if (_indexValid)
+		return;
+
+	_index.clear();
+	_indexArchives.clear();
+	_unindexed.clear();
+
+	StringArray names;
+	for (ArchiveNodeList::const_iterator it = _list.begin(); it != _list.end(); ++it) {
+		const uint pos = _indexArchives.size();
+		_indexArchives.push_back(it->_arc);
+
+		names.clear();
+		if (!it->_arc->listMemberNames(names)) {
+			_unindexed.push_back(pos);
+			continue;
+		}
+
+		// Archives of a higher priority have already claimed their names
+		for (StringArray::const_iterator name = names.begin(); name != names.end(); ++name) {
+			if (!_index.contains(*name))
+				_index[*name] = pos;
+		}
+	}
+
+	_indexValid = true;
+	_stats.indexBuilds++;
+	_stats.indexSize = _index.size();
+}
+
+Archive *SearchSet::lookupMember(const String &name) const {
+	buildIndex();
+	_stats.lookups++;
+
+	MemberIndex::const_iterator hit = _index.find(name);
+	const uint first = (hit != _index.end()) ? hit->_value : _indexArchives.size();
+
+	for (uint i = 0; i < _unindexed.size() && _unindexed[i] < first; i++) {
+		Archive *archive = _indexArchives[_unindexed[i]];
+		if (archive->hasFile(name))
+			return archive;
+	}
+
+	if (hit != _index.end()) {
+		if (_indexArchives[first]->hasFile(name)) {
+			_stats.indexHits++;
+			return _indexArchives[first];
+		}
+
+		// The member has gone away since the archive listed it, e.g. a
+		// deleted file, so ask all the archives after it
+		for (uint i = first + 1; i < _indexArchives.size(); i++) {
+			if (_indexArchives[i]->hasFile(name))
+				return _indexArchives[i];
+		}
+	}
+
+	_stats.misses++;
+	return 0;
+}
+
 bool SearchSet::hasFile(const String &name) const {
 	if (name.empty())
 		return false;
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for ( ; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return true;
-	}
-
-	return false;
+	return lookupMember(name) != 0;
 }
 
 int SearchSet::listMatchingMembers(ArchiveMemberList &list, const String &pattern) const {
@@ -243,11 +311,9 @@ const ArchiveMemberPtr SearchSet::getMember(const String &name) const {
 	if (name.empty())
 		return ArchiveMemberPtr();
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for ( ; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return it->_arc->getMember(name);
-	}
+	Archive *archive = lookupMember(name);
+	if (archive)
+		return archive->getMember(name);
 
 	return ArchiveMemberPtr();
 }
@@ -256,14 +322,24 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) con
 	if (name.empty())
 		return 0;
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for ( ; it != _list.end(); ++it) {
-		SeekableReadStream *stream = it->_arc->createReadStreamForMember(name);
-		if (stream)
-			return stream;
+	Archive *archive = lookupMember(name);
+	SeekableReadStream *stream = archive ? archive->createReadStreamForMember(name) : 0;
+
+	// Archives which aren't indexed may open members hasFile() doesn't
+	// know about, and an archive may fail to open a member it has. Then
+	// the others are asked in order, as before there was an index.
+	if (!stream && (archive || !_unindexed.empty())) {
+		ArchiveNodeList::const_iterator it = _list.begin();
+		for ( ; it != _list.end() && !stream; ++it) {
+			if (it->_arc != archive)
+				stream = it->_arc->createReadStreamForMember(name);
+		}
 	}
 
-	return 0;
+	if (stream)
+		_stats.opens++;
+
+	return stream;
 }
 
 
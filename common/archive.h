@@ -24,6 +24,9 @@
 #define COMMON_ARCHIVE_H
 
 #include "common/str.h"
+#include "common/str-array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
 #include "common/list.h"
 #include "common/ptr.h"
 #include "common/singleton.h"
@@ -48,6 +51,13 @@ public:
 	virtual SeekableReadStream *createReadStream() const = 0;
 	virtual String getName() const = 0;
 	virtual String getDisplayName() const { return getName(); }
+
+	/**
+	 * Returns the time the member was last modified, like
+	 * FSNode::getModificationTime() does. 0 means the time is unknown,
+	 * which is the case for members of most archives.
+	 */
+	virtual uint32 getModificationTime() const { return 0; }
 };
 
 typedef SharedPtr<ArchiveMember> ArchiveMemberPtr;
@@ -117,6 +127,17 @@ public:
 	 * @return the newly created input stream
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const = 0;
+
+	/**
+	 * Add the names of all members to list, in the form hasFile() takes
+	 * them. Archives only implement this when they compare names without
+	 * regard to case, and when the names they list are the only ones
+	 * hasFile() and createReadStreamForMember() accept. SearchSet uses it
+	 * to index the members of its archives.
+	 *
+	 * @return false if the archive can't list its member names
+	 */
+	virtual bool listMemberNames(StringArray &list) const { return false; }
 };
 
 
@@ -146,9 +167,42 @@ class SearchSet : public Archive {
 	// Add an archive keeping the list sorted by descending priority.
 	void insert(const Node& node);
 
+	// The archives in priority order, and for every member name the
+	// position of the first archive which lists it. Archives which
+	// can't list their member names are asked directly, before any
+	// archive which comes after them. Built on the first lookup after
+	// the archives changed.
+	typedef HashMap<String, uint, IgnoreCase_Hash, IgnoreCase_EqualTo> MemberIndex;
+	mutable MemberIndex _index;
+	mutable Array<Archive *> _indexArchives;
+	mutable Array<uint> _unindexed;
+	mutable bool _indexValid;
+
+	void invalidateIndex() { _indexValid = false; }
+	void buildIndex() const;
+
+	// The archive hasFile() finds the member in, or 0.
+	Archive *lookupMember(const String &name) const;
+
 public:
+	/**
+	 * Lookup counters, for profiling the file accesses of a game.
+	 */
+	struct Stats {
+		uint32 lookups;     ///< Calls to hasFile(), getMember() and createReadStreamForMember().
+		uint32 indexHits;   ///< Lookups answered by the member index alone.
+		uint32 misses;      ///< Lookups which found no archive.
+		uint32 opens;       ///< Streams created by createReadStreamForMember().
+		uint32 indexBuilds; ///< Times the member index was built.
+		uint32 indexSize;   ///< Member names in the current index.
+	};
+
+	SearchSet();
 	virtual ~SearchSet() { clear(); }
 
+	const Stats &getStats() const { return _stats; }
+	void resetStats();
+
 	/**
 	 * Add a new archive to the searchable set.
 	 */
@@ -241,6 +295,9 @@ public:
 	 * opening the first file encountered that matches the name.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
+
+private:
+	mutable Stats _stats;
 };
 
 
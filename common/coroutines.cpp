@@ -25,6 +25,7 @@
 #include "common/debug.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/memorypool.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 
@@ -72,6 +73,19 @@ static void displayCoroStats() {
 } // End of anonymous namespace
 #endif
 
+namespace {
+enum {
+	/** Context sizes are rounded up to a multiple of this */
+	kContextSizeStep = 16,
+	/** Number of context pools; larger contexts use the heap directly */
+	kContextSizeClasses = 32
+};
+
+/** The context pools, indexed by size class, allocated when first used */
+static MemoryPool *s_contextPools[kContextSizeClasses];
+
+} // End of anonymous namespace
+
 CoroBaseContext::CoroBaseContext(const char *func)
 	: _line(0), _sleep(0), _subctx(0) {
 #ifdef COROUTINE_DEBUG
@@ -92,6 +106,37 @@ CoroBaseContext::~CoroBaseContext() {
 	delete _subctx;
 }
 
+void *CoroBaseContext::operator new(size_t size) {
+	const size_t sizeClass = (size - 1) / kContextSizeStep;
+	if (sizeClass >= kContextSizeClasses)
+		return ::operator new(size);
+
+	if (!s_contextPools[sizeClass])
+		s_contextPools[sizeClass] = new MemoryPool((sizeClass + 1) * kContextSizeStep);
+	return s_contextPools[sizeClass]->allocChunk();
+}
+
+void CoroBaseContext::operator delete(void *ptr, size_t size) {
+	if (!ptr)
+		return;
+
+	const size_t sizeClass = (size - 1) / kContextSizeStep;
+	if (sizeClass >= kContextSizeClasses) {
+		::operator delete(ptr);
+		return;
+	}
+
+	assert(s_contextPools[sizeClass]);
+	s_contextPools[sizeClass]->freeChunk(ptr);
+}
+
+void CoroBaseContext::freeUnusedMemory() {
+	for (int i = 0; i < kContextSizeClasses; ++i) {
+		if (s_contextPools[i])
+			s_contextPools[i]->freeUnusedPages();
+	}
+}
+
 //--------------------- Scheduler Class ------------------------
 
 CoroutineScheduler::CoroutineScheduler() {
@@ -108,6 +153,9 @@ CoroutineScheduler::CoroutineScheduler() {
 	pRCfunction = NULL;
 	pidCounter = 0;
 
+	_profileProc = NULL;
+	_profileRefCon = NULL;
+
 	active = new PROCESS;
 	active->pPrevious = NULL;
 	active->pNext = NULL;
@@ -131,9 +179,10 @@ CoroutineScheduler::~CoroutineScheduler() {
 	active = 0;
 
 	// Clear the event list
-	Common::List<EVENT *>::iterator i;
-	for (i = _events.begin(); i != _events.end(); ++i)
-		delete *i;
+	for (EventMap::iterator i = _events.begin(); i != _events.end(); ++i)
+		delete i->_value;
+
+	CoroBaseContext::freeUnusedMemory();
 }
 
 void CoroutineScheduler::reset() {
@@ -166,6 +215,7 @@ void CoroutineScheduler::reset() {
 
 	// no active processes
 	pCurrent = active->pNext = NULL;
+	_processes.clear();
 
 	// place first process on free list
 	pFreeProcesses = processList;
@@ -175,6 +225,8 @@ void CoroutineScheduler::reset() {
 		processList[i - 1].pNext = (i == CORO_NUM_PROCESS) ? NULL : processList + i;
 		processList[i - 1].pPrevious = (i == 1) ? active : processList + (i - 2);
 	}
+
+	CoroBaseContext::freeUnusedMemory();
 }
 
 
@@ -229,8 +281,16 @@ void CoroutineScheduler::schedule() {
 		if (--pProc->sleepTime <= 0) {
 			// process is ready for dispatch, activate it
 			pCurrent = pProc;
+			pProc->resumeCount++;
+
+			if (_profileProc)
+				(_profileProc)(pProc, false, _profileRefCon);
+
 			pProc->coroAddr(pProc->state, pProc->param);
 
+			if (_profileProc)
+				(_profileProc)(pProc, true, _profileRefCon);
+
 			if (!pProc->state || pProc->state->_sleep <= 0) {
 				// Coroutine finished
 				pCurrent = pCurrent->pPrevious;
@@ -248,9 +308,8 @@ void CoroutineScheduler::schedule() {
 	}
 
 	// Disable any events that were pulsed
-	Common::List<EVENT *>::iterator i;
-	for (i = _events.begin(); i != _events.end(); ++i) {
-		EVENT *evt = *i;
+	for (EventMap::iterator i = _events.begin(); i != _events.end(); ++i) {
+		EVENT *evt = i->_value;
 		if (evt->pulsing) {
 			evt->pulsing = evt->signalled = false;
 		}
@@ -539,6 +598,10 @@ PROCESS *CoroutineScheduler::createProcess(uint32 pid, CORO_ADDR coroAddr, const
 
 	// set new process id
 	pProc->pid = pid;
+	pProc->pNextSamePid = getProcess(pid);
+	_processes[pid] = pProc;
+
+	pProc->resumeCount = 0;
 
 	// set new process specific info
 	if (sizeParam) {
@@ -574,26 +637,48 @@ void CoroutineScheduler::killProcess(PROCESS *pKillProc) {
 	assert(numProcs >= 0);
 #endif
 
+	freeProcess(pKillProc);
+}
+
+void CoroutineScheduler::freeProcess(PROCESS *pProc) {
 	// Free process' resources
 	if (pRCfunction != NULL)
-		(pRCfunction)(pKillProc);
+		(pRCfunction)(pProc);
 
-	delete pKillProc->state;
-	pKillProc->state = 0;
+	delete pProc->state;
+	pProc->state = 0;
+
+	// Take the process out of the list of processes with the same Id
+	ProcessMap::iterator i = _processes.find(pProc->pid);
+	assert(i != _processes.end());
+	if (i->_value == pProc) {
+		if (pProc->pNextSamePid)
+			i->_value = pProc->pNextSamePid;
+		else
+			_processes.erase(i);
+	} else {
+		PROCESS *pPrev = i->_value;
+		while (pPrev->pNextSamePid != pProc) {
+			pPrev = pPrev->pNextSamePid;
+			assert(pPrev);
+		}
+		pPrev->pNextSamePid = pProc->pNextSamePid;
+	}
+	pProc->pNextSamePid = NULL;
 
 	// Take the process out of the active chain list
-	pKillProc->pPrevious->pNext = pKillProc->pNext;
-	if (pKillProc->pNext)
-		pKillProc->pNext->pPrevious = pKillProc->pPrevious;
+	pProc->pPrevious->pNext = pProc->pNext;
+	if (pProc->pNext)
+		pProc->pNext->pPrevious = pProc->pPrevious;
 
 	// link first free process after pProc
-	pKillProc->pNext = pFreeProcesses;
+	pProc->pNext = pFreeProcesses;
 	if (pFreeProcesses)
-		pKillProc->pNext->pPrevious = pKillProc;
-	pKillProc->pPrevious = NULL;
+		pProc->pNext->pPrevious = pProc;
+	pProc->pPrevious = NULL;
 
-	// make pKillProc the first free process
-	pFreeProcesses = pKillProc;
+	// make pProc the first free process
+	pFreeProcesses = pProc;
 }
 
 PROCESS *CoroutineScheduler::getCurrentProcess() {
@@ -612,39 +697,27 @@ int CoroutineScheduler::getCurrentPID() const {
 
 int CoroutineScheduler::killMatchingProcess(uint32 pidKill, int pidMask) {
 	int numKilled = 0;
-	PROCESS *pProc, *pPrev; // process list pointers
+	PROCESS *pProc, *pNextProc;
 
-	for (pProc = active->pNext, pPrev = active; pProc != NULL; pPrev = pProc, pProc = pProc->pNext) {
-		if ((pProc->pid & (uint32)pidMask) == pidKill) {
-			// found a matching process
+	if (pidMask == -1) {
+		// Only the processes with exactly the given Id need to be checked
+		for (pProc = getProcess(pidKill); pProc != NULL; pProc = pNextProc) {
+			pNextProc = pProc->pNextSamePid;
 
 			// dont kill the current process
 			if (pProc != pCurrent) {
-				// kill this process
 				numKilled++;
+				freeProcess(pProc);
+			}
+		}
+	} else {
+		for (pProc = active->pNext; pProc != NULL; pProc = pNextProc) {
+			pNextProc = pProc->pNext;
 
-				// Free the process' resources
-				if (pRCfunction != NULL)
-					(pRCfunction)(pProc);
-
-				delete pProc->state;
-				pProc->state = 0;
-
-				// make prev point to next to unlink pProc
-				pPrev->pNext = pProc->pNext;
-				if (pProc->pNext)
-					pPrev->pNext->pPrevious = pPrev;
-
-				// link first free process after pProc
-				pProc->pNext = pFreeProcesses;
-				pProc->pPrevious = NULL;
-				pFreeProcesses->pPrevious = pProc;
-
-				// make pProc the first free process
-				pFreeProcesses = pProc;
-
-				// set to a process on the active list
-				pProc = pPrev;
+			// dont kill the current process
+			if ((pProc->pid & (uint32)pidMask) == pidKill && pProc != pCurrent) {
+				numKilled++;
+				freeProcess(pProc);
 			}
 		}
 	}
@@ -663,23 +736,19 @@ void CoroutineScheduler::setResourceCallback(VFPTRPP pFunc) {
 	pRCfunction = pFunc;
 }
 
-PROCESS *CoroutineScheduler::getProcess(uint32 pid) {
-	PROCESS *pProc = active->pNext;
-	while ((pProc != NULL) && (pProc->pid != pid))
-		pProc = pProc->pNext;
+void CoroutineScheduler::setProfileCallback(ProfileProc pFunc, void *refCon) {
+	_profileProc = pFunc;
+	_profileRefCon = refCon;
+}
 
-	return pProc;
+PROCESS *CoroutineScheduler::getProcess(uint32 pid) {
+	ProcessMap::const_iterator i = _processes.find(pid);
+	return (i != _processes.end()) ? i->_value : NULL;
 }
 
 EVENT *CoroutineScheduler::getEvent(uint32 pid) {
-	Common::List<EVENT *>::iterator i;
-	for (i = _events.begin(); i != _events.end(); ++i) {
-		EVENT *evt = *i;
-		if (evt->pid == pid)
-			return evt;
-	}
-
-	return NULL;
+	EventMap::const_iterator i = _events.find(pid);
+	return (i != _events.end()) ? i->_value : NULL;
 }
 
 
@@ -690,14 +759,14 @@ uint32 CoroutineScheduler::createEvent(bool bManualReset, bool bInitialState) {
 	evt->signalled = bInitialState;
 	evt->pulsing = false;
 
-	_events.push_back(evt);
+	_events[evt->pid] = evt;
 	return evt->pid;
 }
 
 void CoroutineScheduler::closeEvent(uint32 pidEvent) {
 	EVENT *evt = getEvent(pidEvent);
 	if (evt) {
-		_events.remove(evt);
+		_events.erase(pidEvent);
 		delete evt;
 	}
 }
@@ -26,6 +26,7 @@
 #include "common/scummsys.h"
 #include "common/util.h"    // for SCUMMVM_CURRENT_FUNCTION
 #include "common/list.h"
+#include "common/hashmap.h"
 #include "common/singleton.h"
 
 namespace Common {
@@ -66,6 +67,18 @@ struct CoroBaseContext {
 	 * Destructor for coroutine context
 	 */
 	virtual ~CoroBaseContext();
+
+	/**
+	 * Contexts are created and destroyed on every coroutine call, so they
+	 * are allocated from memory pools, one for each size class.
+	 */
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size);
+
+	/**
+	 * Releases the memory of the context pools which is not in use.
+	 */
+	static void freeUnusedMemory();
 };
 
 typedef CoroBaseContext *CoroContext;
@@ -309,6 +322,9 @@ struct PROCESS {
 	uint32 pid;         ///< process ID
 	uint32 pidWaiting[CORO_MAX_PID_WAITING];    ///< Process ID(s) process is currently waiting on
 	char param[CORO_PARAM_SIZE];    ///< process specific info
+
+	PROCESS *pNextSamePid;  ///< next active process with the same process ID
+	uint32 resumeCount;     ///< number of times the process was run
 };
 typedef PROCESS *PPROCESS;
 
@@ -330,6 +346,12 @@ public:
 	/** Pointer to a function of the form "void function(PPROCESS)" */
 	typedef void (*VFPTRPP)(PROCESS *);
 
+	/**
+	 * Profiling hook, called right before a process is run with bFinished
+	 * set to false, and right after it yields or ends with bFinished set to true.
+	 */
+	typedef void (*ProfileProc)(const PROCESS *pProc, bool bFinished, void *refCon);
+
 private:
 	friend class Singleton<CoroutineScheduler>;
 
@@ -359,8 +381,18 @@ private:
 	/** Auto-incrementing process Id */
 	int pidCounter;
 
-	/** Event list */
-	Common::List<EVENT *> _events;
+	typedef Common::HashMap<uint32, PROCESS *> ProcessMap;
+	typedef Common::HashMap<uint32, EVENT *> EventMap;
+
+	/** The first active process for each process Id, see PROCESS::pNextSamePid */
+	ProcessMap _processes;
+
+	/** Events by their Id */
+	EventMap _events;
+
+	/** The profiling hook */
+	ProfileProc _profileProc;
+	void *_profileRefCon;
 
 #ifdef DEBUG
 	// diagnostic process counters
@@ -382,6 +414,12 @@ private:
 
 	PROCESS *getProcess(uint32 pid);
 	EVENT *getEvent(uint32 pid);
+
+	/**
+	 * Takes a process which is not the current one out of the active list
+	 * and puts it on the free list.
+	 */
+	void freeProcess(PROCESS *pProc);
 public:
 	/**
 	 * Kills all processes and places them on the free list.
@@ -513,6 +551,16 @@ public:
 	 */
 	void setResourceCallback(VFPTRPP pFunc);
 
+	/**
+	 * Set the profiling hook, which is called around every run of a process
+	 * by schedule(). Together with PROCESS::resumeCount this allows to find
+	 * out how often processes run and how much time they take.
+	 *
+	 * @param pFunc         Function to be called, or NULL to disable profiling
+	 * @param refCon        Passed on to pFunc
+	 */
+	void setProfileCallback(ProfileProc pFunc, void *refCon = NULL);
+
 	/* Event methods */
 	/**
 	 * Creates a new event (semaphore) object
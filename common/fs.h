@@ -206,6 +206,13 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Returns the time the object referred by this node was last modified.
+	 * The value is only meaningful for comparison with other values returned
+	 * by this method; 0 means the time could not be determined.
+	 */
+	virtual uint32 getModificationTime() const;
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -331,6 +338,11 @@ public:
 	 */
 	virtual int listMembers(ArchiveMemberList &list) const;
 
+	/**
+	 * Returns the relative paths of all the files in the cache.
+	 */
+	virtual bool listMemberNames(StringArray &list) const;
+
 	/**
 	 * Get a ArchiveMember representation of the specified file. A full match of relative
 	 * path and filename is needed for success.
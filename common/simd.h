@@ -0,0 +1,52 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_SIMD_H
+#define COMMON_SIMD_H
+
+#include "common/scummsys.h"
+
+/**
+ *  \file simd.h
+ *  Detection of the vector instruction sets the compiler targets anyway,
+ *  so that code using them needs no runtime checks.
+ *
+ *  SCUMMVM_SSE2 - SSE2 is available, which is always the case on x86-64
+ *  SCUMMVM_NEON - NEON is available, which is always the case on AArch64
+ *
+ *  The NEON code is only used on AArch64. On 32 bit ARM, NEON is optional,
+ *  and those targets use the assembler rate converter instead of the one
+ *  in rate.cpp anyway. The vector code assumes little endian hosts, so
+ *  nothing is defined on big endian ones.
+ */
+
+#ifdef SCUMM_LITTLE_ENDIAN
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCUMMVM_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SCUMMVM_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+#endif
@@ -106,9 +106,13 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/substream.h"
+#include "common/textconsole.h"
 
+#include "common/array.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/ptr.h"
 
 #if defined(STRICTUNZIP) || defined(STRICTZIPUNZIP)
 /* like the STRICT of WIN32, we define a pointer that cannot be converted
@@ -382,6 +386,7 @@ typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_H
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef;	/* owns _stream, shared with open member streams */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -544,6 +549,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 	int err=UNZ_OK;
 
 	us->_stream = stream;
+	us->_streamRef = Common::SharedPtr<Common::SeekableReadStream>(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos==0)
@@ -595,7 +601,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return NULL;
 	}
@@ -644,7 +649,8 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != NULL)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
+	// The archive stream itself is released through _streamRef, once the
+	// last member stream referring to it is gone as well.
 	delete s;
 	return UNZ_OK;
 }
@@ -1419,10 +1425,333 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+/**
+ * A stored (uncompressed) member of a ZIP archive. This is a plain window
+ * onto the archive stream, which it keeps alive for as long as it exists.
+ */
+class ZipStoredReadStream : public SafeSeekableSubReadStream {
+	SharedPtr<SeekableReadStream> _archiveStream;
+
+public:
+	ZipStoredReadStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 begin, uint32 end)
+		: SafeSeekableSubReadStream(archiveStream.get(), begin, end, DisposeAfterUse::NO),
+		  _archiveStream(archiveStream) {
+	}
+};
+
+#ifdef USE_ZLIB
+
+/**
+ * A deflated member of a ZIP archive, decompressed on the fly.
+ *
+ * Every stream has its own inflate state and re-positions the archive
+ * stream before each read, so any number of members may be open at the
+ * same time.
+ *
+ * While decompressing, the stream records a checkpoint (the inflate bit
+ * position plus the preceding 32KB of output) every kCheckpointSpan bytes.
+ * Seeking then only has to inflate from the nearest checkpoint instead of
+ * from the start of the member. Seeking backwards within the last 32KB of
+ * output is free.
+ */
+class ZipInflateReadStream : public SeekableReadStream {
+	enum {
+		kInputBufferSize = UNZ_BUFSIZE,
+		kWindowSize = 32768,			// 1 << MAX_WBITS
+		kCheckpointSpan = 1024 * 1024
+	};
+
+	struct Checkpoint {
+		uint32 outPos;	///< position in the uncompressed data
+		uint32 inPos;	///< offset of the next compressed byte
+		int bits;		///< bits of the byte before inPos that are still unused
+		byte *window;	///< the kWindowSize bytes of output preceding outPos
+	};
+
+	SharedPtr<SeekableReadStream> _archiveStream;
+	const uint32 _dataStart;
+	const uint32 _compressedSize;
+	const uint32 _uncompressedSize;
+	const uint32 _expectedCrc;
+
+	z_stream _stream;
+	int _zlibErr;
+	bool _eos;
+
+	byte _inBuf[kInputBufferSize];
+	uint32 _inPos;			///< compressed bytes fetched from the archive so far
+
+	byte _window[kWindowSize];	///< ring buffer holding the most recent output
+	uint32 _outPos;			///< current read position
+	uint32 _inflatedPos;	///< uncompressed bytes produced so far
+
+	uint32 _crc;
+	bool _crcValid;			///< false once we resumed from a checkpoint
+
+	Array<Checkpoint> _checkpoints;
+
+	void restart();
+	bool restore(const Checkpoint &checkpoint);
+	void addCheckpoint();
+	bool inflateChunk();
+	bool inflateTo(uint32 position);
+
+public:
+	ZipInflateReadStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 dataStart,
+	                     uint32 compressedSize, uint32 uncompressedSize, uint32 crc);
+	~ZipInflateReadStream();
+
+	bool err() const { return _zlibErr != Z_OK && _zlibErr != Z_STREAM_END; }
+	void clearErr() { _eos = false; }
+	bool eos() const { return _eos; }
+
+	uint32 read(void *dataPtr, uint32 dataSize);
+
+	int32 pos() const { return _outPos; }
+	int32 size() const { return _uncompressedSize; }
+	bool seek(int32 offset, int whence = SEEK_SET);
+};
+
+ZipInflateReadStream::ZipInflateReadStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 dataStart,
+                                           uint32 compressedSize, uint32 uncompressedSize, uint32 crc)
+	: _archiveStream(archiveStream), _dataStart(dataStart), _compressedSize(compressedSize),
+	  _uncompressedSize(uncompressedSize), _expectedCrc(crc), _stream(), _eos(false) {
+	// windowBits is negative since ZIP members carry no zlib header.
+	_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+	if (_zlibErr != Z_OK)
+		return;
+
+	_inPos = 0;
+	_outPos = 0;
+	_inflatedPos = 0;
+	_crc = crc32(0, Z_NULL, 0);
+	_crcValid = true;
+	_stream.next_in = _inBuf;
+	_stream.avail_in = 0;
+}
+
+ZipInflateReadStream::~ZipInflateReadStream() {
+	inflateEnd(&_stream);
+
+	for (uint i = 0; i < _checkpoints.size(); ++i)
+		delete[] _checkpoints[i].window;
+}
+
+void ZipInflateReadStream::restart() {
+	_zlibErr = inflateReset(&_stream);
+	_stream.next_in = _inBuf;
+	_stream.avail_in = 0;
+	_inPos = 0;
+	_outPos = 0;
+	_inflatedPos = 0;
+	_crc = crc32(0, Z_NULL, 0);
+	_crcValid = true;
+}
+
+bool ZipInflateReadStream::restore(const Checkpoint &checkpoint) {
+	_zlibErr = inflateReset(&_stream);
+	if (_zlibErr != Z_OK)
+		return false;
+
+	if (checkpoint.bits) {
+		// The checkpoint lies inside a byte, feed its remaining bits first.
+		_archiveStream->seek(_dataStart + checkpoint.inPos - 1, SEEK_SET);
+		const byte partial = _archiveStream->readByte();
+		if (_archiveStream->err()) {
+			_zlibErr = Z_ERRNO;
+			return false;
+		}
+		_zlibErr = inflatePrime(&_stream, checkpoint.bits, partial >> (8 - checkpoint.bits));
+		if (_zlibErr != Z_OK)
+			return false;
+	}
+
+	_zlibErr = inflateSetDictionary(&_stream, checkpoint.window, kWindowSize);
+	if (_zlibErr != Z_OK)
+		return false;
+
+	// Rebuild the output ring so that it matches the restored position.
+	const uint32 split = checkpoint.outPos % kWindowSize;
+	memcpy(_window + split, checkpoint.window, kWindowSize - split);
+	memcpy(_window, checkpoint.window + kWindowSize - split, split);
+
+	_stream.next_in = _inBuf;
+	_stream.avail_in = 0;
+	_inPos = checkpoint.inPos;
+	_outPos = checkpoint.outPos;
+	_inflatedPos = checkpoint.outPos;
+	_crcValid = false;
+	return true;
+}
+
+void ZipInflateReadStream::addCheckpoint() {
+	Checkpoint checkpoint;
+	checkpoint.outPos = _inflatedPos;
+	checkpoint.inPos = _inPos - _stream.avail_in;
+	checkpoint.bits = _stream.data_type & 7;
+	checkpoint.window = new byte[kWindowSize];
+
+	// Linearize the ring, oldest byte first.
+	const uint32 split = _inflatedPos % kWindowSize;
+	memcpy(checkpoint.window, _window + split, kWindowSize - split);
+	memcpy(checkpoint.window + kWindowSize - split, _window, split);
+
+	_checkpoints.push_back(checkpoint);
+}
+
+bool ZipInflateReadStream::inflateChunk() {
+	if (_stream.avail_in == 0 && _inPos < _compressedSize) {
+		const uint32 readThis = MIN<uint32>(kInputBufferSize, _compressedSize - _inPos);
+		_archiveStream->seek(_dataStart + _inPos, SEEK_SET);
+		if (_archiveStream->read(_inBuf, readThis) != readThis) {
+			_zlibErr = Z_ERRNO;
+			return false;
+		}
+		_inPos += readThis;
+		_stream.next_in = _inBuf;
+		_stream.avail_in = readThis;
+	}
+
+	// Inflate straight into the output ring. Z_BLOCK makes zlib stop at
+	// every deflate block boundary, which is where checkpoints can be taken.
+	const uint32 ringPos = _inflatedPos % kWindowSize;
+	byte *const out = _window + ringPos;
+	_stream.next_out = out;
+	_stream.avail_out = MIN<uint32>(kWindowSize - ringPos, _uncompressedSize - _inflatedPos);
+
+	const uint32 availBefore = _stream.avail_out;
+	_zlibErr = inflate(&_stream, Z_BLOCK);
+	const uint32 produced = availBefore - _stream.avail_out;
+
+	if (_zlibErr == Z_STREAM_END && _inflatedPos + produced < _uncompressedSize) {
+		// The deflate stream ended before the member was complete.
+		_zlibErr = Z_DATA_ERROR;
+	} else if (_zlibErr == Z_BUF_ERROR && produced == 0 && _inPos >= _compressedSize) {
+		// Ran out of compressed data before the member was complete.
+		_zlibErr = Z_DATA_ERROR;
+	} else if (_zlibErr == Z_BUF_ERROR) {
+		_zlibErr = Z_OK;
+	}
+
+	if (err())
+		return false;
+
+	_inflatedPos += produced;
+	if (_crcValid) {
+		_crc = crc32(_crc, out, produced);
+		if (_inflatedPos == _uncompressedSize && _crc != _expectedCrc) {
+			warning("ZipInflateReadStream: CRC mismatch in ZIP member");
+			_zlibErr = Z_DATA_ERROR;
+			return false;
+		}
+	}
+
+	const uint32 lastCheckpoint = _checkpoints.empty() ? 0 : _checkpoints.back().outPos;
+	if ((_stream.data_type & 128) && !(_stream.data_type & 64) &&
+	    _inflatedPos >= lastCheckpoint + kCheckpointSpan)
+		addCheckpoint();
+
+	return true;
+}
+
+bool ZipInflateReadStream::inflateTo(uint32 position) {
+	while (_inflatedPos < position) {
+		if (!inflateChunk())
+			return false;
+	}
+	return true;
+}
+
+uint32 ZipInflateReadStream::read(void *dataPtr, uint32 dataSize) {
+	byte *dst = (byte *)dataPtr;
+	uint32 remaining = dataSize;
+
+	while (remaining > 0 && !err()) {
+		if (_outPos == _uncompressedSize) {
+			_eos = true;
+			break;
+		}
+
+		if (_outPos == _inflatedPos && !inflateChunk())
+			break;
+
+		// Copy whatever is buffered in the ring, without wrapping around.
+		const uint32 ringPos = _outPos % kWindowSize;
+		const uint32 copy = MIN(MIN(remaining, _inflatedPos - _outPos), kWindowSize - ringPos);
+		memcpy(dst, _window + ringPos, copy);
+		dst += copy;
+		_outPos += copy;
+		remaining -= copy;
+	}
+
+	return dataSize - remaining;
+}
+
+bool ZipInflateReadStream::seek(int32 offset, int whence) {
+	int32 newPos = 0;
+	switch (whence) {
+	case SEEK_SET:
+		newPos = offset;
+		break;
+	case SEEK_CUR:
+		newPos = _outPos + offset;
+		break;
+	case SEEK_END:
+		newPos = _uncompressedSize + offset;
+		break;
+	}
+
+	if (newPos < 0 || (uint32)newPos > _uncompressedSize || err())
+		return false;
+
+	const uint32 target = newPos;
+	_eos = false;
+
+	// The ring still holds the most recent output.
+	const uint32 history = MIN<uint32>(_inflatedPos, kWindowSize);
+	if (target <= _inflatedPos && target >= _inflatedPos - history) {
+		_outPos = target;
+		return true;
+	}
+
+	// Otherwise resume from the closest checkpoint which does not lie behind
+	// the current inflate position when seeking forward.
+	const Checkpoint *best = 0;
+	for (uint i = 0; i < _checkpoints.size() && _checkpoints[i].outPos <= target; ++i)
+		best = &_checkpoints[i];
+
+	if (target < _inflatedPos) {
+		if (best) {
+			if (!restore(*best))
+				return false;
+		} else {
+			restart();
+			if (err())
+				return false;
+		}
+	} else if (best && best->outPos > _inflatedPos) {
+		if (!restore(*best))
+			return false;
+	}
+
+	if (!inflateTo(target))
+		return false;
+
+	_outPos = target;
+	return true;
+}
+
+#endif // USE_ZLIB
+
 
 class ZipArchive : public Archive {
 	unzFile _zipFile;
 
+	enum {
+		/** Deflated members up to this size are inflated into memory right away. */
+		kZipInMemoryThreshold = 16 * 1024
+	};
+
 public:
 	ZipArchive(unzFile zipFile);
 
@@ -1431,6 +1760,7 @@ public:
 
 	virtual bool hasFile(const String &name) const;
 	virtual int listMembers(ArchiveMemberList &list) const;
+	virtual bool listMemberNames(StringArray &list) const;
 	virtual const ArchiveMemberPtr getMember(const String &name) const;
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
 };
@@ -1478,6 +1808,15 @@ int ZipArchive::listMembers(ArchiveMemberList &list) const {
 	return members;
 }
 
+bool ZipArchive::listMemberNames(StringArray &list) const {
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	for (ZipHash::const_iterator i = archive->_hash.begin(), end = archive->_hash.end();
+	     i != end; ++i)
+		list.push_back(i->_key);
+
+	return true;
+}
+
 const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 	if (!hasFile(name))
 		return ArchiveMemberPtr();
@@ -1489,32 +1828,55 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return 0;
 
-	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
-		return 0;
-
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
+	unz_s *const archive = (unz_s *)_zipFile;
+	uInt iSizeVar;
+	uLong offsetLocalExtraField;
+	uInt sizeLocalExtraField;
+	if (unzlocal_CheckCurrentFileCoherencyHeader(archive, &iSizeVar, &offsetLocalExtraField, &sizeLocalExtraField) != UNZ_OK)
 		return 0;
 
-	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
-	assert(buffer);
+	const unz_file_info &fileInfo = archive->cur_file_info;
+	const uint32 dataStart = archive->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar
+	                       + archive->byte_before_the_zipfile;
 
-	if (unzReadCurrentFile(_zipFile, buffer, fileInfo.uncompressed_size) != (int)fileInfo.uncompressed_size) {
-		free(buffer);
-		return 0;
+	// Stored members are served straight from the archive stream.
+	if (fileInfo.compression_method == 0) {
+		if (fileInfo.compressed_size != fileInfo.uncompressed_size)
+			return 0;
+		return new ZipStoredReadStream(archive->_streamRef, dataStart, dataStart + fileInfo.uncompressed_size);
 	}
 
-	if (unzCloseCurrentFile(_zipFile) != UNZ_OK) {
-		free(buffer);
+#ifdef USE_ZLIB
+	SeekableReadStream *stream = new ZipInflateReadStream(archive->_streamRef, dataStart,
+	                                                      fileInfo.compressed_size, fileInfo.uncompressed_size, fileInfo.crc);
+	if (stream->err()) {
+		delete stream;
 		return 0;
 	}
 
-	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	// Small members are cheaper to inflate in one go than to keep an inflate
+	// state and window around for them.
+	if (fileInfo.uncompressed_size <= kZipInMemoryThreshold) {
+		byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
+		assert(buffer);
+
+		const uint32 bytesRead = stream->read(buffer, fileInfo.uncompressed_size);
+		const bool failed = stream->err() || bytesRead != fileInfo.uncompressed_size;
+		delete stream;
 
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
+		if (failed) {
+			free(buffer);
+			return 0;
+		}
+
+		return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	}
+
+	return stream;
+#else
+	// Cannot decompress the file without zlib.
+	return 0;
+#endif
 }
 
 Archive *makeZipArchive(const String &name) {
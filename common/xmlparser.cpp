@@ -28,6 +28,36 @@
 
 namespace Common {
 
+/** Events written to the record stream, see XMLParser::replay() */
+enum {
+	kRecordStart = 1,
+	kRecordKey = 2,
+	kRecordClosedKey = 3,
+	kRecordClose = 4,
+	kRecordEnd = 5
+};
+
+void XMLParser::writeRecordString(WriteStream &stream, const String &str) {
+	stream.writeUint16LE(str.size());
+	stream.write(str.c_str(), str.size());
+}
+
+bool XMLParser::readRecordString(SeekableReadStream &stream, String &str) {
+	const uint16 size = stream.readUint16LE();
+	if (stream.eos() || size > stream.size() - stream.pos())
+		return false;
+
+	char buffer[256];
+	str.clear();
+	for (uint16 left = size; left > 0;) {
+		const uint16 chunk = MIN<uint16>(left, sizeof(buffer));
+		stream.read(buffer, chunk);
+		str += String(buffer, chunk);
+		left -= chunk;
+	}
+	return !stream.err();
+}
+
 XMLParser::~XMLParser() {
 	while (!_activeKey.empty())
 		freeNode(_activeKey.pop());
@@ -80,6 +110,12 @@ void XMLParser::close() {
 bool XMLParser::parserError(const String &errStr) {
 	_state = kParserError;
 
+	// There is no XML data to point at when replaying recorded keys
+	if (_stream == 0) {
+		g_system->logMessage(LogMessageType::kError, ("\nParser error: " + errStr + "\n\n").c_str());
+		return false;
+	}
+
 	const int startPosition = _stream->pos();
 	int currentPosition = startPosition;
 	int lineCount = 1;
@@ -311,6 +347,9 @@ bool XMLParser::parse() {
 
 	cleanup();
 
+	if (_record)
+		_record->writeByte(kRecordStart);
+
 	bool activeClosure = false;
 	bool activeHeader = false;
 	bool selfClosure;
@@ -385,6 +424,9 @@ bool XMLParser::parse() {
 
 		case kParserNeedPropertyName:
 			if (activeClosure) {
+				if (_record)
+					_record->writeByte(kRecordClose);
+
 				if (!closeKey()) {
 					parserError("Missing data when closing key '" + _activeKey.top()->name + "'.");
 					break;
@@ -411,9 +453,13 @@ bool XMLParser::parse() {
 			if (_char == '>') {
 				if (activeHeader && !selfClosure) {
 					parserError("XML Header must be self-closed.");
-				} else if (parseActiveKey(selfClosure)) {
-					_char = _stream->readByte();
-					_state = kParserNeedKey;
+				} else {
+					recordKey(_activeKey.top(), selfClosure);
+
+					if (parseActiveKey(selfClosure)) {
+						_char = _stream->readByte();
+						_state = kParserNeedKey;
+					}
 				}
 
 				activeHeader = false;
@@ -457,9 +503,101 @@ bool XMLParser::parse() {
 	if (_state != kParserNeedKey || !_activeKey.empty())
 		return parserError("Unexpected end of file.");
 
+	if (_record)
+		_record->writeByte(kRecordEnd);
+
 	return true;
 }
 
+void XMLParser::recordKey(const ParserNode *node, bool closed) {
+	if (!_record)
+		return;
+
+	_record->writeByte(closed ? kRecordClosedKey : kRecordKey);
+	writeRecordString(*_record, node->name);
+	_record->writeByte(node->header ? 1 : 0);
+	_record->writeUint16LE(node->values.size());
+	for (StringMap::const_iterator i = node->values.begin(); i != node->values.end(); ++i) {
+		writeRecordString(*_record, i->_key);
+		writeRecordString(*_record, i->_value);
+	}
+}
+
+bool XMLParser::replay(SeekableReadStream &stream) {
+	if (_XMLkeys == 0)
+		buildLayout();
+
+	bool complete = false;
+
+	while (stream.pos() < stream.size()) {
+		const byte event = stream.readByte();
+		if (stream.eos() || stream.err())
+			return false;
+
+		switch (event) {
+		case kRecordStart:
+			while (!_activeKey.empty())
+				freeNode(_activeKey.pop());
+
+			cleanup();
+			_state = kParserNeedKey;
+			complete = false;
+			break;
+
+		case kRecordKey:
+		case kRecordClosedKey: {
+			if (_activeKey.size() >= MAX_XML_DEPTH)
+				return false;
+
+			ParserNode *node = allocNode();
+			node->ignore = false;
+			node->depth = _activeKey.size();
+			node->layout = 0;
+			_activeKey.push(node);
+
+			if (!readRecordString(stream, node->name))
+				return false;
+
+			node->header = stream.readByte() != 0;
+			const uint16 count = stream.readUint16LE();
+			if (stream.eos() || (node->header && event != kRecordClosedKey))
+				return false;
+
+			for (uint16 i = 0; i < count; ++i) {
+				String key, value;
+				if (!readRecordString(stream, key) || !readRecordString(stream, value))
+					return false;
+				node->values[key] = value;
+			}
+
+			if (!parseActiveKey(event == kRecordClosedKey))
+				return false;
+			break;
+		}
+
+		case kRecordClose:
+			if (_activeKey.empty())
+				return false;
+
+			if (!closeKey())
+				return parserError("Missing data when closing key.");
+			break;
+
+		case kRecordEnd:
+			if (!_activeKey.empty())
+				return false;
+
+			complete = true;
+			break;
+
+		default:
+			return false;
+		}
+	}
+
+	return complete && !stream.err();
+}
+
 bool XMLParser::skipSpaces() {
 	if (!isSpace(_char))
 		return false;
@@ -37,6 +37,7 @@
 namespace Common {
 
 class SeekableReadStream;
+class WriteStream;
 
 #define MAX_XML_DEPTH 8
 
@@ -92,7 +93,7 @@ public:
 	/**
 	 * Parser constructor.
 	 */
-	XMLParser() : _XMLkeys(0), _stream(0) {}
+	XMLParser() : _XMLkeys(0), _stream(0), _record(0) {}
 
 	virtual ~XMLParser();
 
@@ -187,6 +188,35 @@ public:
 	 */
 	bool parse();
 
+	/**
+	 * Makes parse() write every key it passes to the callbacks to the
+	 * given stream, so that replay() can issue the same callbacks later
+	 * on without tokenizing the XML data again. The parser does not take
+	 * ownership of the stream. Pass 0 to stop recording.
+	 */
+	void setRecordStream(WriteStream *stream) { _record = stream; }
+
+	/**
+	 * Issues the callbacks recorded by parse() while a record stream was
+	 * set. Several parses may be recorded into the same stream, they are
+	 * replayed in order.
+	 * Returns true if the recording was complete and all the callbacks
+	 * succeeded.
+	 */
+	bool replay(SeekableReadStream &stream);
+
+	/**
+	 * Writes a string the way the record stream stores it, so that other
+	 * data stored along with a recording can use the same format.
+	 */
+	static void writeRecordString(WriteStream &stream, const String &str);
+
+	/**
+	 * Reads a string written by writeRecordString(). Returns false if the
+	 * stream ended before the whole string could be read.
+	 */
+	static bool readRecordString(SeekableReadStream &stream, String &str);
+
 	/**
 	 * Returns the active node being parsed (the one on top of
 	 * the node stack).
@@ -341,6 +371,9 @@ private:
 	SeekableReadStream *_stream;
 	String _fileName;
 
+	WriteStream *_record; /** Stream the parsed keys are recorded to */
+	void recordKey(const ParserNode *node, bool closed);
+
 	ParserState _state; /** Internal state of the parser */
 
 	String _error; /** Current error message */
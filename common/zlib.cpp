@@ -333,15 +333,16 @@ protected:
 	}
 
 public:
-	GZipWriteStream(WriteStream *w) : _wrapped(w), _stream() {
+	GZipWriteStream(WriteStream *w, int level) : _wrapped(w), _stream() {
 		assert(w != 0);
+		assert(level == Z_DEFAULT_COMPRESSION || (level >= Z_NO_COMPRESSION && level <= Z_BEST_COMPRESSION));
 
 		// Adding 16 to windowBits indicates to zlib that it is supposed to
 		// write gzip headers. This feature was added in zlib 1.2.0.4,
 		// released 10 August 2003.
 		// Note: This is *crucial* for savegame compatibility, do *not* remove!
 		_zlibErr = deflateInit2(&_stream,
-		                 Z_DEFAULT_COMPRESSION,
+		                 level,
 		                 Z_DEFLATED,
 		                 MAX_WBITS + 16,
 		                 8,
@@ -428,10 +429,10 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
 	return toBeWrapped;
 }
 
-WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
+WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped, int level) {
 #if defined(USE_ZLIB)
 	if (toBeWrapped)
-		return new GZipWriteStream(toBeWrapped);
+		return new GZipWriteStream(toBeWrapped, level);
 #endif
 	return toBeWrapped;
 }
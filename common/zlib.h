@@ -128,8 +128,12 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
  *
  * It is safe to call this with a NULL parameter (in this case, NULL is
  * returned).
+ *
+ * @param toBeWrapped the stream to write the compressed data to.
+ * @param level       the zlib compression level, from 0 (no compression) to
+ *                    9 (best compression), or -1 for zlib's default (6).
  */
-WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped);
+WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped, int level = -1);
 
 } // End of namespace Common
 
@@ -0,0 +1,92 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * This is a utility for timing the inner loops of ScummVM's audio, video
+ * and graphics code, without needing a backend or any game data.
+ */
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+// HACK to allow building with the SDL backend on MinGW
+// see bug #1800764 "TOOLS: MinGW tools building broken"
+#ifdef main
+#undef main
+#endif // main
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/util.h"
+
+#include "benchmark.h"
+
+uint32 getMillis() {
+	return (uint32)((uint64)clock() * 1000 / CLOCKS_PER_SEC);
+}
+
+static const struct {
+	const char *name;
+	void (*run)();
+} benchmarks[] = {
+	{ "rate", runRateBenchmark },
+	{ "yuv", runYUVBenchmark },
+#ifdef USE_SCALERS
+	{ "scaler", runScalerBenchmark },
+#endif
+#ifdef USE_BINK
+	{ "bink", runBinkBenchmark },
+#endif
+#ifdef USE_ZLIB
+	{ "save", runSaveBenchmark },
+#endif
+#ifdef USE_FREETYPE2
+	{ "ttf", runTTFBenchmark },
+#endif
+};
+
+int main(int argc, char *argv[]) {
+	bool ran = false;
+
+	for (int i = 0; i < ARRAYSIZE(benchmarks); ++i) {
+		bool selected = (argc < 2);
+		for (int arg = 1; arg < argc; ++arg) {
+			if (!strcmp(argv[arg], benchmarks[i].name))
+				selected = true;
+		}
+
+		if (selected) {
+			printf("Running the %s benchmark...\n", benchmarks[i].name);
+			benchmarks[i].run();
+			ran = true;
+		}
+	}
+
+	if (!ran) {
+		printf("Usage: %s [benchmark...]\n\nAvailable benchmarks:", argv[0]);
+		for (int i = 0; i < ARRAYSIZE(benchmarks); ++i)
+			printf(" %s", benchmarks[i].name);
+		printf("\n");
+		return 1;
+	}
+
+	return 0;
+}
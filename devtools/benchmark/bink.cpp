@@ -0,0 +1,121 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+#include <string.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_BINK
+
+#include "common/util.h"
+
+#include "video/bink_dsp.h"
+
+#include "benchmark.h"
+
+void runBinkBenchmark() {
+	// Times the block functions of the Bink video decoder, and the vectorized
+	// ones against their generic versions, on the blocks of a 640x480 frame.
+
+	typedef void (*IDCTProc)(byte *dest, uint32 pitch, int16 *block);
+
+	static const struct {
+		const char *desc;
+		IDCTProc proc;
+		int scale;
+	} idcts[] = {
+		{ "IDCTPut", Video::binkIDCTPut, 1 },
+		{ "IDCTAdd", Video::binkIDCTAdd, 1 },
+		{ "IDCTPutScaled", Video::binkIDCTPutScaled, 2 },
+		{ "IDCTPutScaled generic", Video::binkIDCTPutScaledGeneric, 2 }
+	};
+
+	const int width = 640;
+	const int height = 480;
+	const int blocks = (width / 8) * (height / 8);
+	const int frameCount = 100;
+
+	// Sparse coefficients, like in typical intra and inter blocks
+	int16 *coeffs = new int16[blocks * 64];
+	memset(coeffs, 0, blocks * 64 * sizeof(int16));
+	uint32 seed = 1;
+	for (int i = 0; i < blocks * 64; ++i) {
+		seed = seed * 1103515245 + 12345;
+		if ((i & 63) == 0 || ((seed >> 16) & 7) == 0)
+			coeffs[i] = (int16)((seed >> 8) & 0x3FF) - 0x200;
+	}
+
+	byte *frame = new byte[width * 2 * height * 2];
+	byte *prev = new byte[width * 2 * height * 2];
+	memset(frame, 0, width * 2 * height * 2);
+	memset(prev, 0x80, width * 2 * height * 2);
+
+	int16 block[64];
+
+	for (int idct = 0; idct < ARRAYSIZE(idcts); ++idct) {
+		const int scale = idcts[idct].scale;
+		const uint32 pitch = width * scale;
+
+		const uint32 start = getMillis();
+		for (int n = 0; n < frameCount; ++n) {
+			for (int i = 0; i < blocks; ++i) {
+				const int x = (i % (width / 8)) * 8 * scale;
+				const int y = (i / (width / 8)) * 8 * scale;
+
+				// The functions may use the block as scratch space
+				memcpy(block, coeffs + i * 64, sizeof(block));
+				idcts[idct].proc(frame + y * pitch + x, pitch, block);
+			}
+		}
+		const uint32 elapsed = getMillis() - start;
+
+		printf("%-22s: %u ms for %d frames\n", idcts[idct].desc, elapsed, frameCount);
+	}
+
+	for (int generic = 0; generic < 2; ++generic) {
+		const uint32 start = getMillis();
+		for (int n = 0; n < frameCount; ++n) {
+			for (int i = 0; i < blocks; ++i) {
+				const int x = (i % (width / 8)) * 8;
+				const int y = (i / (width / 8)) * 8;
+
+				if (generic)
+					Video::binkCopyBlockGeneric(frame + y * width + x, width, prev + y * width + x, width, 8);
+				else
+					Video::binkCopyBlock(frame + y * width + x, width, prev + y * width + x, width, 8);
+			}
+		}
+		const uint32 elapsed = getMillis() - start;
+
+		printf("%-22s: %u ms for %d frames\n", generic ? "CopyBlock generic" : "CopyBlock", elapsed, frameCount);
+	}
+
+	delete[] coeffs;
+	delete[] frame;
+	delete[] prev;
+}
+
+#endif // USE_BINK
@@ -0,0 +1,36 @@
+
+MODULE := devtools/benchmark
+
+BENCHMARK_OBJS := \
+	devtools/benchmark/benchmark.o \
+	devtools/benchmark/bink.o \
+	devtools/benchmark/rate.o \
+	devtools/benchmark/save.o \
+	devtools/benchmark/scaler.o \
+	devtools/benchmark/ttf.o \
+	devtools/benchmark/yuv.o
+
+# Unlike the other tools, this one links against the engine-independent
+# ScummVM libraries, so it cannot use the TOOL_EXECUTABLE rule.
+BENCHMARK_LIBS := video/libvideo.a audio/libaudio.a graphics/libgraphics.a common/libcommon.a
+
+MODULE_DIRS += devtools/benchmark/
+
+# The TTF benchmark draws with a font shipped with the GUI themes.
+devtools/benchmark/ttf.o: CPPFLAGS += -DBENCHMARK_SRCDIR=\"$(srcdir)\"
+
+devtools/benchmark/benchmark$(EXEEXT): $(BENCHMARK_OBJS) $(BENCHMARK_LIBS)
+	$(QUIET_LINK)$(CXX) $(LDFLAGS) $+ -o $@ $(LIBS)
+
+# Builds and runs all benchmarks
+benchmark: devtools/benchmark/benchmark$(EXEEXT)
+	./devtools/benchmark/benchmark$(EXEEXT)
+
+# Add to "devtools" target
+devtools: devtools/benchmark/benchmark$(EXEEXT)
+
+clean-devtools: clean-devtools/benchmark
+clean-devtools/benchmark:
+	-$(RM) $(BENCHMARK_OBJS) devtools/benchmark/benchmark$(EXEEXT)
+
+.PHONY: benchmark clean-devtools/benchmark
@@ -0,0 +1,114 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/util.h"
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/decoders/raw.h"
+
+#include "benchmark.h"
+
+void runRateBenchmark() {
+	// Times every RateConverter variant mixing ten seconds worth of
+	// output from a noise source, in chunks like the mixer uses them. The
+	// throughput of the filtering converters helps picking a value for the
+	// resampler_quality setting.
+
+	static const struct {
+		const char *desc;
+		bool stereo;
+		bool reverseStereo;
+	} layouts[] = {
+		{ "mono", false, false },
+		{ "stereo", true, false },
+		{ "reverse stereo", true, true }
+	};
+
+	static const struct {
+		const char *desc;
+		Audio::st_rate_t inRate;
+		Audio::st_rate_t outRate;
+		Audio::RateConverterQuality quality;
+	} conversions[] = {
+		{ "copy", 44100, 44100, Audio::kRateQualityLow },
+		{ "simple", 44100, 22050, Audio::kRateQualityLow },
+		{ "linear", 22050, 44100, Audio::kRateQualityLow },
+		{ "linear", 11025, 48000, Audio::kRateQualityLow },
+		{ "sinc medium", 22050, 44100, Audio::kRateQualityMedium },
+		{ "sinc medium", 11025, 48000, Audio::kRateQualityMedium },
+		{ "sinc medium", 44100, 22050, Audio::kRateQualityMedium },
+		{ "sinc high", 22050, 44100, Audio::kRateQualityHigh },
+		{ "sinc high", 11025, 48000, Audio::kRateQualityHigh },
+		{ "sinc high", 44100, 22050, Audio::kRateQualityHigh },
+		{ "sinc high", 44100, 96000, Audio::kRateQualityHigh }
+	};
+
+	const uint32 chunkFrames = 2048;
+
+	Audio::st_sample_t *output = new Audio::st_sample_t[chunkFrames * 2];
+
+	for (int layout = 0; layout < ARRAYSIZE(layouts); ++layout) {
+		for (int conversion = 0; conversion < ARRAYSIZE(conversions); ++conversion) {
+			const bool stereo = layouts[layout].stereo;
+			const Audio::st_rate_t inRate = conversions[conversion].inRate;
+			const Audio::st_rate_t outRate = conversions[conversion].outRate;
+			const uint32 totalFrames = outRate * 10;
+			const uint32 samples = inRate * (stereo ? 2 : 1);
+
+			// One second of noise, looped forever
+			uint32 seed = 1;
+			int16 *noise = (int16 *)malloc(samples * 2);
+			for (uint32 i = 0; i < samples; ++i) {
+				seed = seed * 1103515245 + 12345;
+				noise[i] = (int16)(seed >> 8);
+			}
+
+			Audio::SeekableAudioStream *source = Audio::makeRawStream((const byte *)noise, samples * 2, inRate,
+			        Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (stereo ? Audio::FLAG_STEREO : 0));
+			Audio::AudioStream *stream = Audio::makeLoopingAudioStream(source, 0);
+			Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, layouts[layout].reverseStereo, conversions[conversion].quality);
+
+			memset(output, 0, chunkFrames * 4);
+
+			const uint32 start = getMillis();
+			for (uint32 frames = 0; frames < totalFrames; frames += chunkFrames)
+				converter->flow(*stream, output, chunkFrames, 200, 150);
+			const uint32 elapsed = getMillis() - start;
+
+			printf("%-14s %-11s %5u -> %5u Hz: %u ms for %u frames\n", layouts[layout].desc, conversions[conversion].desc,
+			       inRate, outRate, elapsed, totalFrames);
+
+			delete converter;
+			delete stream;
+		}
+	}
+
+	delete[] output;
+}
@@ -0,0 +1,76 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_ZLIB
+
+#include "common/memstream.h"
+#include "common/util.h"
+#include "common/zlib.h"
+
+#include "benchmark.h"
+
+void runSaveBenchmark() {
+	// Times the compression of a synthetic 4 MB savegame at several zlib
+	// levels, which helps picking a value for save_compression_level.
+
+	// Part structured state, part text, part noisy screen dump, like the
+	// savegames of most engines
+	const uint32 saveSize = 4 * 1024 * 1024;
+	byte *save = (byte *)malloc(saveSize);
+	uint32 seed = 1;
+	for (uint32 i = 0; i < saveSize; ++i) {
+		seed = seed * 1103515245 + 12345;
+		if (i < saveSize / 4)
+			save[i] = (i & 15) < 12 ? 0 : (i >> 6) & 0xFF;
+		else if (i < saveSize / 2)
+			save[i] = "The quick brown fox jumps over the lazy dog. "[(i + (seed >> 28)) % 45];
+		else
+			save[i] = (((i >> 3) ^ (i >> 13)) & 0xF0) | ((seed >> 16) & 0x03);
+	}
+
+	static const int levels[] = { 0, 1, 3, 6, 9 };
+	for (int level = 0; level < ARRAYSIZE(levels); ++level) {
+		Common::MemoryWriteStreamDynamic *out = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::WriteStream *compressor = Common::wrapCompressedWriteStream(out, levels[level]);
+
+		const uint32 start = getMillis();
+		compressor->write(save, saveSize);
+		compressor->finalize();
+		const uint32 elapsed = getMillis() - start;
+
+		printf("zlib level %d: %u ms for %u KB (%u KB compressed)\n", levels[level],
+		       elapsed, saveSize / 1024, out->size() / 1024);
+		delete compressor;
+	}
+
+	free(save);
+}
+
+#endif // USE_ZLIB
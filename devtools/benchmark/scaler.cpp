@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_SCALERS
+
+#include "common/util.h"
+
+#include "graphics/scaler.h"
+#include "graphics/surface.h"
+
+#include "benchmark.h"
+
+void runScalerBenchmark() {
+	// Times the graphics scalers on a 640x480 image, for both the
+	// 16 bit and the 32 bit pixel formats.
+
+	static const struct {
+		const char *desc;
+		ScalerProc *proc;
+	} scalers[] = {
+		{ "Normal2x", Normal2x },
+		{ "Normal3x", Normal3x },
+		{ "Normal1o5x", Normal1o5x },
+		{ "2xSaI", _2xSaI },
+		{ "Super2xSaI", Super2xSaI },
+		{ "SuperEagle", SuperEagle },
+		{ "AdvMame2x", AdvMame2x },
+		{ "AdvMame3x", AdvMame3x },
+		{ "TV2x", TV2x },
+		{ "DotMatrix", DotMatrix },
+#ifdef USE_HQ_SCALERS
+		{ "HQ2x", HQ2x },
+		{ "HQ3x", HQ3x },
+#endif
+	};
+
+	static const struct {
+		const char *desc;
+		Graphics::PixelFormat format;
+	} formats[] = {
+		{ "RGB565", Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0) },
+		{ "ARGB8888", Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24) }
+	};
+
+	const int width = 640;
+	const int height = 480;
+	const int frameCount = 20;
+
+	for (int format = 0; format < ARRAYSIZE(formats); ++format) {
+		const Graphics::PixelFormat &pixelFormat = formats[format].format;
+		// The scalers read one pixel around the area they scale
+		Graphics::Surface src, dst;
+		src.create(width + 2, height + 2, pixelFormat);
+		dst.create(width * 3, height * 3, pixelFormat);
+
+		// Blocks of a few colors with some noise, so that the smarter
+		// scalers have edges to work on
+		uint32 seed = 1;
+		for (int y = 0; y < src.h; ++y) {
+			for (int x = 0; x < src.w; ++x) {
+				seed = seed * 1103515245 + 12345;
+				int block = (x / 8 + y / 8) & 7;
+				if (((seed >> 16) & 15) == 0)
+					block = (seed >> 24) & 7;
+
+				const uint32 color = pixelFormat.RGBToColor(block * 36, 255 - block * 30, (block & 1) * 200);
+				if (pixelFormat.bytesPerPixel == 2)
+					*(uint16 *)src.getBasePtr(x, y) = color;
+				else
+					*(uint32 *)src.getBasePtr(x, y) = color;
+			}
+		}
+
+		InitScalers(pixelFormat);
+
+		for (int scaler = 0; scaler < ARRAYSIZE(scalers); ++scaler) {
+			const uint32 start = getMillis();
+			for (int frame = 0; frame < frameCount; ++frame)
+				scalers[scaler].proc((const uint8 *)src.getBasePtr(1, 1), src.pitch, (uint8 *)dst.getPixels(), dst.pitch, width, height);
+			const uint32 elapsed = getMillis() - start;
+
+			printf("%-8s %-10s: %u ms for %d frames\n", formats[format].desc, scalers[scaler].desc, elapsed, frameCount);
+		}
+
+		src.free();
+		dst.free();
+	}
+}
+
+#endif // USE_SCALERS
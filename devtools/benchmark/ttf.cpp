@@ -0,0 +1,127 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_FREETYPE2
+
+#include "common/memstream.h"
+#include "common/ustr.h"
+#include "common/util.h"
+
+#include "graphics/font.h"
+#include "graphics/surface.h"
+#include "graphics/fonts/ttf.h"
+
+#include "benchmark.h"
+
+void runTTFBenchmark() {
+	// Times drawing lines of text with the font of the GUI themes, at the
+	// sizes the themes use. The second text uses more glyphs than the font
+	// keeps, so that glyphs are evicted and rendered again all the time.
+
+	static const char *const fontFile = BENCHMARK_SRCDIR "/gui/themes/fonts/FreeSans.ttf";
+
+	FILE *file = fopen(fontFile, "rb");
+	if (!file) {
+		printf("Could not open %s\n", fontFile);
+		return;
+	}
+
+	Common::MemoryWriteStreamDynamic fontData(DisposeAfterUse::YES);
+	byte buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		fontData.write(buffer, read);
+	fclose(file);
+
+	Common::U32String latin;
+	const char *sentence = "The quick brown fox jumps over the lazy dog. AVATAR To Yves: 0123456789";
+	for (const char *c = sentence; *c; ++c)
+		latin += (uint32)(byte)*c;
+
+	// Latin Extended-A and B, Greek and Cyrillic, one line at a time
+	Common::U32String mixed;
+	for (uint32 chr = 0x0100; chr < 0x0500; ++chr)
+		mixed += chr;
+
+	static const struct {
+		const char *desc;
+		Graphics::PixelFormat format;
+	} formats[] = {
+		{ "RGB565", Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0) },
+		{ "ARGB8888", Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24) }
+	};
+
+	static const int pointSizes[] = { 12, 24 };
+
+	const int width = 640;
+	const int lineCount = 20000;
+
+	for (int size = 0; size < ARRAYSIZE(pointSizes); ++size) {
+		Common::MemoryReadStream stream(fontData.getData(), fontData.size());
+		Graphics::Font *font = Graphics::loadTTFFont(stream, pointSizes[size]);
+		if (!font) {
+			printf("Could not load %s\n", fontFile);
+			return;
+		}
+
+		const int lineHeight = font->getFontHeight();
+
+		for (int format = 0; format < ARRAYSIZE(formats); ++format) {
+			Graphics::Surface surface;
+			surface.create(width, lineHeight * 2, formats[format].format);
+			const uint32 color = surface.format.RGBToColor(0xFF, 0xFF, 0xFF);
+
+			uint32 start = getMillis();
+			for (int line = 0; line < lineCount; ++line)
+				font->drawString(&surface, latin, 0, 0, width, color);
+			uint32 elapsed = getMillis() - start;
+
+			printf("%2dpt %-8s Latin-1 text: %u ms for %d lines\n", pointSizes[size], formats[format].desc, elapsed, lineCount);
+
+			// Each line starts where the last one stopped, up to the width
+			// of the surface.
+			start = getMillis();
+			uint offset = 0;
+			for (int line = 0; line < lineCount / 10; ++line) {
+				const Common::U32String text(mixed.c_str() + offset, MIN<uint>(32, mixed.size() - offset));
+				font->drawString(&surface, text, 0, lineHeight, width, color);
+				offset = (offset + 32) % mixed.size();
+			}
+			elapsed = getMillis() - start;
+
+			printf("%2dpt %-8s mixed scripts: %u ms for %d lines\n", pointSizes[size], formats[format].desc, elapsed, lineCount / 10);
+
+			surface.free();
+		}
+
+		delete font;
+	}
+}
+
+#endif
@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+
+#include "common/util.h"
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "benchmark.h"
+
+void runYUVBenchmark() {
+	// Times the YUV to RGB conversion of the video decoders, for each
+	// chroma subsampling and destination depth, at the frame sizes of
+	// typical SD and HD cutscenes.
+
+	static const struct {
+		int width;
+		int height;
+	} sizes[] = {
+		{ 640, 480 },
+		{ 1280, 720 }
+	};
+
+	static const struct {
+		const char *desc;
+		Graphics::PixelFormat format;
+	} formats[] = {
+		{ "RGB565", Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0) },
+		{ "ARGB8888", Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24) }
+	};
+
+	const int frameCount = 100;
+
+	for (int size = 0; size < ARRAYSIZE(sizes); ++size) {
+		const int width = sizes[size].width;
+		const int height = sizes[size].height;
+
+		// The 410 conversion reads one row and column of chroma past the image
+		const int uvPitch = width + 1;
+		byte *yPlane = new byte[width * height];
+		byte *uPlane = new byte[uvPitch * (height + 1)];
+		byte *vPlane = new byte[uvPitch * (height + 1)];
+
+		uint32 seed = 1;
+		for (int i = 0; i < width * height; ++i) {
+			seed = seed * 1103515245 + 12345;
+			yPlane[i] = (byte)(seed >> 16);
+		}
+		for (int i = 0; i < uvPitch * (height + 1); ++i) {
+			seed = seed * 1103515245 + 12345;
+			uPlane[i] = (byte)(seed >> 16);
+			vPlane[i] = (byte)(seed >> 24);
+		}
+
+		for (int format = 0; format < ARRAYSIZE(formats); ++format) {
+			Graphics::Surface surface;
+			surface.create(width, height, formats[format].format);
+
+			for (int subsampling = 0; subsampling < 3; ++subsampling) {
+				const uint32 start = getMillis();
+				for (int frame = 0; frame < frameCount; ++frame) {
+					if (subsampling == 0)
+						YUVToRGBMan.convert444(&surface, Graphics::YUVToRGBManager::kScaleITU, yPlane, uPlane, vPlane, width, height, width, uvPitch);
+					else if (subsampling == 1)
+						YUVToRGBMan.convert420(&surface, Graphics::YUVToRGBManager::kScaleITU, yPlane, uPlane, vPlane, width, height, width, uvPitch);
+					else
+						YUVToRGBMan.convert410(&surface, Graphics::YUVToRGBManager::kScaleITU, yPlane, uPlane, vPlane, width, height, width, uvPitch);
+				}
+				const uint32 elapsed = getMillis() - start;
+
+				printf("%4dx%-4d %-8s YUV%s: %u ms for %d frames\n", width, height, formats[format].desc,
+				       subsampling == 0 ? "444" : (subsampling == 1 ? "420" : "410"), elapsed, frameCount);
+			}
+
+			surface.free();
+		}
+
+		delete[] yPlane;
+		delete[] uPlane;
+		delete[] vPlane;
+	}
+}
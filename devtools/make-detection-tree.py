@@ -0,0 +1,71 @@
+#!/usr/bin/env python
+# Creates a synthetic game library for benchmarking game detection, e.g.
+# with "scummvm --benchmark-detector=DIR".
+#
+# The file names are taken from the AdvancedDetector tables of the engines,
+# so every directory contains files the detectors will actually hash. The
+# files are zero-filled, so no games will be detected.
+#
+# Usage: make-detection-tree.py SCUMMVM_SOURCE_DIR OUTPUT_DIR [DIRS [FILES]]
+import os, random, re, sys
+
+# Matches ADGameFileDescription entries like {"resource.map", 0, "md5", 1234}
+# as well as the AD_ENTRY1s() shortcut.
+entryRegex = re.compile(r'\{\s*"([^"/\\]+)"\s*,\s*[^,{}]+,\s*(?:"[0-9a-f]{32}"|0|NULL)\s*,\s*(-?\d+)\s*\}')
+entry1sRegex = re.compile(r'AD_ENTRY1s?\(\s*"([^"/\\]+)"\s*,\s*(?:"[0-9a-f]{32}"|0|NULL)\s*(?:,\s*(-?\d+))?\s*\)')
+
+# SCI's fallback detector parses resource maps as soon as it finds one, and
+# does not cope with made-up ones.
+skipRegex = re.compile(r'^(data1|resource\.map|resmap\.\d+|ressci\.\d+|resource\.\d+)$')
+
+maxFileSize = 256 * 1024
+
+def collectFileNames(sourceDir):
+	names = {}
+	enginesDir = os.path.join(sourceDir, "engines")
+	for root, dirs, files in os.walk(enginesDir):
+		for name in files:
+			if not name.startswith("detection") or not (name.endswith(".h") or name.endswith(".cpp")):
+				continue
+			text = open(os.path.join(root, name)).read()
+			for regex in (entryRegex, entry1sRegex):
+				for match in regex.finditer(text):
+					name = match.group(1).lower()
+					if not skipRegex.match(name):
+						names[name] = int(match.group(2) or -1)
+	return names
+
+def main():
+	if len(sys.argv) < 3:
+		print("Usage: %s SCUMMVM_SOURCE_DIR OUTPUT_DIR [DIRS [FILES]]" % sys.argv[0])
+		sys.exit(1)
+
+	sourceDir = sys.argv[1]
+	outputDir = sys.argv[2]
+	dirCount = int(sys.argv[3]) if len(sys.argv) > 3 else 200
+	filesPerDir = int(sys.argv[4]) if len(sys.argv) > 4 else 40
+
+	names = collectFileNames(sourceDir)
+	if not names:
+		print("No detection entries found below '%s'" % sourceDir)
+		sys.exit(1)
+
+	random.seed(1)
+	nameList = sorted(names.keys())
+	for i in range(dirCount):
+		# Nest some directories to exercise the recursive scan as well.
+		gameDir = os.path.join(outputDir, "group%02d" % (i % 10), "game%04d" % i)
+		if not os.path.isdir(gameDir):
+			os.makedirs(gameDir)
+		for name in random.sample(nameList, min(filesPerDir, len(nameList))):
+			size = names[name]
+			if size < 0 or size > maxFileSize:
+				size = random.randint(1024, maxFileSize)
+			f = open(os.path.join(gameDir, name), "wb")
+			f.write(b"\0" * size)
+			f.close()
+
+	print("Created %d directories with %d files each from %d known file names" % (dirCount, filesPerDir, len(nameList)))
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,259 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/md5.h"
+#include "common/savefile.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "engines/detectioncache.h"
+
+namespace Common {
+DECLARE_SINGLETON(DetectionCache);
+}
+
+static const char *const kDetectionCacheFile = "detection.cache";
+static const uint32 kDetectionCacheTag = MKTAG('D', 'C', 'C', 'H');
+static const uint32 kDetectionCacheVersion = 1;
+
+static Common::String readString(Common::ReadStream &in) {
+	Common::String str;
+	const uint16 length = in.readUint16LE();
+	for (uint16 i = 0; i < length; ++i)
+		str += (char)in.readByte();
+	return str;
+}
+
+static void writeString(Common::WriteStream &out, const Common::String &str) {
+	out.writeUint16LE(str.size());
+	out.write(str.c_str(), str.size());
+}
+
+DetectionCache::DetectionCache() : _loaded(false), _dirty(false), _hits(0), _misses(0), _inPass(false) {
+}
+
+bool DetectionCache::isEnabled() const {
+	return ConfMan.getBool("detection_cache");
+}
+
+Common::String DetectionCache::makeKey(const Common::FSNode &node, uint md5Bytes) {
+	return Common::String::format("%u:", md5Bytes) + node.getPath();
+}
+
+void DetectionCache::beginPass() {
+	_inPass = true;
+}
+
+void DetectionCache::endPass() {
+	_inPass = false;
+	_passEntries.clear();
+	_passListings.clear();
+	flush();
+}
+
+bool DetectionCache::getFileProperties(const Common::FSNode &node, uint md5Bytes, int32 &size, Common::String &md5) {
+	const Common::String key = makeKey(node, md5Bytes);
+
+	if (_inPass) {
+		PassEntryMap::const_iterator i = _passEntries.find(key);
+		if (i != _passEntries.end()) {
+			size = i->_value.size;
+			md5 = i->_value.md5;
+			_hits++;
+			return true;
+		}
+	}
+
+	Common::File file;
+	if (!file.open(node))
+		return false;
+
+	size = (int32)file.size();
+	if (!lookup(node, key, size, md5)) {
+		md5 = Common::computeStreamMD5AsString(file, md5Bytes);
+		store(node, key, size, md5);
+	}
+
+	if (_inPass) {
+		PassEntry &entry = _passEntries[key];
+		entry.size = size;
+		entry.md5 = md5;
+	}
+	return true;
+}
+
+bool DetectionCache::getChildren(const Common::FSNode &dir, Common::FSList &list) {
+	if (!_inPass)
+		return dir.getChildren(list, Common::FSNode::kListAll);
+
+	ListingMap::const_iterator i = _passListings.find(dir.getPath());
+	if (i != _passListings.end()) {
+		list = i->_value;
+		return true;
+	}
+
+	if (!dir.getChildren(list, Common::FSNode::kListAll))
+		return false;
+
+	_passListings[dir.getPath()] = list;
+	return true;
+}
+
+bool DetectionCache::lookup(const Common::FSNode &node, const Common::String &key, int32 size, Common::String &md5) {
+	if (!isEnabled()) {
+		_misses++;
+		return false;
+	}
+
+	load();
+
+	const uint32 modificationTime = node.getModificationTime();
+	if (modificationTime == 0) {
+		_misses++;
+		return false;
+	}
+
+	EntryMap::iterator i = _entries.find(key);
+	if (i == _entries.end()) {
+		_misses++;
+		return false;
+	}
+
+	if (i->_value.size != size || i->_value.modificationTime != modificationTime) {
+		// The file changed since it was hashed.
+		_entries.erase(i);
+		_dirty = true;
+		_misses++;
+		return false;
+	}
+
+	i->_value.used = true;
+	md5 = i->_value.md5;
+	_hits++;
+	return true;
+}
+
+void DetectionCache::store(const Common::FSNode &node, const Common::String &key, int32 size, const Common::String &md5) {
+	if (!isEnabled())
+		return;
+
+	const uint32 modificationTime = node.getModificationTime();
+	if (modificationTime == 0)
+		return;
+
+	Entry &entry = _entries[key];
+	entry.size = size;
+	entry.modificationTime = modificationTime;
+	entry.md5 = md5;
+	entry.used = true;
+	_dirty = true;
+}
+
+void DetectionCache::clear() {
+	_entries.clear();
+	_loaded = true;
+	_dirty = true;
+	_hits = 0;
+	_misses = 0;
+}
+
+void DetectionCache::load() {
+	if (_loaded)
+		return;
+	_loaded = true;
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	Common::InSaveFile *in = saveFileMan->openForLoading(kDetectionCacheFile);
+	if (!in)
+		return;
+
+	if (in->readUint32BE() != kDetectionCacheTag || in->readUint32LE() != kDetectionCacheVersion) {
+		debug(2, "DetectionCache: Ignoring outdated or invalid cache file");
+		delete in;
+		return;
+	}
+
+	const uint32 count = in->readUint32LE();
+	for (uint32 i = 0; i < count && !in->eos() && !in->err(); ++i) {
+		const Common::String key = readString(*in);
+
+		Entry entry;
+		entry.size = in->readSint32LE();
+		entry.modificationTime = in->readUint32LE();
+		entry.md5 = readString(*in);
+		entry.used = false;
+
+		if (in->eos() || in->err())
+			break;
+
+		_entries[key] = entry;
+	}
+
+	debug(2, "DetectionCache: Loaded %u entries", _entries.size());
+	delete in;
+}
+
+void DetectionCache::flush() {
+	if (!_dirty)
+		return;
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	if (_entries.size() > kMaxEntries) {
+		for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+			if (!i->_value.used)
+				_entries.erase(i);
+		}
+	}
+
+	Common::OutSaveFile *out = saveFileMan->openForSaving(kDetectionCacheFile, false);
+	if (!out) {
+		warning("DetectionCache: Could not write '%s'", kDetectionCacheFile);
+		return;
+	}
+
+	out->writeUint32BE(kDetectionCacheTag);
+	out->writeUint32LE(kDetectionCacheVersion);
+	out->writeUint32LE(_entries.size());
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		writeString(*out, i->_key);
+		out->writeSint32LE(i->_value.size);
+		out->writeUint32LE(i->_value.modificationTime);
+		writeString(*out, i->_value.md5);
+	}
+
+	out->finalize();
+	if (out->err())
+		warning("DetectionCache: Could not write '%s'", kDetectionCacheFile);
+	else
+		_dirty = false;
+
+	delete out;
+}
@@ -0,0 +1,128 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef ENGINES_DETECTIONCACHE_H
+#define ENGINES_DETECTIONCACHE_H
+
+#include "common/fs.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+/**
+ * Cache of the file properties computed while detecting games.
+ *
+ * MD5 sums are cached persistently, keyed on the file path and the number
+ * of bytes hashed. They are only considered valid as long as the size and
+ * modification time of the file are unchanged. The cache is shared by all
+ * engines, loaded from the save path on first use and written back by
+ * flush(). Files whose modification time cannot be determined by the
+ * backend are never cached on disk.
+ *
+ * In addition, between beginPass() and endPass() the sizes, MD5 sums and
+ * directory listings requested by one detector are remembered in memory,
+ * so that the other detectors scanning the same directory do not have to
+ * touch the filesystem again.
+ */
+class DetectionCache : public Common::Singleton<DetectionCache> {
+public:
+	DetectionCache();
+
+	/**
+	 * Start a detection pass over one directory. Until endPass() is called,
+	 * the filesystem is assumed not to change.
+	 */
+	void beginPass();
+
+	/** End the current detection pass and flush() the cache. */
+	void endPass();
+
+	/**
+	 * Get the size of the given file and the MD5 sum of its first md5Bytes
+	 * bytes, from the cache if possible.
+	 *
+	 * @return false if the file could not be opened
+	 */
+	bool getFileProperties(const Common::FSNode &node, uint md5Bytes, int32 &size, Common::String &md5);
+
+	/**
+	 * List all children of the given directory, like FSNode::getChildren()
+	 * with FSNode::kListAll. Listings are reused within a detection pass.
+	 */
+	bool getChildren(const Common::FSNode &dir, Common::FSList &list);
+
+	/** Drop all entries, including the ones on disk at the next flush(). */
+	void clear();
+
+	/** Write the cache to disk, if it changed since it was loaded. */
+	void flush();
+
+	/** Number of MD5 sums answered from the cache since start-up. */
+	uint getHits() const { return _hits; }
+
+	/** Number of MD5 sums which had to be computed from the file. */
+	uint getMisses() const { return _misses; }
+
+private:
+	enum {
+		/** Once the cache grows beyond this, entries unused in this session are dropped. */
+		kMaxEntries = 32768
+	};
+
+	struct Entry {
+		int32 size;
+		uint32 modificationTime;
+		Common::String md5;
+		bool used;	///< Looked up or stored during this session; not persisted.
+	};
+
+	struct PassEntry {
+		int32 size;
+		Common::String md5;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+	typedef Common::HashMap<Common::String, PassEntry> PassEntryMap;
+	typedef Common::HashMap<Common::String, Common::FSList> ListingMap;
+
+	EntryMap _entries;
+	bool _loaded;
+	bool _dirty;
+	uint _hits;
+	uint _misses;
+
+	bool _inPass;
+	PassEntryMap _passEntries;
+	ListingMap _passListings;
+
+	bool isEnabled() const;
+	void load();
+	bool lookup(const Common::FSNode &node, const Common::String &key, int32 size, Common::String &md5);
+	void store(const Common::FSNode &node, const Common::String &key, int32 size, const Common::String &md5);
+	static Common::String makeKey(const Common::FSNode &node, uint md5Bytes);
+};
+
+/** Convenience shortcut for accessing the detection cache. */
+#define DetectionCacheMan DetectionCache::instance()
+
+#endif
@@ -535,6 +535,14 @@ void Engine::syncSoundSettings() {
 	if (!speechMute)
 		speechMute = ConfMan.getBool("speech_mute");
 
+	const Common::String &resamplerQuality = ConfMan.get("resampler_quality");
+	if (resamplerQuality == "high")
+		_mixer->setRateConverterQuality(Audio::kRateQualityHigh);
+	else if (resamplerQuality == "medium")
+		_mixer->setRateConverterQuality(Audio::kRateQualityMedium);
+	else
+		_mixer->setRateConverterQuality(Audio::kRateQualityLow);
+
 	_mixer->muteSoundType(Audio::Mixer::kPlainSoundType, mute);
 	_mixer->muteSoundType(Audio::Mixer::kMusicSoundType, mute);
 	_mixer->muteSoundType(Audio::Mixer::kSFXSoundType, mute);
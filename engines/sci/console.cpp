@@ -72,6 +72,10 @@ bool g_debug_track_mouse_clicks = false;
 // Refer to the "addresses" command on how to pass address parameters
 static int parse_reg_t(EngineState *s, const char *str, reg_t *dest, bool mayBeValue);
 
+#ifndef REDUCE_MEMORY_USAGE
+extern const char *opcodeNames[]; // from scriptdebug.cpp
+#endif
+
 Console::Console(SciEngine *engine) : GUI::Debugger(),
 	_engine(engine), _debugState(engine->_debugState) {
 
@@ -95,6 +99,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("opcodes",			WRAP_METHOD(Console, cmdOpcodes));
 	registerCmd("selector",			WRAP_METHOD(Console, cmdSelector));
 	registerCmd("selectors",			WRAP_METHOD(Console, cmdSelectors));
+	registerCmd("selector_cache",		WRAP_METHOD(Console, cmdSelectorCache));
 	registerCmd("functions",			WRAP_METHOD(Console, cmdKernelFunctions));
 	registerCmd("class_table",		WRAP_METHOD(Console, cmdClassTable));
 	// Parser
@@ -112,6 +117,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	registerCmd("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
@@ -150,6 +156,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("segkill",			WRAP_METHOD(Console, cmdKillSegment));			// alias
 	// Garbage collection
 	registerCmd("gc",					WRAP_METHOD(Console, cmdGCInvoke));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	registerCmd("gc_objects",			WRAP_METHOD(Console, cmdGCObjects));
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
@@ -209,6 +216,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("vm_profile",			WRAP_METHOD(Console, cmdVMProfile));
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -238,6 +246,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	_debugState.breakpointWasHit = false;
 	_debugState._breakpoints.clear(); // No breakpoints defined
 	_debugState._activeBreakpointTypes = 0;
+	_debugState.profiling = false;
+	_debugState.profile.reset();
 }
 
 Console::~Console() {
@@ -337,6 +347,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" opcodes - Lists the opcode names\n");
 	debugPrintf(" selectors - Lists the selector names\n");
 	debugPrintf(" selector - Attempts to find the requested selector by name\n");
+	debugPrintf(" selector_cache - Shows the hit rate of the selector lookup cache\n");
 	debugPrintf(" functions - Lists the kernel functions\n");
 	debugPrintf(" class_table - Shows the available classes\n");
 	debugPrintf("\n");
@@ -356,6 +367,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	debugPrintf(" resource_info - Shows info about a resource\n");
 	debugPrintf(" resource_types - Shows the valid resource types\n");
+	debugPrintf(" resource_cache - Shows statistics of the resource cache\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
@@ -391,6 +403,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("Garbage collection:\n");
 	debugPrintf(" gc - Invokes the garbage collector\n");
+	debugPrintf(" gc_stats - Shows pause times and other statistics of the garbage collector\n");
 	debugPrintf(" gc_objects - Lists all reachable objects, normalized\n");
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
@@ -436,6 +449,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" vm_profile - Counts the executed opcodes, kernel calls and selector sends\n");
 	debugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	debugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
 	debugPrintf(" stack - Lists the specified number of stack elements\n");
@@ -592,6 +606,27 @@ bool Console::cmdSelectors(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	SelectorLookupCache &cache = _engine->_gamestate->_segMan->getSelectorLookupCache();
+
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			cache.resetStats();
+			debugPrintf("Statistics reset\n");
+		} else {
+			debugPrintf("Shows the hit rate of the cache used to look up selectors in objects and their classes.\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	const uint32 lookups = cache._hits + cache._misses;
+	debugPrintf("Lookups: %d, hits: %d (%.1f%%), misses: %d\n", lookups, cache._hits,
+	            lookups ? cache._hits * 100.0 / lookups : 0.0, cache._misses);
+	debugPrintf("Flushes because of loaded or freed scripts: %d\n", cache._flushes);
+	return true;
+}
+
 bool Console::cmdKernelFunctions(int argc, const char **argv) {
 	debugPrintf("Kernel function names in numeric order:\n");
 	for (uint seeker = 0; seeker <  _engine->getKernel()->getKernelNamesSize(); seeker++) {
@@ -959,6 +994,34 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			_engine->getResMan()->resetCacheStats();
+			debugPrintf("Statistics reset\n");
+		} else if (!scumm_stricmp(argv[1], "size") && argc > 2) {
+			_engine->getResMan()->setMaxMemoryLRU(atoi(argv[2]) * 1024);
+		} else {
+			debugPrintf("Shows hits, misses, evictions and prefetches of the resource cache per resource type.\n");
+			debugPrintf("Usage: %s [reset | size <KB>]\n", argv[0]);
+			debugPrintf("'reset' clears the statistics, 'size' changes the memory budget for unlocked resources.\n");
+			return true;
+		}
+	}
+
+	ResourceManager *resMan = _engine->getResMan();
+	debugPrintf("Unlocked: %d of %d bytes, locked: %d bytes\n", resMan->getMemoryLRU(), resMan->getMaxMemoryLRU(), resMan->getMemoryLocked());
+	debugPrintf("%-10s %8s %8s %9s %10s\n", "Type", "Hits", "Misses", "Evictions", "Prefetches");
+
+	for (int i = 0; i < kResourceTypeInvalid; i++) {
+		const ResourceManager::CacheStats &stats = resMan->getCacheStats((ResourceType)i);
+		if (stats.hits || stats.misses || stats.prefetches)
+			debugPrintf("%-10s %8d %8d %9d %10d\n", getResourceTypeName((ResourceType)i), stats.hits, stats.misses, stats.evictions, stats.prefetches);
+	}
+
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		debugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -2357,6 +2420,30 @@ bool Console::cmdIsSample(int argc, const char **argv) {
 bool Console::cmdGCInvoke(int argc, const char **argv) {
 	debugPrintf("Performing garbage collection...\n");
 	run_gc(_engine->_gamestate);
+	debugPrintf("Took %d ms\n", _engine->_gamestate->_gcStats.lastPause);
+	return true;
+}
+
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GCStatistics &stats = _engine->_gamestate->_gcStats;
+
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			stats.reset();
+			debugPrintf("Statistics reset\n");
+		} else {
+			debugPrintf("Shows the number of collections, freed objects and pause times of the garbage collector.\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	const uint32 collections = stats.fullCollections + stats.partialCollections;
+	debugPrintf("Collections: %d full, %d partial, %d skipped\n", stats.fullCollections, stats.partialCollections, stats.skippedCollections);
+	debugPrintf("Swept segments: %d, freed objects: %d\n", stats.sweptSegments, stats.freedObjects);
+	debugPrintf("References found by the last collection: %d\n", stats.lastReferences);
+	debugPrintf("Pause: %d ms last, %d ms max, %d ms average\n", stats.lastPause, stats.maxPause, collections ? stats.totalPause / collections : 0);
+	debugPrintf("Periodic collections until the next full one: %d\n", _engine->_gamestate->gcFullCountDown + 1);
 	return true;
 }
 
@@ -2833,6 +2920,80 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+struct ProfileEntry {
+	uint32 count;
+	uint index;
+
+	bool operator<(const ProfileEntry &other) const { return count > other.count; }
+};
+
+void Console::printProfileCounts(const char *title, const uint32 *counts, uint size, const Common::StringArray &names, uint maxEntries) {
+	Common::Array<ProfileEntry> entries;
+	uint32 total = 0;
+	for (uint i = 0; i < size; i++) {
+		if (counts[i]) {
+			ProfileEntry entry = { counts[i], i };
+			entries.push_back(entry);
+			total += counts[i];
+		}
+	}
+	Common::sort(entries.begin(), entries.end());
+
+	debugPrintf("%s: %d in total\n", title, total);
+	for (uint i = 0; i < entries.size() && i < maxEntries; i++) {
+		const uint index = entries[i].index;
+		const Common::String name = (index < names.size()) ? names[index] : Common::String::format("0x%x", index);
+		debugPrintf(" %-24s %10d %5.1f%%\n", name.c_str(), entries[i].count, entries[i].count * 100.0 / total);
+	}
+}
+
+bool Console::cmdVMProfile(int argc, const char **argv) {
+	VMProfile &profile = _debugState.profile;
+	uint maxEntries = 20;
+
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "on")) {
+			_debugState.profiling = true;
+			debugPrintf("Profiling enabled\n");
+			return true;
+		} else if (!scumm_stricmp(argv[1], "off")) {
+			_debugState.profiling = false;
+			debugPrintf("Profiling disabled\n");
+			return true;
+		} else if (!scumm_stricmp(argv[1], "reset")) {
+			profile.reset();
+			debugPrintf("Statistics reset\n");
+			return true;
+		} else if (!scumm_stricmp(argv[1], "all")) {
+			maxEntries = 0xFFFFFFFF;
+		} else {
+			debugPrintf("Counts the executed opcodes, kernel calls and selector sends, to find hot spots in game scripts.\n");
+			debugPrintf("Usage: %s [on | off | reset | all]\n", argv[0]);
+			debugPrintf("Without parameters, the 20 most frequent entries of each kind are shown, 'all' shows all of them.\n");
+			return true;
+		}
+	}
+
+	if (!_debugState.profiling)
+		debugPrintf("Profiling is disabled, use '%s on' to enable it\n", argv[0]);
+
+	Kernel *kernel = _engine->getKernel();
+	Common::StringArray opcodes, kernelCalls, selectors;
+#ifndef REDUCE_MEMORY_USAGE
+	for (uint i = 0; i < ARRAYSIZE(profile.opcodes); i++)
+		opcodes.push_back(opcodeNames[i]);
+#endif
+	for (uint i = 0; i < kernel->getKernelNamesSize(); i++)
+		kernelCalls.push_back(kernel->getKernelName(i));
+	for (uint i = 0; i < kernel->getSelectorNamesSize(); i++)
+		selectors.push_back(kernel->getSelectorName(i));
+
+	printProfileCounts("Opcodes", profile.opcodes, ARRAYSIZE(profile.opcodes), opcodes, maxEntries);
+	printProfileCounts("Kernel calls", profile.kernelCalls.begin(), profile.kernelCalls.size(), kernelCalls, maxEntries);
+	printProfileCounts("Selector sends", profile.selectorSends.begin(), profile.selectorSends.size(), selectors, maxEntries);
+	return true;
+}
+
 bool Console::cmdScriptObjects(int argc, const char **argv) {
 	int curScriptNr = -1;
 
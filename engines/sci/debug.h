@@ -23,6 +23,7 @@
 #ifndef SCI_DEBUG_H
 #define SCI_DEBUG_H
 
+#include "common/array.h"
 #include "common/list.h"
 #include "sci/engine/vm_types.h"	// for StackPtr
 
@@ -60,6 +61,34 @@ enum DebugSeeking {
 	kDebugSeekStepOver = 5      // Step forward until we reach same stack-level again
 };
 
+/**
+ * Execution counts gathered by the VM while profiling is enabled with the
+ * "vm_profile" console command
+ */
+struct VMProfile {
+	uint32 opcodes[128]; ///< Executed instructions per opcode
+	Common::Array<uint32> kernelCalls; ///< Calls per kernel function number
+	Common::Array<uint32> selectorSends; ///< Sends per selector
+
+	void reset() {
+		memset(opcodes, 0, sizeof(opcodes));
+		kernelCalls.clear();
+		selectorSends.clear();
+	}
+
+	void countKernelCall(uint number) {
+		if (number >= kernelCalls.size())
+			kernelCalls.resize(number + 1);
+		kernelCalls[number]++;
+	}
+
+	void countSelectorSend(uint selector) {
+		if (selector >= selectorSends.size())
+			selectorSends.resize(selector + 1);
+		selectorSends[selector]++;
+	}
+};
+
 struct DebugState {
 	bool debugging;
 	bool breakpointWasHit;
@@ -72,6 +101,8 @@ struct DebugState {
 	StackPtr old_sp;
 	Common::List<Breakpoint> _breakpoints;   //< List of breakpoints
 	int _activeBreakpointTypes;  //< Bit mask specifying which types of breakpoints are active
+	bool profiling;              //< Set to count executed opcodes, kernel calls and sends in profile
+	VMProfile profile;
 };
 
 // Various global variables used for debugging are declared here
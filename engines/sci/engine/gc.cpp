@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 namespace Sci {
@@ -64,7 +65,7 @@ void WorklistManager::pushArray(const Common::Array<reg_t> &tmp) {
 		push(*it);
 }
 
-static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_map) {
+static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_map, const Common::Array<bool> *sweptSegments = NULL) {
 	AddrSet *normal_map = new AddrSet();
 
 	for (AddrSet::const_iterator i = nonnormal_map.begin(); i != nonnormal_map.end(); ++i) {
@@ -73,6 +74,11 @@ static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_
 
 		if (mobj) {
 			reg = mobj->findCanonicAddress(segMan, reg);
+
+			// The canonic address may be in another segment, e.g. for locals
+			if (sweptSegments && (reg.getSegment() >= sweptSegments->size() || !(*sweptSegments)[reg.getSegment()]))
+				continue;
+
 			normal_map->setVal(reg, true);
 		}
 	}
@@ -95,11 +101,9 @@ static void processWorkList(SegManager *segMan, WorklistManager &wm, const Commo
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+static void markActiveReferences(EngineState *s, WorklistManager &wm) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -156,15 +160,42 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 	if (g_sci->_gfxPorts)
 		g_sci->_gfxPorts->processEngineHunkList(wm);
+}
 
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+	markActiveReferences(s, wm);
 	return normalizeAddresses(s->_segMan, wm._map);
 }
 
-void run_gc(EngineState *s) {
+void run_gc(EngineState *s, bool full) {
 	SegManager *segMan = s->_segMan;
+	GCStatistics &stats = s->_gcStats;
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+
+	// Every few periodic collections, sweep all segments
+	if (!full && s->gcFullCountDown-- <= 0)
+		full = true;
+	if (full)
+		s->gcFullCountDown = GC_FULL_INTERVAL - 1;
+
+	// Decide which segments to sweep before anything gets freed
+	Common::Array<bool> sweptSegments;
+	sweptSegments.resize(heap.size());
+	bool needsSweep = false;
+	for (uint seg = 0; seg < heap.size(); seg++) {
+		sweptSegments[seg] = seg > 0 && heap[seg] && (full || heap[seg]->needsSweep());
+		needsSweep |= sweptSegments[seg];
+	}
+
+	if (!needsSweep) {
+		debugC(kDebugLevelGC, "[GC] Nothing allocated since the last run, skipping");
+		stats.skippedCollections++;
+		return;
+	}
 
 	// Some debug stuff
-	debugC(kDebugLevelGC, "[GC] Running...");
+	debugC(kDebugLevelGC, "[GC] Running %s...", full ? "full collection" : "partial collection");
 #ifdef GC_DEBUG_CODE
 	const char *segnames[SEG_TYPE_MAX + 1];
 	int segcount[SEG_TYPE_MAX + 1];
@@ -172,20 +203,25 @@ void run_gc(EngineState *s) {
 	memset(segcount, 0, sizeof(segcount));
 #endif
 
-	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
+	const uint32 startTime = g_system->getMillis();
+
+	// Compute the set of all segments references currently in use. Partial
+	// collections only need the ones into the segments they sweep.
+	WorklistManager wm;
+	markActiveReferences(s, wm);
+	AddrSet *activeRefs = normalizeAddresses(segMan, wm._map, full ? NULL : &sweptSegments);
 
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
-	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
 	for (uint seg = 1; seg < heap.size(); seg++) {
 		SegmentObj *mobj = heap[seg];
 
-		if (mobj != NULL) {
+		if (mobj != NULL && sweptSegments[seg]) {
 #ifdef GC_DEBUG_CODE
 			const SegmentType type = mobj->getType();
 			segnames[type] = segmentTypeNames[type];
 #endif
+			stats.sweptSegments++;
 
 			// Get a list of all deallocatable objects in this segment,
 			// then free any which are not referenced from somewhere.
@@ -196,17 +232,31 @@ void run_gc(EngineState *s) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+					stats.freedObjects++;
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
 #endif
 				}
 			}
 
+			// Freeing a script deletes its segment
+			if (heap[seg])
+				heap[seg]->setNeedsSweep(false);
 		}
 	}
 
 	delete activeRefs;
 
+	const uint32 pause = g_system->getMillis() - startTime;
+	if (full)
+		stats.fullCollections++;
+	else
+		stats.partialCollections++;
+	stats.lastReferences = wm._map.size();
+	stats.lastPause = pause;
+	stats.maxPause = MAX(stats.maxPause, pause);
+	stats.totalPause += pause;
+
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
@@ -51,9 +51,16 @@ AddrSet *findAllActiveReferences(EngineState *s);
 
 /**
  * Runs garbage collection on the current system state
- * @param s The state in which we should gc
+ *
+ * A partial collection only sweeps the segments with allocations since they
+ * were last swept, and is skipped entirely if there are none. Every
+ * GC_FULL_INTERVAL-th partial collection is turned into a full one, so
+ * that the remaining unreachable objects are freed eventually.
+ *
+ * @param s    The state in which we should gc
+ * @param full Whether to sweep all segments
  */
-void run_gc(EngineState *s);
+void run_gc(EngineState *s, bool full = true);
 
 struct WorklistManager {
 	Common::Array<reg_t> _worklist;
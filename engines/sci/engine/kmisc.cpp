@@ -25,6 +25,7 @@
 #include "sci/sci.h"
 #include "sci/debug.h"
 #include "sci/event.h"
+#include "sci/resource.h"
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/gc.h"
@@ -191,6 +192,11 @@ reg_t kMemorySegment(EngineState *s, int argc, reg_t *argv) {
 reg_t kFlushResources(EngineState *s, int argc, reg_t *argv) {
 	run_gc(s);
 	debugC(kDebugLevelRoom, "Entering room number %d", argv[0].toUint16());
+
+	// In SCI2+, this is kPurge, which gets an amount of memory instead
+	if (getSciVersion() < SCI_VERSION_2)
+		g_sci->getResMan()->prefetchRoom(argv[0].toUint16());
+
 	return s->r_acc;
 }
 
@@ -70,6 +70,30 @@ void Script::freeScript() {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	_instructionIndex.clear();
+	_instructions.clear();
+}
+
+const PMachineInstruction &Script::getInstruction(uint32 offset) {
+	// Code is only found in the script resource, not in the heap
+	if (offset >= _scriptSize) {
+		_uncachedInstruction.size = readPMachineInstruction(_buf + offset, _uncachedInstruction.extOpcode, _uncachedInstruction.opparams);
+		return _uncachedInstruction;
+	}
+
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(_scriptSize);
+
+	uint32 &index = _instructionIndex[offset];
+	if (!index) {
+		PMachineInstruction instruction;
+		instruction.size = readPMachineInstruction(_buf + offset, instruction.extOpcode, instruction.opparams);
+		_instructions.push_back(instruction);
+		index = _instructions.size();
+	}
+
+	return _instructions[index - 1];
 }
 
 void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptPatcher) {
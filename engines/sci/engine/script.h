@@ -90,6 +90,15 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/**
+	 * Instructions decoded by getInstruction(). For every offset in the
+	 * script, _instructionIndex holds 1 + the index of the instruction
+	 * starting there, or 0 if it hasn't been executed yet.
+	 */
+	Common::Array<uint32> _instructionIndex;
+	Common::Array<PMachineInstruction> _instructions;
+	PMachineInstruction _uncachedInstruction;
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -115,6 +124,13 @@ public:
 	const ObjMap &getObjectMap() const { return _objects; }
 	bool offsetIsObject(uint16 offset) const;
 
+	/**
+	 * Returns the instruction at the given offset. Instructions are only
+	 * decoded the first time they are executed. The returned reference is
+	 * invalidated by the next call.
+	 */
+	const PMachineInstruction &getInstruction(uint32 offset);
+
 public:
 	Script();
 	~Script();
@@ -232,6 +248,7 @@ public:
 	 */
 	void markDeleted() {
 		_markedAsDeleted = true;
+		setNeedsSweep(true);
 	}
 
 	/**
@@ -78,16 +78,26 @@ enum SegmentType {
 
 struct SegmentObj : public Common::Serializable {
 	SegmentType _type;
+	bool _needsSweep; /**< Something may have become deallocatable since the last gc sweep */
 
 public:
 	static SegmentObj *createSegmentObj(SegmentType type);
 
 public:
-	SegmentObj(SegmentType type) : _type(type) {}
+	SegmentObj(SegmentType type) : _type(type), _needsSweep(true) {}
 	virtual ~SegmentObj() {}
 
 	inline SegmentType getType() const { return _type; }
 
+	/**
+	 * Whether a partial garbage collection has to check this segment. This
+	 * is the case after allocations, until the next collection. Without
+	 * allocations, the unreachable objects of a segment can not use up any
+	 * more memory, so they are left for the next full collection.
+	 */
+	inline bool needsSweep() const { return _needsSweep; }
+	inline void setNeedsSweep(bool needsSweep) { _needsSweep = needsSweep; }
+
 	/**
 	 * Check whether the given offset into this memory object is valid,
 	 * i.e., suitable for passing to dereference.
@@ -234,6 +244,7 @@ public:
 
 	int allocEntry() {
 		entries_used++;
+		_needsSweep = true;
 		if (first_free != HEAPENTRY_INVALID) {
 			int oldff = first_free;
 			first_free = _table[oldff].next_free;
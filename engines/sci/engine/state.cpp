@@ -25,6 +25,7 @@
 #include "sci/sci.h"	// for INCLUDE_OLDGFX
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/event.h"
+#include "sci/resource.h"
 
 #include "sci/engine/file.h"
 #include "sci/engine/kernel.h"
@@ -108,6 +109,7 @@ void EngineState::reset(bool isRestoring) {
 	lastWaitTime = 0;
 
 	gcCountDown = 0;
+	gcFullCountDown = GC_FULL_INTERVAL - 1;
 
 	_throttleCounter = 0;
 	_throttleLastTime = 0;
@@ -139,7 +141,11 @@ void EngineState::speedThrottler(uint32 neededSleep) {
 		uint32 duration = curTime - _throttleLastTime;
 
 		if (duration < neededSleep) {
-			g_sci->sleep(neededSleep - duration);
+			// Use the time until the next frame to load resources ahead
+			g_sci->getResMan()->processPrefetchQueue(_throttleLastTime + neededSleep);
+			duration = g_system->getMillis() - _throttleLastTime;
+			if (duration < neededSleep)
+				g_sci->sleep(neededSleep - duration);
 			_throttleLastTime = g_system->getMillis();
 		} else {
 			_throttleLastTime = curTime;
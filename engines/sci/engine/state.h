@@ -95,6 +95,27 @@ struct VideoState {
 	}
 };
 
+/** Garbage collector statistics, shown by the gc_stats console command */
+struct GCStatistics {
+	uint32 fullCollections; /**< Collections which swept every segment */
+	uint32 partialCollections; /**< Collections which only swept segments with new allocations */
+	uint32 skippedCollections; /**< Partial collections skipped because there were no allocations */
+	uint32 sweptSegments;
+	uint32 freedObjects;
+	uint32 lastReferences; /**< Number of references found by the last collection */
+	uint32 lastPause; /**< Duration of the last collection, in milliseconds */
+	uint32 maxPause;
+	uint32 totalPause;
+
+	GCStatistics() { reset(); }
+
+	void reset() {
+		fullCollections = partialCollections = skippedCollections = 0;
+		sweptSegments = freedObjects = 0;
+		lastReferences = lastPause = maxPause = totalPause = 0;
+	}
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -188,6 +209,8 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	int gcFullCountDown; /**< Number of periodic gcs until the next full one */
+	GCStatistics _gcStats;
 
 	MessageState *_msgState;
 
@@ -137,6 +137,11 @@ enum {
 	GC_INTERVAL = 0x8000
 };
 
+/** Number of periodic gcs in between gcs that sweep every segment */
+enum {
+	GC_FULL_INTERVAL = 8
+};
+
 enum SciOpcodes {
 	op_bnot     = 0x00,	// 000
 	op_add      = 0x01,	// 001
@@ -325,6 +330,52 @@ void run_vm(EngineState *s);
  */
 void script_debug(EngineState *s);
 
+/**
+ * Direct mapped cache of the results of lookupSelector(). Entries are keyed
+ * on the position of the object in its script and the selector, so clones
+ * share the entries of the object they have been cloned from. As entries
+ * point into scripts, the cache must be cleared whenever a script gets
+ * loaded or freed.
+ */
+class SelectorLookupCache {
+public:
+	struct Entry {
+		reg_t object; ///< Position of the object, NULL_REG for unused entries
+		Selector selector;
+		SelectorType type;
+		int varIndex; ///< Index of the variable, for kSelectorVariable
+		reg_t function; ///< Address of the method, for kSelectorMethod
+	};
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _flushes; ///< Number of times the cache was cleared
+
+	SelectorLookupCache() { clear(); resetStats(); }
+
+	Entry &getEntry(reg_t object, Selector selector) {
+		return _entries[(object.getSegment() * 61 + object.getOffset() * 7 + selector) & (kSize - 1)];
+	}
+
+	void clear() {
+		for (uint i = 0; i < kSize; i++)
+			_entries[i].object = NULL_REG;
+	}
+
+	/** Clears the cache after a script has been loaded or freed */
+	void flush() {
+		clear();
+		_flushes++;
+	}
+
+	void resetStats() { _hits = _misses = _flushes = 0; }
+
+private:
+	enum { kSize = 2048 };
+
+	Entry _entries[kSize];
+};
+
 /**
  * Looks up a selector and returns its type and value
  * varindex is written to iff it is non-NULL and the selector indicates a property of the object.
@@ -348,6 +399,15 @@ void script_debug(EngineState *s);
 SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
 		ObjVarRef *varp, reg_t *fptr);
 
+/**
+ * A PMachine instruction, as decoded by readPMachineInstruction().
+ */
+struct PMachineInstruction {
+	int16 opparams[4];
+	uint16 size; /**< Length of the instruction in bytes */
+	byte extOpcode;
+};
+
 /**
  * Read a PMachine instruction from a memory buffer and return its length.
  *
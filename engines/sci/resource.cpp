@@ -22,9 +22,11 @@
 
 // Resource library
 
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 
 #include "sci/resource.h"
@@ -191,6 +193,8 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : _resMan(resMan), _i
 	_fileOffset = 0;
 	_status = kResStatusNoMalloc;
 	_lockers = 0;
+	_lruPrev = NULL;
+	_lruNext = NULL;
 	_source = NULL;
 	_header = NULL;
 	_headerSize = 0;
@@ -861,9 +865,7 @@ ResourceManager::ResourceManager() {
 }
 
 void ResourceManager::init() {
-	_memoryLocked = 0;
-	_memoryLRU = 0;
-	_LRU.clear();
+	resetLRU();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 
@@ -914,6 +916,15 @@ void ResourceManager::init() {
 
 	debugC(1, kDebugLevelResMan, "resMan: Detected %s", getSciVersionDesc(getSciVersion()));
 
+	// SCI32 views and pictures are so large that the SCI0 budget would have
+	// them decompressed over and over again
+	uint32 maxMemory = (getSciVersion() >= SCI_VERSION_2) ? MAX_MEMORY_SCI32 : MAX_MEMORY;
+	if (ConfMan.hasKey("resource_cache_size"))
+		maxMemory = ConfMan.getInt("resource_cache_size") * 1024;
+	setMaxMemoryLRU(maxMemory);
+
+	_prefetchEnabled = ConfMan.hasKey("prefetch_resources") && ConfMan.getBool("prefetch_resources");
+
 	switch (_viewType) {
 	case kViewEga:
 		debugC(1, kDebugLevelResMan, "resMan: Detected EGA graphic resources");
@@ -947,9 +958,7 @@ void ResourceManager::init() {
 void ResourceManager::initForDetection() {
 	assert(!g_sci);
 
-	_memoryLocked = 0;
-	_memoryLRU = 0;
-	_LRU.clear();
+	resetLRU();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 
@@ -976,12 +985,63 @@ ResourceManager::~ResourceManager() {
 	}
 }
 
+void ResourceManager::resetLRU() {
+	_memoryLocked = 0;
+	_memoryLRU = 0;
+	_maxMemoryLRU = MAX_MEMORY;
+	for (int i = 0; i < kLRUPriorityCount; i++)
+		_LRU[i].head = _LRU[i].tail = NULL;
+	resetCacheStats();
+	_prefetchEnabled = false;
+	_prefetchQueue.clear();
+}
+
+void ResourceManager::resetCacheStats() {
+	memset(_cacheStats, 0, sizeof(_cacheStats));
+}
+
+ResourceManager::LRUPriority ResourceManager::getLRUPriority(ResourceType type) {
+	switch (type) {
+	case kResourceTypeAudio:
+	case kResourceTypeAudio36:
+	case kResourceTypeSync:
+	case kResourceTypeSync36:
+	case kResourceTypeRave:
+	case kResourceTypeCdAudio:
+	case kResourceTypeRobot:
+	case kResourceTypeVMD:
+	case kResourceTypeDuck:
+	case kResourceTypeChunk:
+		return kLRUPriorityLow;
+	case kResourceTypeView:
+	case kResourceTypePic:
+	case kResourceTypePalette:
+	case kResourceTypeFont:
+	case kResourceTypeCursor:
+	case kResourceTypeClut:
+		return kLRUPriorityHigh;
+	default:
+		return kLRUPriorityNormal;
+	}
+}
+
 void ResourceManager::removeFromLRU(Resource *res) {
 	if (res->_status != kResStatusEnqueued) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
+
+	LRUList &lru = _LRU[getLRUPriority(res->getType())];
+	if (res->_lruPrev)
+		res->_lruPrev->_lruNext = res->_lruNext;
+	else
+		lru.head = res->_lruNext;
+	if (res->_lruNext)
+		res->_lruNext->_lruPrev = res->_lruPrev;
+	else
+		lru.tail = res->_lruPrev;
+	res->_lruPrev = res->_lruNext = NULL;
+
 	_memoryLRU -= res->size;
 	res->_status = kResStatusAllocated;
 }
@@ -991,7 +1051,16 @@ void ResourceManager::addToLRU(Resource *res) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
+
+	LRUList &lru = _LRU[getLRUPriority(res->getType())];
+	res->_lruPrev = NULL;
+	res->_lruNext = lru.head;
+	if (lru.head)
+		lru.head->_lruPrev = res;
+	else
+		lru.tail = res;
+	lru.head = res;
+
 	_memoryLRU += res->size;
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s.%03d (%d bytes) to lru control: %d bytes total",
@@ -1004,32 +1073,78 @@ void ResourceManager::addToLRU(Resource *res) {
 void ResourceManager::printLRU() {
 	int mem = 0;
 	int entries = 0;
-	Common::List<Resource *>::iterator it = _LRU.begin();
-	Resource *res;
-
-	while (it != _LRU.end()) {
-		res = *it;
-		debug("\t%s: %d bytes", res->_id.toString().c_str(), res->size);
-		mem += res->size;
-		++entries;
-		++it;
+
+	for (int priority = kLRUPriorityHigh; priority >= kLRUPriorityLow; priority--) {
+		for (Resource *res = _LRU[priority].head; res; res = res->_lruNext) {
+			debug("\t%s: %d bytes (priority %d)", res->_id.toString().c_str(), res->size, priority);
+			mem += res->size;
+			++entries;
+		}
 	}
 
 	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
 }
 
+void ResourceManager::setMaxMemoryLRU(uint32 bytes) {
+	_maxMemoryLRU = bytes;
+	freeOldResources();
+}
+
 void ResourceManager::freeOldResources() {
-	while (MAX_MEMORY < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = *_LRU.reverse_begin();
+	int priority = kLRUPriorityLow;
+
+	while (_maxMemoryLRU < (uint32)_memoryLRU) {
+		// Free the least recently used resource of the lowest priority
+		while (!_LRU[priority].tail) {
+			priority++;
+			assert(priority < kLRUPriorityCount);
+		}
+
+		Resource *goner = _LRU[priority].tail;
 		removeFromLRU(goner);
 		goner->unalloc();
+		_cacheStats[goner->getType()].evictions++;
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s.%03d (%d bytes)", getResourceTypeName(goner->type), goner->number, goner->size);
 #endif
 	}
 }
 
+void ResourceManager::prefetchRoom(uint16 roomNumber) {
+	if (!_prefetchEnabled)
+		return;
+
+	// Rooms usually share their number with their script, picture and
+	// messages. Views can't be predicted without running the room script.
+	static const ResourceType roomTypes[] = {
+		kResourceTypeScript, kResourceTypeHeap, kResourceTypePic, kResourceTypeMessage, kResourceTypeText
+	};
+
+	for (int i = 0; i < ARRAYSIZE(roomTypes); i++) {
+		ResourceId id(roomTypes[i], roomNumber);
+		if (testResource(id))
+			_prefetchQueue.push_back(id);
+	}
+}
+
+void ResourceManager::processPrefetchQueue(uint32 deadline) {
+	while (!_prefetchQueue.empty() && (uint32)_memoryLRU < _maxMemoryLRU && (int32)(deadline - g_system->getMillis()) > 0) {
+		Resource *res = testResource(_prefetchQueue.front());
+		_prefetchQueue.pop_front();
+
+		if (!res || res->_status != kResStatusNoMalloc)
+			continue;
+
+		loadResource(res);
+		if (res->_status != kResStatusAllocated)
+			continue;
+
+		_cacheStats[res->getType()].prefetches++;
+		addToLRU(res);
+		freeOldResources();
+	}
+}
+
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
 	Common::List<ResourceId> resources;
 
@@ -1049,10 +1164,14 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_status == kResStatusNoMalloc) {
+		_cacheStats[retval->getType()].misses++;
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		removeFromLRU(retval);
+	} else {
+		_cacheStats[retval->getType()].hits++;
+		if (retval->_status == kResStatusEnqueued)
+			removeFromLRU(retval);
+	}
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
 
@@ -1842,6 +1961,10 @@ Resource *ResourceManager::updateResource(ResourceId resId, ResourceSource *src,
 
 	if (_resMap.contains(resId)) {
 		res = _resMap.getVal(resId);
+		if (res->_status == kResStatusEnqueued) {
+			removeFromLRU(res);
+			res->unalloc();
+		}
 	} else {
 		res = new Resource(this, resId);
 		_resMap.setVal(resId, res);
@@ -271,6 +271,8 @@ protected:
 	int32 _fileOffset; /**< Offset in file */
 	ResourceStatus _status;
 	uint16 _lockers; /**< Number of places where this resource was locked */
+	Resource *_lruPrev; /**< More recently used resource in the same LRU list */
+	Resource *_lruNext; /**< Less recently used resource in the same LRU list */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
@@ -421,20 +423,78 @@ public:
 	 */
 	ResourceType convertResType(byte type);
 
+	/** Cache statistics of one resource type, shown by the debugger */
+	struct CacheStats {
+		uint32 hits;		///< Lookups of resources which were still in memory
+		uint32 misses;		///< Lookups which had to load the resource
+		uint32 evictions;	///< Resources freed to stay within the memory budget
+		uint32 prefetches;	///< Resources loaded ahead of time
+	};
+
+	const CacheStats &getCacheStats(ResourceType type) const { return _cacheStats[type]; }
+	void resetCacheStats();
+
+	int getMemoryLocked() const { return _memoryLocked; }
+	int getMemoryLRU() const { return _memoryLRU; }
+	uint32 getMaxMemoryLRU() const { return _maxMemoryLRU; }
+
+	/**
+	 * Sets the number of bytes unlocked resources may occupy before the
+	 * least recently used ones are freed.
+	 */
+	void setMaxMemoryLRU(uint32 bytes);
+
+	/**
+	 * Queues the resources a room is likely to use, so that they can be
+	 * loaded while the engine is idle. Does nothing unless prefetching
+	 * has been enabled with the "prefetch_resources" setting.
+	 */
+	void prefetchRoom(uint16 roomNumber);
+
+	/**
+	 * Loads queued resources until the given time has been reached or
+	 * the memory budget is used up.
+	 * @param deadline	value of g_system->getMillis() to stop at
+	 */
+	void processPrefetchQueue(uint32 deadline);
+
 protected:
-	// Maximum number of bytes to allow being allocated for resources
+	// Default number of bytes to allow being allocated for resources
 	// Note: maxMemory will not be interpreted as a hard limit, only as a restriction
 	// for resources which are not explicitly locked. However, a warning will be
-	// issued whenever this limit is exceeded.
+	// issued whenever this limit is exceeded. The "resource_cache_size" setting
+	// overrides this (in KB).
 	enum {
-		MAX_MEMORY = 256 * 1024	// 256KB
+		MAX_MEMORY = 256 * 1024,		// 256KB
+		MAX_MEMORY_SCI32 = 4 * 1024 * 1024	// 4MB, for the large views and pictures of SCI32
+	};
+
+	/**
+	 * Eviction priorities of unlocked resources. Each priority has its own
+	 * LRU list, and the lists of lower priorities are emptied first.
+	 */
+	enum LRUPriority {
+		kLRUPriorityLow,	///< Usually played once, e.g. audio and video
+		kLRUPriorityNormal,
+		kLRUPriorityHigh,	///< Expensive to decompress and often reused, e.g. views and pictures
+		kLRUPriorityCount
+	};
+
+	/** Intrusive list of resources under LRU control, most recently used first */
+	struct LRUList {
+		Resource *head;
+		Resource *tail;
 	};
 
 	ViewType _viewType; // Used to determine if the game has EGA or VGA graphics
 	Common::List<ResourceSource *> _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	uint32 _maxMemoryLRU;	///< Amount of resource bytes allowed under LRU control
+	LRUList _LRU[kLRUPriorityCount]; ///< Last Resource Used lists
+	CacheStats _cacheStats[kResourceTypeInvalid + 1];
+	bool _prefetchEnabled;
+	Common::List<ResourceId> _prefetchQueue; ///< Resources to load while idle
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -552,8 +612,10 @@ protected:
 	bool hasOldScriptHeader();
 
 	void printLRU();
+	static LRUPriority getLRUPriority(ResourceType type);
 	void addToLRU(Resource *res);
 	void removeFromLRU(Resource *res);
+	void resetLRU();
 
 	ResourceCompression getViewCompression();
 	ViewType detectViewType();
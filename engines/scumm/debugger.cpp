@@ -37,6 +37,8 @@
 
 namespace Scumm {
 
+extern const char *nameOfResType(ResType type);
+
 void debugC(int channel, const char *s, ...) {
 	char buf[STRINGBUFLEN];
 	va_list va;
@@ -79,6 +81,7 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	registerCmd("scr",       WRAP_METHOD(ScummDebugger, Cmd_Script));
 	registerCmd("scripts",   WRAP_METHOD(ScummDebugger, Cmd_PrintScript));
 	registerCmd("importres", WRAP_METHOD(ScummDebugger, Cmd_ImportRes));
+	registerCmd("resources", WRAP_METHOD(ScummDebugger, Cmd_Resources));
 
 	if (_vm->_game.id == GID_LOOM)
 		registerCmd("drafts",  WRAP_METHOD(ScummDebugger, Cmd_PrintDraft));
@@ -322,6 +325,35 @@ bool ScummDebugger::Cmd_ImportRes(int argc, const char** argv) {
 	return true;
 }
 
+bool ScummDebugger::Cmd_Resources(int argc, const char **argv) {
+	ResourceManager *res = _vm->_res;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "reset")) {
+			res->resetStats();
+			debugPrintf("Resource statistics reset\n");
+		} else {
+			debugPrintf("Syntax: resources [reset]\n");
+		}
+		return true;
+	}
+
+	debugPrintf("Heap: %d bytes allocated, expiring from %d down to %d bytes\n",
+		res->getAllocatedSize(), res->getMaxHeapThreshold(), res->getMinHeapThreshold());
+	debugPrintf("+-----------+------+---------+-------+-------+-------+\n");
+	debugPrintf("|type       |loaded|    bytes| loads |reloads|expired|\n");
+	debugPrintf("+-----------+------+---------+-------+-------+-------+\n");
+	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
+		const ResourceManager::ResTypeData::Stats &stats = res->_types[type]._stats;
+		if (!res->_types[type].size())
+			continue;
+		debugPrintf("|%-11s|%6d|%9d|%7d|%7d|%7d|\n", nameOfResType(type),
+			stats.residentNum, stats.residentSize, stats.loads, stats.reloads, stats.expired);
+	}
+	debugPrintf("+-----------+------+---------+-------+-------+-------+\n");
+	return true;
+}
+
 bool ScummDebugger::Cmd_PrintScript(int argc, const char **argv) {
 	int i;
 	ScriptSlot *ss = _vm->vm.slot;
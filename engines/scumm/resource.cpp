@@ -48,6 +48,7 @@ enum {
 	RF_USAGE_MAX = RF_USAGE,
 
 	RS_MODIFIED = 0x10,
+	RS_EXPIRED = 0x20,
 	RF_OFFHEAP = 0x40
 };
 
@@ -540,9 +541,16 @@ void ResourceManager::allocResTypeData(ResType type, uint32 tag, int num, ResTyp
 
 	// If there was data in there, let's clear it out completely. This is important
 	// in case we are restarting the game.
+	for (ResId idx = 0; idx < _types[type].size(); idx++)
+		nukeResource(type, idx);
 	_types[type].clear();
 	_types[type].resize(num);
 
+	for (ResId idx = 0; idx < num; idx++) {
+		_types[type][idx]._type = type;
+		_types[type][idx]._idx = idx;
+	}
+
 /*
 	TODO: Use multiple Resource subclasses, one for each res mode; then,
 	given them serializability.
@@ -777,28 +785,61 @@ void ResourceManager::increaseExpireCounter() {
 }
 
 void ResourceManager::increaseResourceCounters() {
-	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-		ResId idx = _types[type].size();
-		while (idx-- > 0) {
-			byte counter = _types[type][idx].getResourceCounter();
-			if (counter && counter < RF_USAGE_MAX) {
-				setResourceCounter(type, idx, counter + 1);
-			}
+	// Resources store the age at which they were last used, so this ages
+	// all of them at once
+	++_resourceAge;
+}
+
+void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter) {
+	Resource &res = _types[type][idx];
+
+	if (counter <= 1) {
+		res._lastUsed = _resourceAge;
+		if (res._address && _types[type]._mode != kDynamicResTypeMode && res._lruPrev) {
+			// Move the resource to the front of the LRU list
+			removeFromLRU(&res);
+			addToLRU(&res);
+		}
+	} else {
+		res._lastUsed = _resourceAge - (RF_USAGE_MAX - 1);
+		if (res._address && _types[type]._mode != kDynamicResTypeMode && res._lruNext) {
+			// Move the resource to the end of the LRU list, so it is
+			// expired first
+			removeFromLRU(&res);
+			res._lruPrev = _lruTail;
+			_lruTail->_lruNext = &res;
+			_lruTail = &res;
 		}
 	}
 }
 
-void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter) {
-	_types[type][idx].setResourceCounter(counter);
+byte ResourceManager::getResourceCounter(ResType type, ResId idx) const {
+	const Resource &res = _types[type][idx];
+	if (!res._address)
+		return 0;
+	return MIN<uint32>(_resourceAge - res._lastUsed + 1, RF_USAGE_MAX);
 }
 
-void ResourceManager::Resource::setResourceCounter(byte counter) {
-	_flags &= RF_LOCK;	// Clear lower 7 bits, preserve the lock bit.
-	_flags |= counter;	// Update the usage counter
+void ResourceManager::addToLRU(Resource *res) {
+	res->_lruPrev = NULL;
+	res->_lruNext = _lruHead;
+	if (_lruHead)
+		_lruHead->_lruPrev = res;
+	else
+		_lruTail = res;
+	_lruHead = res;
 }
 
-byte ResourceManager::Resource::getResourceCounter() const {
-	return _flags & RF_USAGE;
+void ResourceManager::removeFromLRU(Resource *res) {
+	if (res->_lruPrev)
+		res->_lruPrev->_lruNext = res->_lruNext;
+	else
+		_lruHead = res->_lruNext;
+	if (res->_lruNext)
+		res->_lruNext->_lruPrev = res->_lruPrev;
+	else
+		_lruTail = res->_lruPrev;
+	res->_lruPrev = res->_lruNext = NULL;
 }
 
 /* 2 bytes safety area to make "precaching" of bytes in the gdi drawer easier */
@@ -831,9 +872,22 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 	memset(ptr, 0, size + SAFETY_AREA);
 	_allocatedSize += size;
 
-	_types[type][idx]._address = ptr;
-	_types[type][idx]._size = size;
-	setResourceCounter(type, idx, 1);
+	Resource &res = _types[type][idx];
+	res._address = ptr;
+	res._size = size;
+	res._lastUsed = _resourceAge;
+	if (_types[type]._mode != kDynamicResTypeMode)
+		addToLRU(&res);
+
+	ResTypeData::Stats &stats = _types[type]._stats;
+	stats.residentNum++;
+	stats.residentSize += size;
+	stats.loads++;
+	if (res._status & RS_EXPIRED) {
+		stats.reloads++;
+		res._status &= ~RS_EXPIRED;
+	}
+
 	return ptr;
 }
 
@@ -842,6 +896,11 @@ ResourceManager::Resource::Resource() {
 	_size = 0;
 	_flags = 0;
 	_status = 0;
+	_type = rtInvalid;
+	_idx = 0;
+	_lastUsed = 0;
+	_lruPrev = 0;
+	_lruNext = 0;
 	_roomno = 0;
 	_roomoffs = 0;
 }
@@ -862,6 +921,7 @@ void ResourceManager::Resource::nuke() {
 ResourceManager::ResTypeData::ResTypeData() {
 	_mode = kDynamicResTypeMode;
 	_tag = 0;
+	memset(&_stats, 0, sizeof(_stats));
 }
 
 ResourceManager::ResTypeData::~ResTypeData() {
@@ -872,6 +932,9 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	_resourceAge = 0;
+	_lruHead = 0;
+	_lruTail = 0;
 }
 
 ResourceManager::~ResourceManager() {
@@ -885,6 +948,15 @@ void ResourceManager::setHeapThreshold(int min, int max) {
 	_minHeapThreshold = min;
 }
 
+void ResourceManager::resetStats() {
+	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
+		ResTypeData::Stats &stats = _types[type]._stats;
+		stats.loads = 0;
+		stats.reloads = 0;
+		stats.expired = 0;
+	}
+}
+
 bool ResourceManager::validateResource(const char *str, ResType type, ResId idx) const {
 	if (type < rtFirst || type > rtLast || (uint)idx >= (uint)_types[type].size()) {
 		error("%s Illegal Glob type %s (%d) num %d", str, nameOfResType(type), type, idx);
@@ -894,11 +966,15 @@ bool ResourceManager::validateResource(const char *str, ResType type, ResId idx)
 }
 
 void ResourceManager::nukeResource(ResType type, ResId idx) {
-	byte *ptr = _types[type][idx]._address;
-	if (ptr != NULL) {
+	Resource &res = _types[type][idx];
+	if (res._address != NULL) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", nameOfResType(type), idx);
-		_allocatedSize -= _types[type][idx]._size;
-		_types[type][idx].nuke();
+		_allocatedSize -= res._size;
+		_types[type]._stats.residentNum--;
+		_types[type]._stats.residentSize -= res._size;
+		if (_types[type]._mode != kDynamicResTypeMode)
+			removeFromLRU(&res);
+		res.nuke();
 	}
 }
 
@@ -1033,9 +1109,6 @@ void ResourceManager::Resource::setOnHeap() {
 }
 
 void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
-	ResType best_type;
-	int best_res = 0;
 	uint32 oldAllocatedSize;
 
 	if (_expireCounter != 0xFF) {
@@ -1048,31 +1121,23 @@ void ResourceManager::expireResources(uint32 size) {
 
 	oldAllocatedSize = _allocatedSize;
 
-	do {
-		best_type = rtInvalid;
-		best_counter = 2;
-
-		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-			if (_types[type]._mode != kDynamicResTypeMode) {
-				// Resources of this type can be reloaded from the data files,
-				// so we can potentially unload them to free memory.
-				ResId idx = _types[type].size();
-				while (idx-- > 0) {
-					Resource &tmp = _types[type][idx];
-					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
-						best_type = type;
-						best_res = idx;
-					}
-				}
-			}
-		}
-
-		if (!best_type)
+	// Walk the loaded resources which can be reloaded from the data files,
+	// starting with the least recently used one
+	Resource *res = _lruTail;
+	while (res && size + _allocatedSize > _minHeapThreshold) {
+		// All remaining resources were used since the counters were
+		// last increased
+		if (res->_lastUsed == _resourceAge)
 			break;
-		nukeResource(best_type, best_res);
-	} while (size + _allocatedSize > _minHeapThreshold);
+
+		Resource *prev = res->_lruPrev;
+		if (!res->isLocked() && !_vm->isResourceInUse(res->_type, res->_idx) && !res->isOffHeap()) {
+			_types[res->_type]._stats.expired++;
+			res->_status |= RS_EXPIRED;
+			nukeResource(res->_type, res->_idx);
+		}
+		res = prev;
+	}
 
 	increaseResourceCounters();
 
@@ -81,6 +81,7 @@ protected:
 
 public:
 	class Resource {
+	friend class ResourceManager;
 	public:
 		/**
 		 * Pointer to the data contained in this resource
@@ -95,21 +96,37 @@ public:
 	protected:
 		/**
 		 * The uppermost bit indicates whether the resources is locked.
-		 * The lower 7 bits contain a counter. This counter measures roughly
-		 * how old the resource is; it starts out with a count of 1 and can go
-		 * as high as 127. When memory falls low resp. when the engine decides
-		 * that it should throw out some unused stuff, then it begins by
-		 * removing the resources with the highest counter (excluding locked
-		 * resources and resources that are known to be in use).
 		 */
 		byte _flags;
 
 		/**
-		 * The status of the resource. Currently only one bit is used, which
-		 * indicates whether the resource is modified.
+		 * The status of the resource. Indicates whether the resource is
+		 * modified, kept off the heap, or was expired to free memory.
 		 */
 		byte _status;
 
+		/**
+		 * The type and index of this resource in the resource manager.
+		 */
+		ResType _type;
+		ResId _idx;
+
+		/**
+		 * The value of the resource manager's age counter when this resource
+		 * was last used. The difference between the two measures roughly how
+		 * old the resource is. When memory falls low resp. when the engine
+		 * decides that it should throw out some unused stuff, then it begins
+		 * by removing the oldest resources (excluding locked resources and
+		 * resources that are known to be in use).
+		 */
+		uint32 _lastUsed;
+
+		/**
+		 * Neighbours in the list of loaded resources which can be reloaded
+		 * from the game data files, ordered from most to least recently used.
+		 */
+		Resource *_lruPrev, *_lruNext;
+
 	public:
 		/**
 		 * The id of the room (resp. the disk) the resource is contained in.
@@ -132,9 +149,6 @@ public:
 
 		void nuke();
 
-		inline void setResourceCounter(byte counter);
-		inline byte getResourceCounter() const;
-
 		void lock();
 		void unlock();
 		bool isLocked() const;
@@ -165,6 +179,18 @@ public:
 		 */
 		uint32 _tag;
 
+		/**
+		 * Statistics about the resources of this type, shown by the
+		 * "resources" debugger command.
+		 */
+		struct Stats {
+			uint32 residentNum;		///< Number of resources currently loaded
+			uint32 residentSize;	///< Bytes used by the loaded resources
+			uint32 loads;			///< Number of resources created or loaded
+			uint32 reloads;			///< Loads of resources which were expired before
+			uint32 expired;			///< Resources freed to stay within the heap budget
+		} _stats;
+
 	public:
 		ResTypeData();
 		~ResTypeData();
@@ -176,11 +202,27 @@ protected:
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	/**
+	 * Age counter, incremented by increaseResourceCounters. Resources
+	 * remember its value when they are used, so aging all of them is O(1).
+	 */
+	uint32 _resourceAge;
+
+	/**
+	 * Loaded resources of non-dynamic types, ordered from most (head) to
+	 * least (tail) recently used. Only these can be expired.
+	 */
+	Resource *_lruHead, *_lruTail;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
 
 	void setHeapThreshold(int min, int max);
+	uint32 getAllocatedSize() const { return _allocatedSize; }
+	uint32 getMaxHeapThreshold() const { return _maxHeapThreshold; }
+	uint32 getMinHeapThreshold() const { return _minHeapThreshold; }
+	void resetStats();
 
 	void allocResTypeData(ResType type, uint32 tag, int num, ResTypeMode mode);
 	void freeResources();
@@ -211,13 +253,21 @@ public:
 	void increaseExpireCounter();
 
 	/**
-	 * Update the specified resource's counter.
+	 * Update the specified resource's counter. A counter of 1 marks the
+	 * resource as just used, any higher counter marks it as the first one
+	 * to be expired when memory runs low.
 	 */
 	void setResourceCounter(ResType type, ResId idx, byte counter);
 
 	/**
-	 * Increment the counter of all unlocked loaded resources.
-	 * The maximal count is 255.
+	 * Return the specified resource's counter: 0 if it is not loaded,
+	 * otherwise 1 plus the number of times the counters were increased since
+	 * it was last used. The maximal count is 127.
+	 */
+	byte getResourceCounter(ResType type, ResId idx) const;
+
+	/**
+	 * Increment the counter of all loaded resources.
 	 * This is called by increaseExpireCounter and expireResources,
 	 * but also by ScummEngine::startScene.
 	 */
@@ -229,6 +279,9 @@ public:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
 	void expireResources(uint32 size);
+
+	void addToLRU(Resource *res);
+	void removeFromLRU(Resource *res);
 };
 
 } // End of namespace Scumm
@@ -1368,7 +1368,16 @@ void ScummEngine::setupScumm() {
 		maxHeapThreshold = 550000;
 	}
 
-	_res->setHeapThreshold(400000, maxHeapThreshold);
+	int minHeapThreshold = 400000;
+
+	// Allow low memory devices to expire resources earlier, and others to
+	// avoid reloading resources when changing rooms
+	if (ConfMan.hasKey("resource_cache_size")) {
+		maxHeapThreshold = MAX(ConfMan.getInt("resource_cache_size"), 64) * 1024;
+		minHeapThreshold = maxHeapThreshold / 4 * 3;
+	}
+
+	_res->setHeapThreshold(MIN(minHeapThreshold, maxHeapThreshold), maxHeapThreshold);
 
 	free(_compositeBuf);
 	_compositeBuf = (byte *)malloc(_screenWidth * _textSurfaceMultiplier * _screenHeight * _textSurfaceMultiplier * _outputPixelFormat.bytesPerPixel);
@@ -20,16 +20,90 @@
  *
  */
 
+#include "common/archive.h"
+#include "common/stream.h"
+#include "common/system.h"
+
 #include "sword25/console.h"
 #include "sword25/sword25.h"
+#include "sword25/kernel/kernel.h"
+#include "sword25/package/packagemanager.h"
+#include "sword25/gfx/image/vectorimage.h"
 
 namespace Sword25 {
 
 Sword25Console::Sword25Console(Sword25Engine *vm) : GUI::Debugger(), _vm(vm) {
 	assert(_vm);
+
+	registerCmd("vectorbench", WRAP_METHOD(Sword25Console, Cmd_VectorBench));
 }
 
 Sword25Console::~Sword25Console() {
 }
 
+/**
+ * Times the rasterization of all vector images of the game at the given scales
+ */
+bool Sword25Console::Cmd_VectorBench(int argc, const char **argv) {
+	Common::Array<double> scales;
+	for (int i = 1; i < argc; ++i) {
+		const double scale = atof(argv[i]);
+		if (scale <= 0) {
+			debugPrintf("Usage: %s [<scale> ...]\n", argv[0]);
+			return true;
+		}
+		scales.push_back(scale);
+	}
+	if (scales.empty()) {
+		scales.push_back(0.5);
+		scales.push_back(1.0);
+		scales.push_back(2.0);
+	}
+
+	Common::ArchiveMemberList files;
+	Kernel::getInstance()->getPackage()->doSearch(files, "/*.swf", "", PackageManager::FT_FILE);
+
+	Common::Array<VectorImage *> images;
+	for (Common::ArchiveMemberList::iterator it = files.begin(); it != files.end(); ++it) {
+		Common::SeekableReadStream *stream = (*it)->createReadStream();
+		if (!stream)
+			continue;
+
+		const uint size = stream->size();
+		byte *data = new byte[size];
+		stream->read(data, size);
+		delete stream;
+
+		bool success = false;
+		VectorImage *image = new VectorImage(data, size, success, (*it)->getName());
+		delete[] data;
+
+		if (success)
+			images.push_back(image);
+		else
+			delete image;
+	}
+
+	debugPrintf("Rendering %d vector images\n", images.size());
+
+	for (uint s = 0; s < scales.size(); ++s) {
+		uint pixels = 0;
+		const uint32 start = g_system->getMillis();
+
+		for (uint i = 0; i < images.size(); ++i) {
+			const int width = MAX<int>(1, (int)(images[i]->getWidth() * scales[s]));
+			const int height = MAX<int>(1, (int)(images[i]->getHeight() * scales[s]));
+			free(images[i]->render(width, height));
+			pixels += width * height;
+		}
+
+		debugPrintf("Scale %.2f: %d ms, %d pixels\n", scales[s], g_system->getMillis() - start, pixels);
+	}
+
+	for (uint i = 0; i < images.size(); ++i)
+		delete images[i];
+
+	return true;
+}
+
 } // End of namespace Sword25
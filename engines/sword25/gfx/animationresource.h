@@ -80,6 +80,11 @@ public:
 		return _valid;
 	}
 
+	virtual uint getMemorySize() const {
+		// The frames themselves are separate bitmap resources
+		return _frames.size() * sizeof(Frame);
+	}
+
 private:
 	bool _valid;
 
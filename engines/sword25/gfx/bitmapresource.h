@@ -51,6 +51,10 @@ public:
 		return (_pImage != 0);
 	}
 
+	virtual uint getMemorySize() const {
+		return _pImage ? _pImage->getMemorySize() : 0;
+	}
+
 	/**
 	    @brief Gibt die Breite des Bitmaps zurck.
 	*/
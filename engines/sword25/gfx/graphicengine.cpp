@@ -43,6 +43,7 @@
 #include "sword25/gfx/image/vectorimage.h"
 #include "sword25/package/packagemanager.h"
 #include "sword25/kernel/inputpersistenceblock.h"
+#include "sword25/kernel/resmanager.h"
 #include "sword25/kernel/outputpersistenceblock.h"
 
 
@@ -60,6 +61,10 @@ enum {
 
 namespace Sword25 {
 
+// The time spent at the end of each frame loading the resources which
+// the scripts asked to precache
+static const uint32 PRECACHE_MILLIS_PER_FRAME = 5;
+
 static const uint FRAMETIME_SAMPLE_COUNT = 5;       // Anzahl der Framezeiten ber die, die Framezeit gemittelt wird
 
 GraphicEngine::GraphicEngine(Kernel *pKernel) :
@@ -148,6 +153,8 @@ bool GraphicEngine::endFrame() {
 
 	g_system->updateScreen();
 
+	Kernel::getInstance()->getResourceManager()->processPrecacheQueue(PRECACHE_MILLIS_PER_FRAME);
+
 	return true;
 }
 
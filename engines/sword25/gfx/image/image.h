@@ -71,6 +71,14 @@ public:
 	*/
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const = 0;
 
+	/**
+	    @brief Returns the approximate number of bytes the image takes up in memory
+	    @remark Pixel images are stored with 32 bits per pixel.
+	*/
+	virtual uint getMemorySize() const {
+		return getWidth() * getHeight() * 4;
+	}
+
 	//@}
 
 	//@{
@@ -43,6 +43,9 @@ namespace Sword25 {
 
 #define BEZSMOOTHNESS 0.5
 
+// The amount of memory used for caching rasterized images at different sizes
+#define SWORD25_VECTORIMAGE_CACHE_MEMORY 16000000
+
 // -----------------------------------------------------------------------------
 // SWF datatype
 // -----------------------------------------------------------------------------
@@ -215,7 +218,7 @@ Common::Rect CalculateBoundingBox(const VectorImageElement &vectorImageElement)
 // Construction
 // -----------------------------------------------------------------------------
 
-VectorImage::VectorImage(const byte *pFileData, uint fileSize, bool &success, const Common::String &fname) : _pixelData(0), _fname(fname) {
+VectorImage::VectorImage(const byte *pFileData, uint fileSize, bool &success, const Common::String &fname) : _fname(fname) {
 	success = false;
 
 	// Create bitstream object
@@ -294,14 +297,35 @@ VectorImage::VectorImage(const byte *pFileData, uint fileSize, bool &success, co
 	assert(false);
 }
 
+uint VectorImage::getMemorySize() const {
+	uint size = sizeof(VectorImage) + _elements.size() * sizeof(VectorImageElement);
+
+	for (uint e = 0; e < _elements.size(); e++) {
+		const VectorImageElement &element = _elements[e];
+
+		for (uint i = 0; i < element.getPathCount(); i++)
+			size += sizeof(VectorPathInfo) + element.getPathInfo(i).getVecLen() * sizeof(ArtBpath);
+
+		size += element.getLineStyleCount() * sizeof(VectorImageElement::LineStyleType);
+		size += element.getFillStyleCount() * sizeof(uint32);
+	}
+
+	return size;
+}
+
 VectorImage::~VectorImage() {
 	for (int j = _elements.size() - 1; j >= 0; j--)
 		for (int i = _elements[j].getPathCount() - 1; i >= 0; i--)
 			if (_elements[j].getPathInfo(i).getVec())
 				free(_elements[j].getPathInfo(i).getVec());
 
-	if (_pixelData)
-		free(_pixelData);
+	Rasterization *rasterization = _rasterizationsHead;
+	while (rasterization) {
+		Rasterization *next = rasterization->next;
+		if (rasterization->image == this)
+			removeRasterization(rasterization);
+		rasterization = next;
+	}
 }
 
 
@@ -599,32 +623,84 @@ bool VectorImage::setContent(const byte *pixeldata, uint size, uint offset, uint
 	return 0;
 }
 
+VectorImage::Rasterization *VectorImage::_rasterizationsHead = 0;
+VectorImage::Rasterization *VectorImage::_rasterizationsTail = 0;
+VectorImage::RasterizationMap VectorImage::_rasterizationMap;
+uint VectorImage::_rasterizationsSize = 0;
+
+void VectorImage::removeRasterization(Rasterization *rasterization) {
+	const RasterizationKey key = { rasterization->image, rasterization->width, rasterization->height };
+	_rasterizationMap.erase(key);
+	unlinkRasterization(rasterization);
+	_rasterizationsSize -= rasterization->width * rasterization->height * 4;
+	free(rasterization->pixelData);
+	delete rasterization;
+}
+
+void VectorImage::unlinkRasterization(Rasterization *rasterization) {
+	if (rasterization->prev)
+		rasterization->prev->next = rasterization->next;
+	else
+		_rasterizationsHead = rasterization->next;
+
+	if (rasterization->next)
+		rasterization->next->prev = rasterization->prev;
+	else
+		_rasterizationsTail = rasterization->prev;
+}
+
+byte *VectorImage::getRasterization(int width, int height) {
+	const RasterizationKey key = { this, width, height };
+	Rasterization *rasterization = _rasterizationMap.getVal(key, 0);
+
+	if (rasterization) {
+		unlinkRasterization(rasterization);
+	} else {
+		rasterization = new Rasterization();
+		rasterization->image = this;
+		rasterization->width = width;
+		rasterization->height = height;
+		rasterization->pixelData = render(width, height);
+		_rasterizationMap[key] = rasterization;
+		_rasterizationsSize += width * height * 4;
+	}
+
+	// Move it to the front of the list
+	rasterization->prev = 0;
+	rasterization->next = _rasterizationsHead;
+	if (_rasterizationsHead)
+		_rasterizationsHead->prev = rasterization;
+	else
+		_rasterizationsTail = rasterization;
+	_rasterizationsHead = rasterization;
+
+	// Drop the least recently used rasterizations, but always keep the one
+	// which is about to be drawn
+	while (_rasterizationsSize > SWORD25_VECTORIMAGE_CACHE_MEMORY && _rasterizationsTail != rasterization)
+		removeRasterization(_rasterizationsTail);
+
+	return rasterization->pixelData;
+}
+
 bool VectorImage::blit(int posX, int posY,
                        int flipping,
                        Common::Rect *pPartRect,
                        uint color,
                        int width, int height,
 					   RectangleList *updateRects) {
-	static VectorImage *oldThis = 0;
-	static int              oldWidth = -2;
-	static int              oldHeight = -2;
-
 	// If width or height to 0, nothing needs to be shown.
 	if (width == 0 || height == 0)
 		return true;
 
-	// Determine if the old image in the cache can not be reused and must be recalculated
-	if (!(oldThis == this && oldWidth == width && oldHeight == height)) {
-		render(width, height);
-
-		oldThis = this;
-		oldHeight = height;
-		oldWidth = width;
-	}
+	// -1 stands for the unscaled size
+	if (width == -1)
+		width = getWidth();
+	if (height == -1)
+		height = getHeight();
 
 	RenderedImage *rend = new RenderedImage();
 
-	rend->replaceContent(_pixelData, width, height);
+	rend->replaceContent(getRasterization(width, height), width, height);
 	rend->blit(posX, posY, flipping, pPartRect, color, width, height, updateRects);
 
 	delete rend;
@@ -38,6 +38,7 @@
 
 #include "sword25/kernel/common.h"
 #include "sword25/gfx/image/image.h"
+#include "common/hashmap.h"
 #include "common/rect.h"
 
 #include "art.h"
@@ -181,9 +182,20 @@ public:
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const {
 		return GraphicEngine::CF_ARGB32;
 	}
+
+	/**
+	 * Returns the size of the shape data. The image is only rasterized when
+	 * it is drawn, and the rasterizations are kept within their own budget.
+	 */
+	virtual uint getMemorySize() const;
+
 	virtual bool fill(const Common::Rect *pFillRect = 0, uint color = BS_RGB(0, 0, 0));
 
-	void render(int width, int height);
+	/**
+	 * Rasterizes the image at the given size.
+	 * @return  a newly allocated ARGB buffer, which the caller must free()
+	 */
+	byte *render(int width, int height);
 
 	virtual uint getPixel(int x, int y);
 	virtual bool isBlitSource() const {
@@ -225,9 +237,47 @@ private:
 	Common::Array<VectorImageElement>    _elements;
 	Common::Rect                         _boundingBox;
 
-	byte *_pixelData;
-
 	Common::String _fname;
+
+	/**
+	 * A rasterization of an image at one size. All of them are kept in one
+	 * list, with the most recently used first, and are looked up by image
+	 * and size in a hash map.
+	 */
+	struct Rasterization {
+		const VectorImage *image;
+		int width;
+		int height;
+		byte *pixelData;
+		Rasterization *prev;
+		Rasterization *next;
+	};
+
+	struct RasterizationKey {
+		const VectorImage *image;
+		int width;
+		int height;
+	};
+	struct RasterizationKey_EqualTo {
+		bool operator()(const RasterizationKey &x, const RasterizationKey &y) const {
+			return x.image == y.image && x.width == y.width && x.height == y.height;
+		}
+	};
+	struct RasterizationKey_Hash {
+		uint operator()(const RasterizationKey &x) const {
+			return (uint)((size_t)x.image >> 4) ^ ((uint)x.width << 16) ^ (uint)x.height;
+		}
+	};
+	typedef Common::HashMap<RasterizationKey, Rasterization *, RasterizationKey_Hash, RasterizationKey_EqualTo> RasterizationMap;
+
+	byte *getRasterization(int width, int height);
+	static void removeRasterization(Rasterization *rasterization);
+	static void unlinkRasterization(Rasterization *rasterization);
+
+	static Rasterization *_rasterizationsHead;
+	static Rasterization *_rasterizationsTail;
+	static RasterizationMap _rasterizationMap;
+	static uint _rasterizationsSize;
 };
 
 } // End of namespace Sword25
@@ -129,9 +129,14 @@ static int getSubversionRevision(lua_State *L) {
 }
 
 static int getUsedMemory(lua_State *L) {
-	// It doesn't really matter what this call returns,
-	// as it's used in a debug function.
-	lua_pushnumber(L, 0);
+	// This is used in a debug function. Report the memory taken up by
+	// the resource cache, which is the bulk of what the game uses.
+	Kernel *pKernel = Kernel::getInstance();
+	assert(pKernel);
+	ResourceManager *pResource = pKernel->getResourceManager();
+	assert(pResource);
+
+	lua_pushnumber(L, pResource->getUsedMemory());
 	return 1;
 }
 
@@ -309,11 +314,10 @@ static int precacheResource(lua_State *L) {
 	ResourceManager *pResource = pKernel->getResourceManager();
 	assert(pResource);
 
-#ifdef PRECACHE_RESOURCES
-	lua_pushbooleancpp(L, pResource->precacheResource(luaL_checkstring(L, 1)));
-#else
+	// The resource is loaded at the end of one of the next frames, so
+	// whether it exists isn't known yet
+	pResource->precacheResourceAsync(luaL_checkstring(L, 1));
 	lua_pushbooleancpp(L, true);
-#endif
 
 	return 1;
 }
@@ -339,9 +343,7 @@ static int getMaxMemoryUsage(lua_State *L) {
 	ResourceManager *pResource = pKernel->getResourceManager();
 	assert(pResource);
 
-	// This is used for debugging, so it doesn't really matter.
-	// The default value set by the scripts is 256000000 bytes
-	lua_pushnumber(L, 256000000);
+	lua_pushnumber(L, pResource->getMaxMemoryUsage());
 
 	return 1;
 }
@@ -352,8 +354,8 @@ static int setMaxMemoryUsage(lua_State *L) {
 	ResourceManager *pResource = pKernel->getResourceManager();
 	assert(pResource);
 
-	// This call is ignored, we set a limit on the number of
-	// simultaneous resources loaded instead.
+	// The number of simultaneously loaded resources is limited, too
+	pResource->setMaxMemoryUsage(static_cast<uint>(luaL_checknumber(L, 1)));
 
 	return 0;
 }
@@ -380,6 +382,34 @@ static int dumpLockedResources(lua_State *L) {
 	return 0;
 }
 
+static void setStatistic(lua_State *L, const char *name, uint value) {
+	lua_pushstring(L, name);
+	lua_pushnumber(L, value);
+	lua_settable(L, -3);
+}
+
+static int getCacheStatistics(lua_State *L) {
+	Kernel *pKernel = Kernel::getInstance();
+	assert(pKernel);
+	ResourceManager *pResource = pKernel->getResourceManager();
+	assert(pResource);
+
+	const ResourceManager::Statistics &statistics = pResource->getStatistics();
+
+	lua_newtable(L);
+	setStatistic(L, "Resources", pResource->getResourceCount());
+	setStatistic(L, "UsedMemory", pResource->getUsedMemory());
+	setStatistic(L, "MaxMemoryUsage", pResource->getMaxMemoryUsage());
+	setStatistic(L, "Hits", statistics.hits);
+	setStatistic(L, "Misses", statistics.misses);
+	setStatistic(L, "Evictions", statistics.evictions);
+	setStatistic(L, "ForcedUnlocks", statistics.forcedUnlocks);
+	setStatistic(L, "Precached", statistics.precached);
+	setStatistic(L, "PrecacheQueue", pResource->getPrecacheQueueSize());
+
+	return 1;
+}
+
 static const char *RESOURCE_LIBRARY_NAME = "Resource";
 
 static const luaL_reg RESOURCE_FUNCTIONS[] = {
@@ -391,6 +421,7 @@ static const luaL_reg RESOURCE_FUNCTIONS[] = {
 	{"IsLogCacheMiss", dummyFuncError},
 	{"SetLogCacheMiss", dummyFuncError},
 	{"DumpLockedResources", dumpLockedResources},
+	{"GetCacheStatistics", getCacheStatistics},
 	{0, 0}
 };
 
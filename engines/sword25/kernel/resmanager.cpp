@@ -29,6 +29,8 @@
  *
  */
 
+#include "common/system.h"
+
 #include "sword25/sword25.h"	// for kDebugResource
 #include "sword25/kernel/resmanager.h"
 #include "sword25/kernel/resource.h"
@@ -46,6 +48,17 @@ namespace Sword25 {
 // are loaded, the resource manager will start purging resources till it
 // hits the minimum limit above
 #define SWORD25_RESOURCECACHE_MAX 500
+// The number of bytes the loaded resources may take up, until the scripts
+// set their own limit. If they take up more, the resource manager purges
+// resources until they take up less than 3/4 of it.
+#define SWORD25_RESOURCECACHE_MEMORY 256000000
+
+ResourceManager::ResourceManager(Kernel *pKernel) :
+	_kernelPtr(pKernel),
+	_usedMemory(0),
+	_maxMemoryUsage(SWORD25_RESOURCECACHE_MEMORY) {
+	memset(&_statistics, 0, sizeof(_statistics));
+}
 
 ResourceManager::~ResourceManager() {
 	// Clear all unlocked resources
@@ -87,7 +100,8 @@ bool ResourceManager::registerResourceService(ResourceService *pService) {
  */
 void ResourceManager::deleteResourcesIfNecessary() {
 	// If enough memory is available, or no resources are loaded, then the function can immediately end
-	if (_resources.size() < SWORD25_RESOURCECACHE_MAX)
+	const bool cacheFull = _resources.size() >= SWORD25_RESOURCECACHE_MAX;
+	if (!cacheFull && _usedMemory <= _maxMemoryUsage)
 		return;
 
 	// Keep deleting resources until the memory usage of the process falls below the set maximum limit.
@@ -98,16 +112,19 @@ void ResourceManager::deleteResourcesIfNecessary() {
 		--iter;
 
 		// The resource may be released only if it isn't locked
-		if ((*iter)->getLockCount() == 0)
+		if ((*iter)->getLockCount() == 0) {
 			iter = deleteResource(*iter);
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
+			_statistics.evictions++;
+		}
+	} while (iter != _resources.begin() && isAboveMinimum());
 
 	// Are we still above the minimum? If yes, then start releasing locked resources
 	// FIXME: This code shouldn't be needed at all, but it seems like there is a bug
 	// in the resource lock code, and resources are not unlocked when changing rooms.
 	// Only image/animation resources are unlocked forcibly, thus this shouldn't have
 	// any impact on the game itself.
-	if (_resources.size() <= SWORD25_RESOURCECACHE_MIN)
+	// The memory budget alone never forces resources out; only the resource count does.
+	if (!cacheFull || _resources.size() <= SWORD25_RESOURCECACHE_MIN)
 		return;
 
 	iter = _resources.end();
@@ -125,10 +142,15 @@ void ResourceManager::deleteResourcesIfNecessary() {
 				(*iter)->release();
 
 			iter = deleteResource(*iter);
+			_statistics.forcedUnlocks++;
 		}
 	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
 }
 
+bool ResourceManager::isAboveMinimum() const {
+	return _resources.size() >= SWORD25_RESOURCECACHE_MIN || _usedMemory > _maxMemoryUsage / 4 * 3;
+}
+
 /**
  * Releases all resources that are not locked.
  */
@@ -172,8 +194,12 @@ Resource *ResourceManager::requestResource(const Common::String &fileName) {
 	// Determine whether the resource is already loaded
 	// If the resource is found, it will be placed at the head of the resource list and returned
 	Resource *pResource = getResource(uniqueFileName);
-	if (!pResource)
+	if (pResource) {
+		_statistics.hits++;
+	} else {
+		_statistics.misses++;
 		pResource = loadResource(uniqueFileName);
+	}
 	if (pResource) {
 		moveToFront(pResource);
 		(pResource)->addReference();
@@ -183,8 +209,6 @@ Resource *ResourceManager::requestResource(const Common::String &fileName) {
 	return NULL;
 }
 
-#ifdef PRECACHE_RESOURCES
-
 /**
  * Loads a resource into the cache
  * @param FileName      The filename of the resource to be cached
@@ -218,7 +242,50 @@ bool ResourceManager::precacheResource(const Common::String &fileName, bool forc
 	return true;
 }
 
-#endif
+/**
+ * Queues a resource to be loaded into the cache in the background.
+ * @param FileName      The filename of the resource to be cached
+ */
+void ResourceManager::precacheResourceAsync(const Common::String &fileName) {
+	Common::String uniqueFileName = getUniqueFileName(fileName);
+	if (uniqueFileName.empty() || getResource(uniqueFileName) || _precacheQueued.contains(uniqueFileName))
+		return;
+
+	_precacheQueue.push_back(uniqueFileName);
+	_precacheQueued[uniqueFileName] = true;
+}
+
+/**
+ * Loads queued resources into the cache, until the given time has passed.
+ * @param MaxMillis     The time to spend loading resources
+ */
+void ResourceManager::processPrecacheQueue(uint32 maxMillis) {
+	// OSystem has no threads, and the resource services and the package
+	// manager are not thread-safe anyway. So the queued resources are
+	// loaded a few at a time between the frames instead.
+	const uint32 startTime = g_system->getMillis();
+
+	// Precaching stops where purging would stop, so that it never makes the
+	// cache release resources the game is still using. The remaining entries
+	// are loaded once the game has released enough resources.
+	while (!_precacheQueue.empty() && !isAboveMinimum()) {
+		Common::String fileName = _precacheQueue.front();
+		_precacheQueue.pop_front();
+		_precacheQueued.erase(fileName);
+
+		// The game may have requested the resource in the meantime. A missing
+		// file is only logged, as the scripts can't handle the error anymore.
+		if (!getResource(fileName)) {
+			if (!_kernelPtr->getPackage()->fileExists(fileName))
+				debugC(kDebugResource, "Could not precache \"%s\", the file does not exist.", fileName.c_str());
+			else if (precacheResource(fileName))
+				_statistics.precached++;
+		}
+
+		if (g_system->getMillis() - startTime >= maxMillis)
+			break;
+	}
+}
 
 /**
  * Moves a resource to the top of the resource list
@@ -257,6 +324,11 @@ Resource *ResourceManager::loadResource(const Common::String &fileName) {
 			_resources.push_front(pResource);
 			pResource->_iterator = _resources.begin();
 
+			// Count the memory the resource takes up. The size is kept, so the
+			// same amount is subtracted again when the resource is deleted.
+			pResource->_memorySize = pResource->getMemorySize();
+			_usedMemory += pResource->_memorySize;
+
 			// Also store the resource in the hash table for quick lookup
 			_resourceHashMap[pResource->getFileName()] = pResource;
 
@@ -295,6 +367,7 @@ Common::String ResourceManager::getUniqueFileName(const Common::String &fileName
 Common::List<Resource *>::iterator ResourceManager::deleteResource(Resource *pResource) {
 	// Remove the resource from the hash table
 	_resourceHashMap.erase(pResource->_fileName);
+	_usedMemory -= pResource->_memorySize;
 
 	// Delete the resource from the resource list
 	Common::List<Resource *>::iterator result = _resources.erase(pResource->_iterator);
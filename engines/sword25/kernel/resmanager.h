@@ -56,7 +56,6 @@ public:
 	 */
 	Resource *requestResource(const Common::String &fileName);
 
-#ifdef PRECACHE_RESOURCES
 	/**
 	 * Loads a resource into the cache
 	 * @param FileName      The filename of the resource to be cached
@@ -64,7 +63,65 @@ public:
 	 * This is useful for files that may have changed in the interim
 	 */
 	bool precacheResource(const Common::String &fileName, bool forceReload = false);
-#endif
+
+	/**
+	 * Queues a resource to be loaded into the cache in the background.
+	 * The queued resources are loaded by processPrecacheQueue() at the end
+	 * of each frame.
+	 * @param FileName      The filename of the resource to be cached
+	 */
+	void precacheResourceAsync(const Common::String &fileName);
+
+	/**
+	 * Loads queued resources into the cache, until the given time has passed
+	 * or the cache holds as much as it is purged down to. At least one
+	 * resource is loaded if any are queued and the cache has room.
+	 * @param MaxMillis     The time to spend loading resources
+	 */
+	void processPrecacheQueue(uint32 maxMillis);
+
+	/**
+	 * Sets the number of bytes the cached resources may take up. Once they
+	 * take up more, unlocked resources are released until they take up less
+	 * than 3/4 of this.
+	 */
+	void setMaxMemoryUsage(uint maxMemoryUsage) {
+		_maxMemoryUsage = maxMemoryUsage;
+	}
+
+	uint getMaxMemoryUsage() const {
+		return _maxMemoryUsage;
+	}
+
+	/**
+	 * Returns the number of bytes the cached resources take up
+	 */
+	uint getUsedMemory() const {
+		return _usedMemory;
+	}
+
+	struct Statistics {
+		uint hits;           ///< Requests for resources which were in the cache
+		uint misses;         ///< Requests for resources which had to be loaded
+		uint evictions;      ///< Resources released to make room
+		uint forcedUnlocks;  ///< Locked resources released to make room
+		uint precached;      ///< Resources loaded from the precache queue
+	};
+
+	/**
+	 * Returns the statistics of the resource cache since the game started
+	 */
+	const Statistics &getStatistics() const {
+		return _statistics;
+	}
+
+	uint getResourceCount() const {
+		return _resources.size();
+	}
+
+	uint getPrecacheQueueSize() const {
+		return _precacheQueue.size();
+	}
 
 	/**
 	 * Registers a RegisterResourceService. This method is the constructor of
@@ -93,9 +150,7 @@ private:
 	 * Creates a new resource manager
 	 * Only the BS_Kernel class can generate copies this class. Thus, the constructor is private
 	 */
-	ResourceManager(Kernel *pKernel) :
-		_kernelPtr(pKernel)
-	{}
+	ResourceManager(Kernel *pKernel);
 	virtual ~ResourceManager();
 
 	/**
@@ -134,11 +189,24 @@ private:
 	 */
 	void deleteResourcesIfNecessary();
 
+	/**
+	 * Returns whether more resources are loaded than the cache should keep
+	 * after releasing resources.
+	 */
+	bool isAboveMinimum() const;
+
 	Kernel *_kernelPtr;
 	Common::Array<ResourceService *> _resourceServices;
 	Common::List<Resource *> _resources;
 	typedef Common::HashMap<Common::String, Resource *> ResMap;
 	ResMap _resourceHashMap;
+	uint _usedMemory;
+	uint _maxMemoryUsage;
+	Statistics _statistics;
+
+	Common::List<Common::String> _precacheQueue;
+	typedef Common::HashMap<Common::String, bool> PrecacheMap;
+	PrecacheMap _precacheQueued;
 };
 
 } // End of namespace Sword25
@@ -92,6 +92,14 @@ public:
 		return _type;
 	}
 
+	/**
+	 * Returns the approximate number of bytes the resource's data takes up
+	 * in memory. It is used to keep the resource cache within its budget.
+	 */
+	virtual uint getMemorySize() const {
+		return 0;
+	}
+
 protected:
 	virtual ~Resource() {}
 
@@ -99,6 +107,7 @@ private:
 	Common::String _fileName;          ///< The absolute filename
 	uint _refCount;          ///< The number of locks
 	uint _type;              ///< The type of the resource
+	uint _memorySize;        ///< The memory size the resource manager counted for the resource
 	Common::List<Resource *>::iterator _iterator;        ///< Points to the resource position in the LRU list
 };
 
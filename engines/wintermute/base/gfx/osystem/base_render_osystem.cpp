@@ -36,10 +36,14 @@
 #include "engines/wintermute/base/base_sprite.h"
 #include "common/system.h"
 #include "graphics/transparent_surface.h"
-#include "common/queue.h"
 #include "common/config-manager.h"
 
-#define DIRTY_RECT_LIMIT 800
+// Dirty rects beyond this number are merged with the closest one, as every
+// dirty rect costs another pass over the queued tickets
+#define DIRTY_RECT_LIMIT 16
+// Dirty rects are merged if their bounding rect is at most this many pixels
+// larger than the two of them together
+#define DIRTY_RECT_MERGE_SLACK 4096
 
 namespace Wintermute {
 
@@ -51,14 +55,15 @@ BaseRenderer *makeOSystemRenderer(BaseGame *inGame) {
 BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 	_renderSurface = new Graphics::Surface();
 	_blankSurface = new Graphics::Surface();
-	_lastFrameIter = _renderQueue.end();
+	_lastFrameIndex = -1;
 	_needsFlip = true;
 	_skipThisFrame = false;
 
 	_borderLeft = _borderRight = _borderTop = _borderBottom = 0;
 	_ratioX = _ratioY = 1.0f;
-	_dirtyRect = nullptr;
 	_disableDirtyRects = false;
+	_statDirtyPixels = _statTicketsDrawn = _statTicketsCulled = 0;
+	_recordFramesLeft = 0;
 	if (ConfMan.hasKey("dirty_rects")) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
 	}
@@ -68,14 +73,12 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 
 //////////////////////////////////////////////////////////////////////////
 BaseRenderOSystem::~BaseRenderOSystem() {
-	RenderQueueIterator it = _renderQueue.begin();
-	while (it != _renderQueue.end()) {
-		RenderTicket *ticket = *it;
-		it = _renderQueue.erase(it);
-		delete ticket;
+	for (uint i = 0; i < _renderQueue.size(); i++) {
+		delete _renderQueue[i];
 	}
+	_renderQueue.clear();
 
-	delete _dirtyRect;
+	clearRecording();
 
 	_renderSurface->free();
 	delete _renderSurface;
@@ -152,18 +155,20 @@ bool BaseRenderOSystem::indicatorFlip() {
 }
 
 bool BaseRenderOSystem::flip() {
+	if (_recordFramesLeft && --_recordFramesLeft) {
+		_recording.push_back(Common::Array<RenderTicket *>());
+	}
+
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.clear();
 		g_system->updateScreen();
 		_needsFlip = false;
 
 		// Reset ticketing state
-		_lastFrameIter = _renderQueue.end();
-		RenderQueueIterator it;
-		for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
-			(*it)->_wantsDraw = false;
+		_lastFrameIndex = -1;
+		for (uint i = 0; i < _renderQueue.size(); i++) {
+			_renderQueue[i]->_wantsDraw = false;
 		}
 
 		addDirtyRect(_renderRect);
@@ -173,17 +178,17 @@ bool BaseRenderOSystem::flip() {
 		drawTickets();
 	} else {
 		// Clear the scale-buffered tickets that wasn't reused.
-		RenderQueueIterator it = _renderQueue.begin();
-		while (it != _renderQueue.end()) {
-			if ((*it)->_wantsDraw == false) {
-				RenderTicket *ticket = *it;
-				it = _renderQueue.erase(it);
+		uint kept = 0;
+		for (uint i = 0; i < _renderQueue.size(); i++) {
+			RenderTicket *ticket = _renderQueue[i];
+			if (ticket->_wantsDraw == false) {
 				delete ticket;
 			} else {
-				(*it)->_wantsDraw = false;
-				++it;
+				ticket->_wantsDraw = false;
+				_renderQueue[kept++] = ticket;
 			}
 		}
+		_renderQueue.resize(kept);
 	}
 
 	int oldScreenChangeID = _lastScreenChangeID;
@@ -194,12 +199,10 @@ bool BaseRenderOSystem::flip() {
 		if (_disableDirtyRects || screenChanged) {
 			g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 		}
-		//  g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.clear();
 		_needsFlip = false;
 	}
-	_lastFrameIter = _renderQueue.end();
+	_lastFrameIndex = -1;
 
 	g_system->updateScreen();
 
@@ -269,6 +272,9 @@ Graphics::PixelFormat BaseRenderOSystem::getPixelFormat() const {
 }
 
 void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct &transform) {
+	if (_recordFramesLeft) {
+		_recording.back().push_back(new RenderTicket(owner, surf, srcRect, dstRect, transform));
+	}
 
 	if (_disableDirtyRects) {
 		RenderTicket *ticket = new RenderTicket(owner, surf, srcRect, dstRect, transform);
@@ -285,32 +291,26 @@ void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::S
 
 	if (owner) { // Fade-tickets are owner-less
 		RenderTicket compare(owner, nullptr, srcRect, dstRect, transform);
-		RenderQueueIterator it = _lastFrameIter;
-		++it;
-		// Avoid calling end() and operator* every time, when potentially going through
-		// LOTS of tickets.
-		RenderQueueIterator endIterator = _renderQueue.end();
-		RenderTicket *compareTicket = nullptr;
-		for (; it != endIterator; ++it) {
-			compareTicket = *it;
-			if (*(compareTicket) == compare && compareTicket->_isValid) {
-				if (_disableDirtyRects) {
-					drawFromSurface(compareTicket);
-				} else {
-					drawFromQueuedTicket(it);
-				}
-				return;
-			}
+		if (drawFromMatchingTicket(compare)) {
+			return;
 		}
 	}
-	RenderTicket *ticket = new RenderTicket(owner, surf, srcRect, dstRect, transform);
-	if (!_disableDirtyRects) {
-		drawFromTicket(ticket);
-	} else {
-		ticket->_wantsDraw = true;
-		_renderQueue.push_back(ticket);
-		drawFromSurface(ticket);
+	drawFromTicket(new RenderTicket(owner, surf, srcRect, dstRect, transform));
+}
+
+bool BaseRenderOSystem::drawFromMatchingTicket(const RenderTicket &compare) {
+	// Avoid calling size() and operator[] every time, when potentially going through
+	// LOTS of tickets.
+	RenderTicket *const *queue = _renderQueue.begin();
+	const uint queueSize = _renderQueue.size();
+	for (uint i = _lastFrameIndex + 1; i < queueSize; ++i) {
+		const RenderTicket *compareTicket = queue[i];
+		if (*compareTicket == compare && compareTicket->_isValid) {
+			drawFromQueuedTicket(i);
+			return true;
+		}
 	}
+	return false;
 }
 
 void BaseRenderOSystem::invalidateTicket(RenderTicket *renderTicket) {
@@ -320,10 +320,9 @@ void BaseRenderOSystem::invalidateTicket(RenderTicket *renderTicket) {
 }
 
 void BaseRenderOSystem::invalidateTicketsFromSurface(BaseSurfaceOSystem *surf) {
-	RenderQueueIterator it;
-	for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
-		if ((*it)->_owner == surf) {
-			invalidateTicket(*it);
+	for (uint i = 0; i < _renderQueue.size(); i++) {
+		if (_renderQueue[i]->_owner == surf) {
+			invalidateTicket(_renderQueue[i]);
 		}
 	}
 }
@@ -331,97 +330,152 @@ void BaseRenderOSystem::invalidateTicketsFromSurface(BaseSurfaceOSystem *surf) {
 void BaseRenderOSystem::drawFromTicket(RenderTicket *renderTicket) {
 	renderTicket->_wantsDraw = true;
 
-	++_lastFrameIter;
-	// In-order
-	if (_renderQueue.empty() || _lastFrameIter == _renderQueue.end()) {
-		_lastFrameIter--;
+	++_lastFrameIndex;
+	if ((uint)_lastFrameIndex == _renderQueue.size()) {
+		// In-order
 		_renderQueue.push_back(renderTicket);
-		++_lastFrameIter;
-		addDirtyRect(renderTicket->_dstRect);
 	} else {
 		// Before something
-		RenderQueueIterator pos = _lastFrameIter;
-		_renderQueue.insert(pos, renderTicket);
-		--_lastFrameIter;
-		addDirtyRect(renderTicket->_dstRect);
+		_renderQueue.insert_at(_lastFrameIndex, renderTicket);
 	}
+	addDirtyRect(renderTicket->_dstRect);
 }
 
-void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket) {
-	RenderTicket *renderTicket = *ticket;
+void BaseRenderOSystem::drawFromQueuedTicket(uint index) {
+	RenderTicket *renderTicket = _renderQueue[index];
 	assert(!renderTicket->_wantsDraw);
 	renderTicket->_wantsDraw = true;
 
-	++_lastFrameIter;
+	++_lastFrameIndex;
 	// Not in the same order?
-	if (*_lastFrameIter != renderTicket) {
-		--_lastFrameIter;
-		// Remove the ticket from the list
-		assert(*_lastFrameIter != renderTicket);
-		_renderQueue.erase(ticket);
+	if (_renderQueue[_lastFrameIndex] != renderTicket) {
+		--_lastFrameIndex;
+		// Remove the ticket from the queue
+		assert((int)index > _lastFrameIndex);
+		_renderQueue.remove_at(index);
 		// Is not in order, so readd it as if it was a new ticket
 		drawFromTicket(renderTicket);
 	}
 }
 
+static uint32 rectArea(const Common::Rect &rect) {
+	return rect.width() * rect.height();
+}
+
 void BaseRenderOSystem::addDirtyRect(const Common::Rect &rect) {
-	if (!_dirtyRect) {
-		_dirtyRect = new Common::Rect(rect);
-	} else {
-		_dirtyRect->extend(rect);
+	Common::Rect dirty(rect);
+	dirty.clip(_renderRect);
+	if (dirty.isEmpty()) {
+		return;
+	}
+
+	// Merge with the rects that it overlaps, or that are so close that
+	// drawing their bounding rect is cheaper than drawing both. This keeps
+	// the dirty rects disjoint.
+	uint i = 0;
+	while (i < _dirtyRects.size()) {
+		Common::Rect bounds(dirty);
+		bounds.extend(_dirtyRects[i]);
+		if (dirty.intersects(_dirtyRects[i]) || rectArea(bounds) <= rectArea(dirty) + rectArea(_dirtyRects[i]) + DIRTY_RECT_MERGE_SLACK) {
+			dirty = bounds;
+			_dirtyRects.remove_at(i);
+			// The rect grew, so the rects before this one need checking again
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	if (_dirtyRects.size() < DIRTY_RECT_LIMIT) {
+		_dirtyRects.push_back(dirty);
+		return;
 	}
-	_dirtyRect->clip(_renderRect);
+
+	// Too many rects, merge with the one that grows the least
+	uint best = 0;
+	uint32 bestGrowth = 0xFFFFFFFF;
+	for (i = 0; i < _dirtyRects.size(); i++) {
+		Common::Rect bounds(dirty);
+		bounds.extend(_dirtyRects[i]);
+		uint32 growth = rectArea(bounds) - rectArea(_dirtyRects[i]);
+		if (growth < bestGrowth) {
+			best = i;
+			bestGrowth = growth;
+		}
+	}
+	dirty.extend(_dirtyRects[best]);
+	_dirtyRects.remove_at(best);
+	addDirtyRect(dirty);
 }
 
 void BaseRenderOSystem::drawTickets() {
-	RenderQueueIterator it = _renderQueue.begin();
 	// Clean out the old tickets
 	// Note: We draw invalid tickets too, otherwise we wouldn't be honoring
 	// the draw request they obviously made BEFORE becoming invalid, either way
 	// we have a copy of their data, so their invalidness won't affect us.
-	while (it != _renderQueue.end()) {
-		if ((*it)->_wantsDraw == false) {
-			RenderTicket *ticket = *it;
-			addDirtyRect((*it)->_dstRect);
-			it = _renderQueue.erase(it);
+	uint kept = 0;
+	for (uint i = 0; i < _renderQueue.size(); i++) {
+		RenderTicket *ticket = _renderQueue[i];
+		if (ticket->_wantsDraw == false) {
+			addDirtyRect(ticket->_dstRect);
 			delete ticket;
 		} else {
-			++it;
+			_renderQueue[kept++] = ticket;
 		}
 	}
-	if (!_dirtyRect || _dirtyRect->width() == 0 || _dirtyRect->height() == 0) {
-		it = _renderQueue.begin();
-		while (it != _renderQueue.end()) {
-			RenderTicket *ticket = *it;
-			ticket->_wantsDraw = false;
-			++it;
+	_renderQueue.resize(kept);
+
+	_statDirtyPixels = _statTicketsDrawn = _statTicketsCulled = 0;
+
+	if (_dirtyRects.empty()) {
+		for (uint i = 0; i < _renderQueue.size(); i++) {
+			_renderQueue[i]->_wantsDraw = false;
 		}
 		return;
 	}
 
-	it = _renderQueue.begin();
-	_lastFrameIter = _renderQueue.end();
-	// A special case: If the screen has one giant OPAQUE rect to be drawn, then we skip filling
-	// the background color. Typical use-case: Fullscreen FMVs.
+	_lastFrameIndex = -1;
+
+	// Nothing below the topmost opaque ticket that covers a whole dirty rect
+	// is visible in it, so start drawing that rect from there. If there is
+	// such a ticket, we can also skip filling the rect with the clear-color.
+	// Typical use-case: Fullscreen FMVs.
 	// Caveat: The FPS-counter will invalidate this.
-	if (it != _lastFrameIter && _renderQueue.front() == _renderQueue.back() && (*it)->_transform._alphaDisable == true) {
-		// If our single opaque rect fills the dirty rect, we can skip filling.
-		if (*_dirtyRect != (*it)->_dstRect) {
+	uint firstTicket[DIRTY_RECT_LIMIT];
+	for (uint r = 0; r < _dirtyRects.size(); r++) {
+		const Common::Rect &dirtyRect = _dirtyRects[r];
+		firstTicket[r] = 0;
+		bool covered = false;
+		for (uint i = _renderQueue.size(); i-- > 0;) {
+			const RenderTicket *ticket = _renderQueue[i];
+			if (ticket->isOpaque() && ticket->_dstRect.contains(dirtyRect)) {
+				firstTicket[r] = i;
+				covered = true;
+				break;
+			}
+		}
+		if (!covered) {
 			// Apply the clear-color to the dirty rect.
-			_renderSurface->fillRect(*_dirtyRect, _clearColor);
+			_renderSurface->fillRect(dirtyRect, _clearColor);
 		}
-		// Otherwise Do NOT fill.
-	} else {
-		// Apply the clear-color to the dirty rect.
-		_renderSurface->fillRect(*_dirtyRect, _clearColor);
+		_statDirtyPixels += rectArea(dirtyRect);
 	}
-	for (; it != _renderQueue.end(); ++it) {
-		RenderTicket *ticket = *it;
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
+
+	for (uint i = 0; i < _renderQueue.size(); i++) {
+		RenderTicket *ticket = _renderQueue[i];
+		for (uint r = 0; r < _dirtyRects.size(); r++) {
+			const Common::Rect &dirtyRect = _dirtyRects[r];
+			if (!ticket->_dstRect.intersects(dirtyRect)) {
+				continue;
+			}
+			if (i < firstTicket[r]) {
+				_statTicketsCulled++;
+				continue;
+			}
 			// dstClip is the area we want redrawn.
 			Common::Rect dstClip(ticket->_dstRect);
 			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
+			dstClip.clip(dirtyRect);
 			// we need to keep track of the position to redraw the dirty rect
 			Common::Rect pos(dstClip);
 			int16 offsetX = ticket->_dstRect.left;
@@ -430,26 +484,30 @@ void BaseRenderOSystem::drawTickets() {
 			dstClip.translate(-offsetX, -offsetY);
 
 			drawFromSurface(ticket, &pos, &dstClip);
+			_statTicketsDrawn++;
 			_needsFlip = true;
 		}
 		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
 		ticket->_wantsDraw = false;
 	}
-	g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
 
-	it = _renderQueue.begin();
+	for (uint r = 0; r < _dirtyRects.size(); r++) {
+		const Common::Rect &dirtyRect = _dirtyRects[r];
+		g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(dirtyRect.left, dirtyRect.top), _renderSurface->pitch, dirtyRect.left, dirtyRect.top, dirtyRect.width(), dirtyRect.height());
+	}
+
 	// Clean out the old tickets
-	while (it != _renderQueue.end()) {
-		if ((*it)->_isValid == false) {
-			RenderTicket *ticket = *it;
-			addDirtyRect((*it)->_dstRect);
-			it = _renderQueue.erase(it);
+	kept = 0;
+	for (uint i = 0; i < _renderQueue.size(); i++) {
+		RenderTicket *ticket = _renderQueue[i];
+		if (ticket->_isValid == false) {
+			addDirtyRect(ticket->_dstRect);
 			delete ticket;
 		} else {
-			++it;
+			_renderQueue[kept++] = ticket;
 		}
 	}
-
+	_renderQueue.resize(kept);
 }
 
 // Replacement for SDL2's SDL_RenderCopy
@@ -565,22 +623,101 @@ void BaseRenderOSystem::endSaveLoad() {
 	BaseRenderer::endSaveLoad();
 
 	// Clear the scale-buffered tickets as we just loaded.
-	RenderQueueIterator it = _renderQueue.begin();
-	while (it != _renderQueue.end()) {
-		RenderTicket *ticket = *it;
-		it = _renderQueue.erase(it);
-		delete ticket;
+	for (uint i = 0; i < _renderQueue.size(); i++) {
+		delete _renderQueue[i];
 	}
+	_renderQueue.clear();
 	// HACK: After a save the buffer will be drawn before the scripts get to update it,
 	// so just skip this single frame.
 	_skipThisFrame = true;
-	_lastFrameIter = _renderQueue.end();
+	_lastFrameIndex = -1;
 
 	_renderSurface->fillRect(Common::Rect(0, 0, _renderSurface->h, _renderSurface->w), _renderSurface->format.ARGBToColor(255, 0, 0, 0));
 	g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 	g_system->updateScreen();
 }
 
+void BaseRenderOSystem::clearRecording() {
+	for (uint frame = 0; frame < _recording.size(); frame++) {
+		for (uint i = 0; i < _recording[frame].size(); i++) {
+			delete _recording[frame][i];
+		}
+	}
+	_recording.clear();
+	_recordFramesLeft = 0;
+}
+
+void BaseRenderOSystem::startRecording(uint frames) {
+	clearRecording();
+	if (frames) {
+		_recording.push_back(Common::Array<RenderTicket *>());
+		_recordFramesLeft = frames;
+	}
+}
+
+bool BaseRenderOSystem::replayRecording(uint iterations, ReplayStats &stats) {
+	memset(&stats, 0, sizeof(stats));
+	if (_recording.empty() || _recordFramesLeft || _disableDirtyRects) {
+		return false;
+	}
+
+	// Put the game's tickets aside, and start out from an empty screen
+	Common::Array<RenderTicket *> gameQueue = _renderQueue;
+	_renderQueue.clear();
+	_dirtyRects.clear();
+	addDirtyRect(_renderRect);
+	_lastFrameIndex = -1;
+
+	for (uint iteration = 0; iteration < iterations; iteration++) {
+		for (uint frame = 0; frame < _recording.size(); frame++) {
+			const Common::Array<RenderTicket *> &tickets = _recording[frame];
+			uint32 startTime = g_system->getMillis();
+
+			for (uint i = 0; i < tickets.size(); i++) {
+				const RenderTicket *recorded = tickets[i];
+				const Common::Rect &dstRect = recorded->_dstRect;
+				if ((dstRect.left < 0 && dstRect.right < 0) || (dstRect.top < 0 && dstRect.bottom < 0)) {
+					continue;
+				}
+				if (recorded->_owner && drawFromMatchingTicket(*recorded)) {
+					continue;
+				}
+				drawFromTicket(new RenderTicket(*recorded));
+			}
+
+			stats.dirtyRects += _dirtyRects.size();
+			drawTickets();
+			if (_needsFlip) {
+				_dirtyRects.clear();
+				_needsFlip = false;
+			}
+			_lastFrameIndex = -1;
+
+			uint32 frameTime = g_system->getMillis() - startTime;
+			stats.frames++;
+			stats.totalMillis += frameTime;
+			stats.maxMillis = MAX(stats.maxMillis, frameTime);
+			stats.dirtyPixels += _statDirtyPixels;
+			stats.ticketsDrawn += _statTicketsDrawn;
+			stats.ticketsCulled += _statTicketsCulled;
+		}
+	}
+
+	for (uint i = 0; i < _renderQueue.size(); i++) {
+		delete _renderQueue[i];
+	}
+	_renderQueue = gameQueue;
+
+	// Redraw everything in the next frame
+	for (uint i = 0; i < _renderQueue.size(); i++) {
+		_renderQueue[i]->_wantsDraw = false;
+	}
+	_dirtyRects.clear();
+	addDirtyRect(_renderRect);
+	_lastFrameIndex = -1;
+	return true;
+}
+
 bool BaseRenderOSystem::startSpriteBatch() {
 	return STATUS_OK;
 }
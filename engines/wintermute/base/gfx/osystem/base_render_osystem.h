@@ -32,7 +32,7 @@
 #include "engines/wintermute/base/gfx/base_renderer.h"
 #include "common/rect.h"
 #include "graphics/surface.h"
-#include "common/list.h"
+#include "common/array.h"
 #include "graphics/transform_struct.h"
 
 namespace Wintermute {
@@ -53,6 +53,11 @@ class RenderTicket;
  * being equal, this information is then used to check whether the draw order changed,
  * which will then create a need for redrawing, as we draw with an alpha-channel here.
  *
+ * The changed parts of the screen are tracked as a small set of disjoint dirty
+ * rects, so that changes in opposite corners of the screen don't cause everything
+ * in between to be redrawn. Tickets which are hidden behind an opaque ticket
+ * covering a whole dirty rect are not drawn in that rect.
+ *
  * There is also a draw path that draws without tickets, for debugging purposes,
  * as well as to accomodate situations with large enough amounts of draw calls,
  * that there will be too much overhead involved with comparing the generated tickets.
@@ -62,7 +67,18 @@ public:
 	BaseRenderOSystem(BaseGame *inGame);
 	~BaseRenderOSystem();
 
-	typedef Common::List<RenderTicket *>::iterator RenderQueueIterator;
+	/**
+	 * Statistics about the frames drawn by replayRecording().
+	 */
+	struct ReplayStats {
+		uint32 frames;
+		uint32 totalMillis;
+		uint32 maxMillis;
+		uint32 dirtyRects;
+		uint32 dirtyPixels;
+		uint32 ticketsDrawn;
+		uint32 ticketsCulled;
+	};
 
 	Common::String getName() const;
 
@@ -88,9 +104,26 @@ public:
 	/**
 	 * Re-insert an existing ticket into the queue, adding a dirty rect
 	 * out-of-order from last draw from the ticket.
-	 * @param ticket iterator pointing to the ticket to be added.
+	 * @param index position of the ticket in the queue.
+	 */
+	void drawFromQueuedTicket(uint index);
+
+	/**
+	 * Record the draw calls made during the next frames, so that they can
+	 * be replayed by replayRecording().
+	 * @param frames the number of frames to record.
 	 */
-	void drawFromQueuedTicket(const RenderQueueIterator &ticket);
+	void startRecording(uint frames);
+	uint getRecordedFrames() const { return _recording.size(); }
+	bool isRecording() const { return _recordFramesLeft != 0; }
+	/**
+	 * Draw the recorded frames again, measuring the time they take. The game's
+	 * own tickets are put aside meanwhile, and fully redrawn in the next frame.
+	 * @param iterations the number of times to replay the recording.
+	 * @param stats receives the statistics of the replayed frames.
+	 * @return false if there is no complete recording to replay.
+	 */
+	bool replayRecording(uint iterations, ReplayStats &stats);
 
 	bool setViewport(int left, int top, int right, int bottom) override;
 	bool setViewport(Rect32 *rect) override { return BaseRenderer::setViewport(rect); }
@@ -118,6 +151,12 @@ private:
 	 * @param rect the region to be marked as dirty
 	 */
 	void addDirtyRect(const Common::Rect &rect);
+	/**
+	 * Look for a ticket from last frame that is equal to the given one, and
+	 * if there is one, queue it again.
+	 * @return whether a matching ticket was found.
+	 */
+	bool drawFromMatchingTicket(const RenderTicket &compare);
 	/**
 	 * Traverse the tickets that are dirty, and draw them
 	 */
@@ -126,11 +165,22 @@ private:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
-	Common::Rect *_dirtyRect;
-	Common::List<RenderTicket *> _renderQueue;
+	void clearRecording();
+	Common::Array<Common::Rect> _dirtyRects;
+	Common::Array<RenderTicket *> _renderQueue;
 
 	bool _needsFlip;
-	RenderQueueIterator _lastFrameIter;
+	// Position in the queue of the last ticket drawn this frame, -1 if none
+	int _lastFrameIndex;
+
+	// Statistics of the last drawTickets() call
+	uint32 _statDirtyPixels;
+	uint32 _statTicketsDrawn;
+	uint32 _statTicketsCulled;
+
+	// Copies of the tickets drawn during the recorded frames
+	Common::Array<Common::Array<RenderTicket *> > _recording;
+	uint _recordFramesLeft;
 	Common::Rect _renderRect;
 	Graphics::Surface *_renderSurface;
 	Graphics::Surface *_blankSurface;
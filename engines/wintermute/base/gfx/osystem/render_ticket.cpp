@@ -41,6 +41,7 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 	_isValid(true),
 	_wantsDraw(true),
 	_transform(transform) {
+	_alphaType = owner ? owner->getAlphaType() : Graphics::ALPHA_FULL;
 	if (surf) {
 		_surface = new Graphics::Surface();
 		_surface->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
@@ -77,6 +78,22 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 	}
 }
 
+RenderTicket::RenderTicket(const RenderTicket &ticket) :
+	_dstRect(ticket._dstRect),
+	_isValid(ticket._isValid),
+	_wantsDraw(ticket._wantsDraw),
+	_transform(ticket._transform),
+	_owner(ticket._owner),
+	_srcRect(ticket._srcRect),
+	_alphaType(ticket._alphaType) {
+	if (ticket._surface) {
+		_surface = new Graphics::Surface();
+		_surface->copyFrom(*ticket._surface);
+	} else {
+		_surface = nullptr;
+	}
+}
+
 RenderTicket::~RenderTicket() {
 	if (_surface) {
 		_surface->free();
@@ -95,6 +112,29 @@ bool RenderTicket::operator==(const RenderTicket &t) const {
 	return true;
 }
 
+bool RenderTicket::isOpaque() const {
+	// Fade-tickets are owner-less, and always blended
+	if (!_owner || !_surface || !_transform._alphaDisable)
+		return false;
+	if (_transform._blendMode != Graphics::BLEND_NORMAL || _transform._rgbaMod != Graphics::kDefaultRgbaMod)
+		return false;
+	// Rotated surfaces don't fill their bounding box
+	if (_transform._angle != Graphics::kDefaultAngle)
+		return false;
+	return _surface->w * _transform._numTimesX >= _dstRect.width() &&
+	       _surface->h * _transform._numTimesY >= _dstRect.height();
+}
+
+void RenderTicket::setAlphaMode(Graphics::TransparentSurface &src) const {
+	if (_owner) {
+		if (_transform._alphaDisable) {
+			src.setAlphaMode(Graphics::ALPHA_OPAQUE);
+		} else {
+			src.setAlphaMode(_alphaType);
+		}
+	}
+}
+
 // Replacement for SDL2's SDL_RenderCopy
 void RenderTicket::drawToSurface(Graphics::Surface *_targetSurface) const {
 	Graphics::TransparentSurface src(*getSurface(), false);
@@ -103,13 +143,7 @@ void RenderTicket::drawToSurface(Graphics::Surface *_targetSurface) const {
 	clipRect.setWidth(getSurface()->w);
 	clipRect.setHeight(getSurface()->h);
 
-	if (_owner) {
-		if (_transform._alphaDisable) {
-			src.setAlphaMode(Graphics::ALPHA_OPAQUE);
-		} else {
-			src.setAlphaMode(_owner->getAlphaType());
-		}
-	}
+	setAlphaMode(src);
 
 	int y = _dstRect.top;
 	int w = _dstRect.width() / _transform._numTimesX;
@@ -135,13 +169,7 @@ void RenderTicket::drawToSurface(Graphics::Surface *_targetSurface, Common::Rect
 		clipRect->setHeight(getSurface()->h * _transform._numTimesY);
 	}
 
-	if (_owner) {
-		if (_transform._alphaDisable) {
-			src.setAlphaMode(Graphics::ALPHA_OPAQUE);
-		} else {
-			src.setAlphaMode(_owner->getAlphaType());
-		}
-	}
+	setAlphaMode(src);
 
 	if (_transform._numTimesX * _transform._numTimesY == 1) {
 
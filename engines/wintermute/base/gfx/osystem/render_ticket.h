@@ -52,6 +52,7 @@ class BaseSurfaceOSystem;
 class RenderTicket {
 public:
 	RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRest, Graphics::TransformStruct transform);
+	RenderTicket(const RenderTicket &ticket);
 	RenderTicket() : _isValid(true), _wantsDraw(false), _transform(Graphics::TransformStruct()) {}
 	~RenderTicket();
 	const Graphics::Surface *getSurface() const { return _surface; }
@@ -70,9 +71,18 @@ public:
 	BaseSurfaceOSystem *_owner;
 	bool operator==(const RenderTicket &a) const;
 	const Common::Rect *getSrcRect() const { return &_srcRect; }
+	/**
+	 * Whether drawing this ticket completely replaces what is below
+	 * its destination rect.
+	 */
+	bool isOpaque() const;
 private:
+	void setAlphaMode(Graphics::TransparentSurface &src) const;
+
 	Graphics::Surface *_surface;
 	Common::Rect _srcRect;
+	// The alpha type of the owner when the ticket was made
+	Graphics::AlphaType _alphaType;
 };
 
 } // End of namespace Wintermute
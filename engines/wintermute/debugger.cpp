@@ -25,12 +25,15 @@
 #include "engines/wintermute/base/base_engine.h"
 #include "engines/wintermute/base/base_file_manager.h"
 #include "engines/wintermute/base/base_game.h"
+#include "engines/wintermute/base/gfx/osystem/base_render_osystem.h"
 
 namespace Wintermute {
 
 Console::Console(WintermuteEngine *vm) : GUI::Debugger(), _engineRef(vm) {
 	registerCmd("show_fps", WRAP_METHOD(Console, Cmd_ShowFps));
 	registerCmd("dump_file", WRAP_METHOD(Console, Cmd_DumpFile));
+	registerCmd("record_frames", WRAP_METHOD(Console, Cmd_RecordFrames));
+	registerCmd("replay_frames", WRAP_METHOD(Console, Cmd_ReplayFrames));
 }
 
 Console::~Console(void) {
@@ -81,4 +84,38 @@ bool Console::Cmd_DumpFile(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::Cmd_RecordFrames(int argc, const char **argv) {
+	if (argc != 2) {
+		debugPrintf("Usage: %s <number of frames>\n", argv[0]);
+		debugPrintf("Records the draw calls of the following frames, for replaying them with replay_frames\n");
+		return true;
+	}
+
+	BaseRenderOSystem *renderer = static_cast<BaseRenderOSystem *>(_engineRef->_game->_renderer);
+	renderer->startRecording(atoi(argv[1]));
+	debugPrintf("Recording starts when the debugger is closed\n");
+	return true;
+}
+
+bool Console::Cmd_ReplayFrames(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Usage: %s [number of iterations]\n", argv[0]);
+		return true;
+	}
+
+	BaseRenderOSystem *renderer = static_cast<BaseRenderOSystem *>(_engineRef->_game->_renderer);
+	BaseRenderOSystem::ReplayStats stats;
+	if (!renderer->replayRecording(argc > 1 ? atoi(argv[1]) : 1, stats) || !stats.frames) {
+		debugPrintf("No complete recording to replay (dirty rects must be enabled)\n");
+		return true;
+	}
+
+	debugPrintf("Replayed %d frames in %d ms (%d ms average, %d ms maximum)\n",
+		stats.frames, stats.totalMillis, stats.totalMillis / stats.frames, stats.maxMillis);
+	debugPrintf("Per frame: %d dirty rects, %d dirty pixels, %d tickets drawn, %d tickets culled\n",
+		stats.dirtyRects / stats.frames, stats.dirtyPixels / stats.frames,
+		stats.ticketsDrawn / stats.frames, stats.ticketsCulled / stats.frames);
+	return true;
+}
+
 } // End of namespace Wintermute
@@ -35,6 +35,8 @@ public:
 
 	bool Cmd_ShowFps(int argc, const char **argv);
 	bool Cmd_DumpFile(int argc, const char **argv);
+	bool Cmd_RecordFrames(int argc, const char **argv);
+	bool Cmd_ReplayFrames(int argc, const char **argv);
 private:
 	WintermuteEngine *_engineRef;
 };
@@ -40,6 +40,9 @@ The meaning of these is masks is the following:
  kBytesPerPixel
     -> how many bytes per pixel for that format
 
+ PixelType
+    -> the unsigned integer type holding a pixel of that format
+
  kRedMask, kGreenMask, kBlueMask
     -> bitmask, and this with the color to select only the bits of the corresponding color
 
@@ -96,6 +99,8 @@ struct ColorMasks<565> {
 		kLow2Bits   = (3 << kRedShift) | (3 << kGreenShift) | (3 << kBlueShift),
 		kLow3Bits   = (7 << kRedShift) | (7 << kGreenShift) | (7 << kBlueShift)
 	};
+
+	typedef uint16 PixelType;
 };
 
 template<>
@@ -138,6 +143,8 @@ struct ColorMasks<555> {
 		kLow2Bits   = (3 << kRedShift) | (3 << kGreenShift) | (3 << kBlueShift),
 		kLow3Bits   = (7 << kRedShift) | (7 << kGreenShift) | (7 << kBlueShift)
 	};
+
+	typedef uint16 PixelType;
 };
 
 template<>
@@ -162,6 +169,8 @@ struct ColorMasks<1555> {
 
 		kRedBlueMask = kRedMask | kBlueMask
 	};
+
+	typedef uint16 PixelType;
 };
 
 template<>
@@ -186,6 +195,8 @@ struct ColorMasks<5551> {
 
 		kRedBlueMask = kRedMask | kBlueMask
 	};
+
+	typedef uint16 PixelType;
 };
 
 template<>
@@ -217,6 +228,8 @@ struct ColorMasks<4444> {
 
 		kRedBlueMask = kRedMask | kBlueMask
 	};
+
+	typedef uint16 PixelType;
 };
 
 template<>
@@ -241,6 +254,8 @@ struct ColorMasks<888> {
 
 		kRedBlueMask = kRedMask | kBlueMask
 	};
+
+	typedef uint32 PixelType;
 };
 
 template<>
@@ -265,6 +280,8 @@ struct ColorMasks<8888> {
 
 		kRedBlueMask = kRedMask | kBlueMask
 	};
+
+	typedef uint32 PixelType;
 };
 
 #ifdef __WII__
@@ -291,6 +308,8 @@ struct ColorMasks<3444> {
 
 		kRedBlueMask = kRedMask | kBlueMask
 	};
+
+	typedef uint16 PixelType;
 };
 #endif
 
@@ -35,6 +35,11 @@ Common::Rect Font::getBoundingBox(uint32 chr) const {
 	return Common::Rect(getCharWidth(chr), getFontHeight());
 }
 
+void Font::drawChars(Surface *dst, const uint32 *chars, const int *xPos, uint count, int y, uint32 color) const {
+	for (uint i = 0; i < count; ++i)
+		drawChar(dst, chars[i], xPos[i], y, color);
+}
+
 namespace {
 
 template<class StringType>
@@ -107,6 +112,13 @@ void drawStringImpl(const Font &font, Surface *dst, const StringType &str, int x
 		x = x + w - width;
 	x += deltax;
 
+	// The visible characters are handed to the font in runs, so that it can
+	// draw them in one go.
+	enum { kRunSize = 64 };
+	uint32 runChars[kRunSize];
+	int runPos[kRunSize];
+	uint runLength = 0;
+
 	typename StringType::unsigned_type last = 0;
 	for (typename StringType::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
 		const typename StringType::unsigned_type cur = *i;
@@ -115,10 +127,21 @@ void drawStringImpl(const Font &font, Surface *dst, const StringType &str, int x
 		w = font.getCharWidth(cur);
 		if (x+w > rightX)
 			break;
-		if (x+w >= leftX)
-			font.drawChar(dst, cur, x, y, color);
+		if (x+w >= leftX) {
+			if (runLength == kRunSize) {
+				font.drawChars(dst, runChars, runPos, runLength, y, color);
+				runLength = 0;
+			}
+
+			runChars[runLength] = cur;
+			runPos[runLength] = x;
+			++runLength;
+		}
 		x += w;
 	}
+
+	if (runLength)
+		font.drawChars(dst, runChars, runPos, runLength, y, color);
 }
 
 template<class StringType>
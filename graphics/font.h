@@ -142,6 +142,23 @@ public:
 	 */
 	virtual void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const = 0;
 
+	/**
+	 * Draw a run of characters, which drawString has already laid out on
+	 * a single line.
+	 *
+	 * The default implementation simply calls drawChar for every
+	 * character. Fonts can override this when drawing several characters
+	 * at once is faster.
+	 *
+	 * @param dst   The surface to drawn on.
+	 * @param chars The characters to draw.
+	 * @param xPos  The x coordinate of every character.
+	 * @param count The number of characters.
+	 * @param y     The y coordinate where to draw the characters.
+	 * @param color The color of the characters.
+	 */
+	virtual void drawChars(Surface *dst, const uint32 *chars, const int *xPos, uint count, int y, uint32 color) const;
+
 	// TODO: Add doxygen comments to this
 	void drawString(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = true) const;
 	void drawString(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft) const;
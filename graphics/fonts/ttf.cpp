@@ -33,6 +33,7 @@
 
 #include "common/singleton.h"
 #include "common/stream.h"
+#include "common/array.h"
 #include "common/hashmap.h"
 
 #include <ft2build.h>
@@ -114,6 +115,8 @@ public:
 	virtual Common::Rect getBoundingBox(uint32 chr) const;
 
 	virtual void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const;
+
+	virtual void drawChars(Surface *dst, const uint32 *chars, const int *xPos, uint count, int y, uint32 color) const;
 private:
 	bool _initialized;
 	FT_Face _face;
@@ -125,17 +128,94 @@ private:
 	int _ascent, _descent;
 
 	struct Glyph {
-		Surface image;
+		Glyph() : xOffset(0), yOffset(0), width(0), height(0), advance(0), slot(0), page(-1), x(0), y(0),
+		    chr(0), missing(false), referenced(false) {}
+
 		int xOffset, yOffset;
+		int width, height;
 		int advance;
 		FT_UInt slot;
+
+		/**
+		 * The atlas page holding the image of the glyph, or -1 in case the
+		 * image needs to be rendered (again).
+		 */
+		int page;
+		int x, y;
+
+		/** The character of the glyph, in case it was loaded after the font. */
+		uint32 chr;
+
+		/** Whether the font has no glyph for the character. */
+		bool missing;
+
+		/** Whether the glyph was used since the clock hand last passed it. */
+		bool referenced;
+	};
+
+	/**
+	 * The glyph images are packed into a few big pages, row by row. The
+	 * pages, which hold the glyphs loaded along with the font, are never
+	 * evicted. Glyphs loaded later go to at most kMaxCachePages pages. When
+	 * these are full, the least recently used page is emptied.
+	 */
+	struct AtlasPage {
+		Surface image;
+		int rowX, rowY, rowHeight;
+		bool pinned;
+		uint32 lastUse;
+		Common::Array<int> glyphs;
 	};
 
-	bool cacheGlyph(Glyph &glyph, uint32 chr) const;
-	typedef Common::HashMap<uint32, Glyph> GlyphCache;
-	mutable GlyphCache _glyphs;
+	enum {
+		kMaxCachePages = 4,
+		kMinPageSize = 256,
+		kMaxLateGlyphs = 2048,
+		kKerningCacheBits = 10,
+
+		kNoGlyph = -1
+	};
+
+	bool cacheGlyph(Glyph &glyph, uint32 chr, int index) const;
+	int allocateLateGlyph() const;
+	bool renderGlyph(Glyph &glyph, int index) const;
+	int allocateGlyphArea(int width, int height, int &x, int &y) const;
+	const Glyph *getGlyph(uint32 chr) const;
+	const Glyph *getRenderedGlyph(uint32 chr) const;
+	void drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color) const;
+
+	mutable Common::Array<Glyph> _glyphs;
+	mutable Common::Array<AtlasPage> _pages;
+	mutable int _pinnedPage, _cachePage;
+	mutable uint32 _useCounter;
+	bool _pinNewGlyphs;
+	int _pageSize;
+
+	/** Index of the glyph of every code point below 256, or kNoGlyph. */
+	int _latin1Glyphs[256];
+	typedef Common::HashMap<uint32, int> GlyphIndex;
+	mutable GlyphIndex _glyphIndex;
 	bool _allowLateCaching;
-	void assureCached(uint32 chr) const;
+
+	/**
+	 * Glyphs loaded after the font follow the ones loaded with it, in at
+	 * most kMaxLateGlyphs entries. These only hold the metrics, the images
+	 * are bounded by the cache pages. Once all entries are in use, they are
+	 * reused in clock order, passing over the glyphs used since the last
+	 * round once.
+	 */
+	uint _lateGlyphStart;
+	mutable uint _clockHand;
+
+	/**
+	 * Kerning offsets indexed by a hash of the glyph slots of both
+	 * characters. A new pair only replaces the pair it collides with.
+	 */
+	struct KerningEntry {
+		FT_UInt left, right;
+		int offset;
+	};
+	mutable KerningEntry _kerningCache[1 << kKerningCacheBits];
 
 	FT_Int32 _loadFlags;
 	FT_Render_Mode _renderMode;
@@ -144,8 +224,14 @@ private:
 
 TTFFont::TTFFont()
     : _initialized(false), _face(), _ttfFile(0), _size(0), _width(0), _height(0), _ascent(0),
-      _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
-      _hasKerning(false), _allowLateCaching(false) {
+      _descent(0), _pinnedPage(-1), _cachePage(-1), _useCounter(0), _pinNewGlyphs(false),
+      _pageSize(kMinPageSize), _allowLateCaching(false), _lateGlyphStart(0), _clockHand(0),
+      _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL), _hasKerning(false) {
+	for (uint i = 0; i < 256; ++i)
+		_latin1Glyphs[i] = kNoGlyph;
+
+	// Glyph slot 0 is never looked up, thus it marks unused entries.
+	memset(_kerningCache, 0, sizeof(_kerningCache));
 }
 
 TTFFont::~TTFFont() {
@@ -155,11 +241,11 @@ TTFFont::~TTFFont() {
 		delete[] _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
+
+	for (uint i = 0; i < _pages.size(); ++i)
+		_pages[i].image.free();
 }
 
 bool TTFFont::load(Common::SeekableReadStream &stream, int size, uint dpi, TTFRenderMode renderMode, const uint32 *mapping) {
@@ -231,14 +317,22 @@ bool TTFFont::load(Common::SeekableReadStream &stream, int size, uint dpi, TTFRe
 	_width = ftCeil26_6(FT_MulFix(_face->max_advance_width, _face->size->metrics.x_scale));
 	_height = _ascent - _descent + 1;
 
+	// Make sure a page holds a decent number of glyphs, even for big fonts.
+	_pageSize = MAX<int>(kMinPageSize, 4 * MAX(_width, _height));
+
+	// The glyphs loaded here are always kept.
+	_pinNewGlyphs = true;
+
 	if (!mapping) {
 		// Allow loading of all unicode characters.
 		_allowLateCaching = true;
 
 		// Load all ISO-8859-1 characters.
 		for (uint i = 0; i < 256; ++i) {
-			if (!cacheGlyph(_glyphs[i], i)) {
-				_glyphs.erase(i);
+			Glyph glyph;
+			if (cacheGlyph(glyph, i, _glyphs.size())) {
+				_latin1Glyphs[i] = _glyphs.size();
+				_glyphs.push_back(glyph);
 			}
 		}
 	} else {
@@ -250,14 +344,19 @@ bool TTFFont::load(Common::SeekableReadStream &stream, int size, uint dpi, TTFRe
 			const bool isRequired = (mapping[i] & 0x80000000) != 0;
 			// Check whether loading an important glyph fails and error out if
 			// that is the case.
-			if (!cacheGlyph(_glyphs[i], unicode)) {
-				_glyphs.erase(i);
-				if (isRequired)
-					return false;
+			Glyph glyph;
+			if (cacheGlyph(glyph, unicode, _glyphs.size())) {
+				_latin1Glyphs[i] = _glyphs.size();
+				_glyphs.push_back(glyph);
+			} else if (isRequired) {
+				return false;
 			}
 		}
 	}
 
+	_pinNewGlyphs = false;
+	_lateGlyphStart = _glyphs.size();
+
 	_initialized = (_glyphs.size() != 0);
 	return _initialized;
 }
@@ -271,63 +370,59 @@ int TTFFont::getMaxCharWidth() const {
 }
 
 int TTFFont::getCharWidth(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph)
 		return 0;
 	else
-		return glyphEntry->_value.advance;
+		return glyph->advance;
 }
 
 int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!_hasKerning)
 		return 0;
 
-	assureCached(left);
-	assureCached(right);
-
-	FT_UInt leftGlyph, rightGlyph;
-	GlyphCache::const_iterator glyphEntry;
-
-	glyphEntry = _glyphs.find(left);
-	if (glyphEntry != _glyphs.end()) {
-		leftGlyph = glyphEntry->_value.slot;
-	} else {
+	// Looking up the right glyph may add glyphs, thus copy the slot first.
+	const Glyph *glyph = getGlyph(left);
+	if (!glyph)
 		return 0;
-	}
+	const FT_UInt leftGlyph = glyph->slot;
 
-	glyphEntry = _glyphs.find(right);
-	if (glyphEntry != _glyphs.end()) {
-		rightGlyph = glyphEntry->_value.slot;
-	} else {
+	glyph = getGlyph(right);
+	if (!glyph)
 		return 0;
-	}
+	const FT_UInt rightGlyph = glyph->slot;
 
 	if (!leftGlyph || !rightGlyph)
 		return 0;
 
+	// Multiplicative hashing, the top bits are mixed best.
+	const uint32 hash = (uint32)(leftGlyph * 31 + rightGlyph) * 2654435761U;
+	KerningEntry &entry = _kerningCache[hash >> (32 - kKerningCacheBits)];
+	if (entry.left == leftGlyph && entry.right == rightGlyph)
+		return entry.offset;
+
 	FT_Vector kerningVector;
 	FT_Get_Kerning(_face, leftGlyph, rightGlyph, FT_KERNING_DEFAULT, &kerningVector);
-	return (kerningVector.x / 64);
+
+	entry.left = leftGlyph;
+	entry.right = rightGlyph;
+	entry.offset = kerningVector.x / 64;
+	return entry.offset;
 }
 
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end()) {
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph) {
 		return Common::Rect();
 	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
-		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
+		return Common::Rect(glyph->xOffset, glyph->yOffset, glyph->xOffset + glyph->width, glyph->yOffset + glyph->height);
 	}
 }
 
 namespace {
 
 template<typename ColorType>
-void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos, const int srcPitch, const int w, const int h, ColorType color, const PixelFormat &dstFormat) {
+void blendGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos, const int srcPitch, const int w, const int h, ColorType color, const PixelFormat &dstFormat) {
 	uint8 sR, sG, sB;
 	dstFormat.colorToRGB(color, sR, sG, sB);
 
@@ -363,13 +458,22 @@ void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos, const i
 } // End of anonymous namespace
 
 void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
-		return;
+	const Glyph *glyph = getRenderedGlyph(chr);
+	if (glyph)
+		drawGlyph(dst, *glyph, x, y, color);
+}
 
-	const Glyph &glyph = glyphEntry->_value;
+void TTFFont::drawChars(Surface *dst, const uint32 *chars, const int *xPos, uint count, int y, uint32 color) const {
+	// This saves a virtual call per character. The glyphs of characters
+	// below 256 are found without a hash lookup.
+	for (uint i = 0; i < count; ++i) {
+		const Glyph *glyph = getRenderedGlyph(chars[i]);
+		if (glyph)
+			drawGlyph(dst, *glyph, xPos[i], y, color);
+	}
+}
 
+void TTFFont::drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color) const {
 	x += glyph.xOffset;
 	y += glyph.yOffset;
 
@@ -378,10 +482,14 @@ void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) con
 	if (y > dst->h)
 		return;
 
-	int w = glyph.image.w;
-	int h = glyph.image.h;
+	int w = glyph.width;
+	int h = glyph.height;
 
-	const uint8 *srcPos = (const uint8 *)glyph.image.getPixels();
+	if (w <= 0 || h <= 0)
+		return;
+
+	const Surface &image = _pages[glyph.page].image;
+	const uint8 *srcPos = (const uint8 *)image.getBasePtr(glyph.x, glyph.y);
 
 	// Make sure we are not drawing outside the screen bounds
 	if (x < 0) {
@@ -397,7 +505,7 @@ void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) con
 		return;
 
 	if (y < 0) {
-		srcPos -= y * glyph.image.pitch;
+		srcPos -= y * image.pitch;
 		h += y;
 		y = 0;
 	}
@@ -426,26 +534,115 @@ void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) con
 			}
 
 			dstPos += dst->pitch;
-			srcPos += glyph.image.pitch;
+			srcPos += image.pitch;
 		}
 	} else if (dst->format.bytesPerPixel == 2) {
-		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
+		blendGlyph<uint16>(dstPos, dst->pitch, srcPos, image.pitch, w, h, color, dst->format);
 	} else if (dst->format.bytesPerPixel == 4) {
-		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
+		blendGlyph<uint32>(dstPos, dst->pitch, srcPos, image.pitch, w, h, color, dst->format);
 	}
 }
 
-bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
+const TTFFont::Glyph *TTFFont::getGlyph(uint32 chr) const {
+	int index;
+
+	if (chr < 256) {
+		index = _latin1Glyphs[chr];
+	} else {
+		GlyphIndex::const_iterator entry = _glyphIndex.find(chr);
+		if (entry != _glyphIndex.end()) {
+			index = entry->_value;
+		} else if (!_allowLateCaching) {
+			return 0;
+		} else {
+			index = allocateLateGlyph();
+
+			// Remember missing glyphs too, so FreeType is only asked once.
+			Glyph &glyph = _glyphs[index];
+			glyph.chr = chr;
+			glyph.missing = !cacheGlyph(glyph, chr, index);
+
+			_glyphIndex[chr] = index;
+		}
+	}
+
+	if (index == kNoGlyph)
+		return 0;
+
+	Glyph &glyph = _glyphs[index];
+	glyph.referenced = true;
+	return glyph.missing ? 0 : &glyph;
+}
+
+int TTFFont::allocateLateGlyph() const {
+	if (_glyphs.size() < _lateGlyphStart + kMaxLateGlyphs) {
+		_glyphs.push_back(Glyph());
+		return _glyphs.size() - 1;
+	}
+
+	// Skip the glyphs used since the last round. After a full round, all
+	// glyphs are unreferenced, so this ends.
+	int index;
+	while (true) {
+		index = _lateGlyphStart + _clockHand;
+		_clockHand = (_clockHand + 1) % kMaxLateGlyphs;
+
+		if (!_glyphs[index].referenced)
+			break;
+		_glyphs[index].referenced = false;
+	}
+
+	Glyph &glyph = _glyphs[index];
+	_glyphIndex.erase(glyph.chr);
+
+	// Its atlas page must not mark the new glyph as evicted later on.
+	if (glyph.page >= 0) {
+		Common::Array<int> &pageGlyphs = _pages[glyph.page].glyphs;
+		for (uint i = 0; i < pageGlyphs.size(); ++i) {
+			if (pageGlyphs[i] == index) {
+				pageGlyphs.remove_at(i);
+				break;
+			}
+		}
+	}
+
+	glyph = Glyph();
+	return index;
+}
+
+const TTFFont::Glyph *TTFFont::getRenderedGlyph(uint32 chr) const {
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph || !glyph->width || !glyph->height)
+		return glyph;
+
+	if (glyph->page < 0) {
+		// The image was evicted, render it again.
+		Glyph &evicted = _glyphs[glyph - _glyphs.begin()];
+		if (!renderGlyph(evicted, glyph - _glyphs.begin()))
+			return 0;
+	}
+
+	_pages[glyph->page].lastUse = ++_useCounter;
+	return glyph;
+}
+
+bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr, int index) const {
 	FT_UInt slot = FT_Get_Char_Index(_face, chr);
 	if (!slot)
 		return false;
 
 	glyph.slot = slot;
 
+	return renderGlyph(glyph, index);
+}
+
+bool TTFFont::renderGlyph(Glyph &glyph, int index) const {
+	glyph.page = -1;
+
 	// We use the light target and render mode to improve the looks of the
 	// glyphs. It is most noticable in FreeSansBold.ttf, where otherwise the
 	// 't' glyph looks like it is cut off on the right side.
-	if (FT_Load_Glyph(_face, slot, _loadFlags))
+	if (FT_Load_Glyph(_face, glyph.slot, _loadFlags))
 		return false;
 
 	if (FT_Render_Glyph(_face->glyph, _renderMode))
@@ -460,7 +657,22 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	glyph.advance = ftCeil26_6(_face->glyph->advance.x);
 
 	const FT_Bitmap &bitmap = _face->glyph->bitmap;
-	glyph.image.create(bitmap.width, bitmap.rows, PixelFormat::createFormatCLUT8());
+	if (bitmap.pixel_mode != FT_PIXEL_MODE_MONO && bitmap.pixel_mode != FT_PIXEL_MODE_GRAY) {
+		warning("TTFFont::renderGlyph: Unsupported pixel mode %d", bitmap.pixel_mode);
+		return false;
+	}
+
+	glyph.width = bitmap.width;
+	glyph.height = bitmap.rows;
+
+	// Glyphs like spaces have no image.
+	if (!glyph.width || !glyph.height)
+		return true;
+
+	glyph.page = allocateGlyphArea(glyph.width, glyph.height, glyph.x, glyph.y);
+	_pages[glyph.page].glyphs.push_back(index);
+
+	Surface &image = _pages[glyph.page].image;
 
 	const uint8 *src = bitmap.buffer;
 	int srcPitch = bitmap.pitch;
@@ -469,8 +681,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		srcPitch = -srcPitch;
 	}
 
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
-	memset(dst, 0, glyph.image.h * glyph.image.pitch);
+	uint8 *dst = (uint8 *)image.getBasePtr(glyph.x, glyph.y);
 
 	switch (bitmap.pixel_mode) {
 	case FT_PIXEL_MODE_MONO:
@@ -482,13 +693,12 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 				if ((x % 8) == 0)
 					mask = *curSrc++;
 
-				if (mask & 0x80)
-					*dst = 255;
+				dst[x] = (mask & 0x80) ? 255 : 0;
 
 				mask <<= 1;
-				++dst;
 			}
 
+			dst += image.pitch;
 			src += srcPitch;
 		}
 		break;
@@ -496,29 +706,80 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	case FT_PIXEL_MODE_GRAY:
 		for (int y = 0; y < (int)bitmap.rows; ++y) {
 			memcpy(dst, src, bitmap.width);
-			dst += glyph.image.pitch;
+			dst += image.pitch;
 			src += srcPitch;
 		}
 		break;
-
-	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap.pixel_mode);
-		glyph.image.free();
-		return false;
 	}
 
 	return true;
 }
 
-void TTFFont::assureCached(uint32 chr) const {
-	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
-		return;
+int TTFFont::allocateGlyphArea(int width, int height, int &x, int &y) const {
+	int &current = _pinNewGlyphs ? _pinnedPage : _cachePage;
+
+	if (current >= 0) {
+		AtlasPage &page = _pages[current];
+
+		// Start a new row when the glyph does not fit into the current one.
+		if (page.rowX + width > page.image.w) {
+			page.rowX = 0;
+			page.rowY += page.rowHeight;
+			page.rowHeight = 0;
+		}
+
+		if (page.rowX + width <= page.image.w && page.rowY + height <= page.image.h) {
+			x = page.rowX;
+			y = page.rowY;
+			page.rowX += width;
+			page.rowHeight = MAX(page.rowHeight, height);
+			return current;
+		}
 	}
 
-	Glyph newGlyph;
-	if (cacheGlyph(newGlyph, chr)) {
-		_glyphs[chr] = newGlyph;
+	// The current page is full. Either add a new page or reuse the least
+	// recently used cache page.
+	int cachePages = 0;
+	int leastRecentlyUsed = -1;
+	for (uint i = 0; i < _pages.size(); ++i) {
+		if (_pages[i].pinned)
+			continue;
+
+		++cachePages;
+		if (leastRecentlyUsed < 0 || _pages[i].lastUse < _pages[leastRecentlyUsed].lastUse)
+			leastRecentlyUsed = i;
 	}
+
+	const int pageWidth = MAX(_pageSize, width);
+	const int pageHeight = MAX(_pageSize, height);
+
+	if (_pinNewGlyphs || cachePages < kMaxCachePages) {
+		current = _pages.size();
+		_pages.push_back(AtlasPage());
+		_pages[current].pinned = _pinNewGlyphs;
+	} else {
+		current = leastRecentlyUsed;
+
+		AtlasPage &page = _pages[current];
+		for (uint i = 0; i < page.glyphs.size(); ++i)
+			_glyphs[page.glyphs[i]].page = -1;
+		page.glyphs.clear();
+	}
+
+	AtlasPage &page = _pages[current];
+	if (page.image.w < pageWidth || page.image.h < pageHeight) {
+		page.image.free();
+		page.image.create(pageWidth, pageHeight, PixelFormat::createFormatCLUT8());
+	}
+
+	page.lastUse = _useCounter;
+	page.rowX = width;
+	page.rowY = 0;
+	page.rowHeight = height;
+
+	x = 0;
+	y = 0;
+	return current;
 }
 
 Font *loadTTFFont(Common::SeekableReadStream &stream, int size, uint dpi, TTFRenderMode renderMode, const uint32 *mapping) {
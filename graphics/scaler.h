@@ -27,6 +27,12 @@
 #include "graphics/surface.h"
 
 extern void InitScalers(uint32 BitFormat);
+
+/**
+ * Init the scaler subsystem for the given pixel format. Besides 16 bit
+ * formats, the scalers handle 32 bit formats with 8 bits per channel.
+ */
+extern void InitScalers(const Graphics::PixelFormat &format);
 extern void DestroyScalers();
 
 typedef void ScalerProc(const uint8 *srcPtr, uint32 srcPitch,
@@ -62,6 +68,14 @@ DECLARE_SCALER(HQ3x);
 
 #endif // #ifdef USE_SCALERS
 
+/**
+ * Extend a rect of changed source pixels by the pixels around it, whose
+ * scaled output may change as well. Most scalers look at the neighbors of
+ * every pixel. The aspect ratio correction interpolates every line with
+ * the one above it, so it always needs one more line on either side.
+ */
+extern void extendScalerRect(ScalerProc *scalerProc, bool aspectRatioCorrection, int &x, int &y, int &w, int &h);
+
 // creates a 160x100 thumbnail for 320x200 games
 // and 160x120 thumbnail for 320x240 and 640x480 games
 // only 565 mode
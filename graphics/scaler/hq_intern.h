@@ -0,0 +1,237 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_SCALER_HQ_INTERN_H
+#define GRAPHICS_SCALER_HQ_INTERN_H
+
+#include "graphics/scaler/intern.h"
+#include "graphics/pixelformat.h"
+#include "common/simd.h"
+
+// See scaler.cpp
+#if defined(USE_NASM) && !defined(_WIN32) && !defined(MACOSX) && !defined(__OS2__)
+#define RGBtoYUV _RGBtoYUV
+#endif
+
+extern "C" uint32 *RGBtoYUV;
+extern Graphics::PixelFormat gPixelFormat;
+
+/**
+ * The YUV values of three consecutive source rows, as used by the hq
+ * scalers to find the edges around each pixel. Every row is converted
+ * once instead of looking up all nine neighbours of every pixel, and
+ * covers the pixels from x = -1 to x = width. One more entry is kept as
+ * padding for the four wide loads done by hqPattern().
+ */
+class HQYUVRows {
+public:
+	HQYUVRows(int width) : _width(width), _pitch(width + 3) {
+		_buffer = (uint32 *)malloc(3 * _pitch * sizeof(uint32));
+		for (int i = 0; i < 3; ++i) {
+			_rows[i] = _buffer + i * _pitch;
+			_rows[i][_pitch - 1] = 0;
+		}
+	}
+
+	~HQYUVRows() {
+		free(_buffer);
+	}
+
+	/**
+	 * Convert the row above, the row of and the row below the given
+	 * source pointer.
+	 */
+	template<typename Pixel>
+	void start(const Pixel *p, uint32 nextlineSrc) {
+		convertRow(p - nextlineSrc, _rows[0]);
+		convertRow(p, _rows[1]);
+		convertRow(p + nextlineSrc, _rows[2]);
+	}
+
+	/**
+	 * Move on to the next row. p points to the start of the new current
+	 * row, so only the one below it needs to be converted.
+	 */
+	template<typename Pixel>
+	void next(const Pixel *p, uint32 nextlineSrc) {
+		uint32 *oldest = _rows[0];
+		_rows[0] = _rows[1];
+		_rows[1] = _rows[2];
+		_rows[2] = oldest;
+		convertRow(p + nextlineSrc, _rows[2]);
+	}
+
+	/** The YUV value of pixel x in the row above; x can be -1. */
+	const uint32 *above() const { return _rows[0] + 1; }
+	const uint32 *current() const { return _rows[1] + 1; }
+	const uint32 *below() const { return _rows[2] + 1; }
+
+private:
+	void convertRow(const uint16 *src, uint32 *dst) {
+		for (int x = -1; x <= _width; ++x)
+			dst[x + 1] = RGBtoYUV[src[x]];
+	}
+
+	void convertRow(const uint32 *src, uint32 *dst);
+
+	const int _width;
+	const int _pitch;
+	uint32 *_buffer;
+	uint32 *_rows[3];
+};
+
+static inline uint32 convertPixelToYUV(uint32 color, const Graphics::PixelFormat &format) {
+	const int r = (color >> format.rShift) & 0xFF;
+	const int g = (color >> format.gShift) & 0xFF;
+	const int b = (color >> format.bShift) & 0xFF;
+	const int Y = (r + g + b) >> 2;
+	const int u = 128 + ((r - b) >> 2);
+	const int v = 128 + ((-r + 2 * g - b) >> 3);
+	return (Y << 16) | (u << 8) | v;
+}
+
+/**
+ * Computes the same values as InitLUT() does for 16 bit pixels. 32 bit
+ * pixels have too many colors for a lookup table.
+ */
+inline void HQYUVRows::convertRow(const uint32 *src, uint32 *dst) {
+	const Graphics::PixelFormat &format = gPixelFormat;
+	int x = -1;
+
+#if defined(SCUMMVM_SSE2)
+	const __m128i rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(format.bShift);
+	const __m128i channelMask = _mm_set1_epi32(0xFF);
+	const __m128i bias = _mm_set1_epi32(128);
+
+	for (; x + 4 <= _width + 1; x += 4) {
+		const __m128i c = _mm_loadu_si128((const __m128i *)(src + x));
+		const __m128i r = _mm_and_si128(_mm_srl_epi32(c, rShift), channelMask);
+		const __m128i g = _mm_and_si128(_mm_srl_epi32(c, gShift), channelMask);
+		const __m128i b = _mm_and_si128(_mm_srl_epi32(c, bShift), channelMask);
+
+		const __m128i Y = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(r, g), b), 2);
+		const __m128i u = _mm_add_epi32(bias, _mm_srai_epi32(_mm_sub_epi32(r, b), 2));
+		const __m128i v = _mm_add_epi32(bias, _mm_srai_epi32(_mm_sub_epi32(_mm_add_epi32(g, g), _mm_add_epi32(r, b)), 3));
+
+		const __m128i yuv = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(Y, 16), _mm_slli_epi32(u, 8)), v);
+		_mm_storeu_si128((__m128i *)(dst + x + 1), yuv);
+	}
+#elif defined(SCUMMVM_NEON)
+	const int32x4_t rShift = vdupq_n_s32(-format.rShift);
+	const int32x4_t gShift = vdupq_n_s32(-format.gShift);
+	const int32x4_t bShift = vdupq_n_s32(-format.bShift);
+	const uint32x4_t channelMask = vdupq_n_u32(0xFF);
+	const int32x4_t bias = vdupq_n_s32(128);
+
+	for (; x + 4 <= _width + 1; x += 4) {
+		const uint32x4_t c = vld1q_u32(src + x);
+		const int32x4_t r = vreinterpretq_s32_u32(vandq_u32(vshlq_u32(c, rShift), channelMask));
+		const int32x4_t g = vreinterpretq_s32_u32(vandq_u32(vshlq_u32(c, gShift), channelMask));
+		const int32x4_t b = vreinterpretq_s32_u32(vandq_u32(vshlq_u32(c, bShift), channelMask));
+
+		const int32x4_t Y = vshrq_n_s32(vaddq_s32(vaddq_s32(r, g), b), 2);
+		const int32x4_t u = vaddq_s32(bias, vshrq_n_s32(vsubq_s32(r, b), 2));
+		const int32x4_t v = vaddq_s32(bias, vshrq_n_s32(vsubq_s32(vaddq_s32(g, g), vaddq_s32(r, b)), 3));
+
+		const int32x4_t yuv = vorrq_s32(vorrq_s32(vshlq_n_s32(Y, 16), vshlq_n_s32(u, 8)), v);
+		vst1q_u32(dst + x + 1, vreinterpretq_u32_s32(yuv));
+	}
+#endif
+
+	for (; x <= _width; ++x)
+		dst[x + 1] = convertPixelToYUV(src[x], format);
+}
+
+#ifdef SCUMMVM_NEON
+/**
+ * Returns a bit mask of the lanes in which any channel is further apart
+ * from the center pixel than the threshold.
+ */
+static inline uint32 hqDiffers(uint32x4_t row, uint8x16_t yuv5, uint8x16_t threshold) {
+	static const uint32 laneBits[4] = { 1, 2, 4, 8 };
+	const uint32x4_t excess = vreinterpretq_u32_u8(vqsubq_u8(vabdq_u8(vreinterpretq_u8_u32(row), yuv5), threshold));
+	const uint32x4_t bits = vandq_u32(vtstq_u32(excess, excess), vld1q_u32(laneBits));
+#ifdef __aarch64__
+	return vaddvq_u32(bits);
+#else
+	const uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+	return vget_lane_u32(vpadd_u32(sum, sum), 0);
+#endif
+}
+#endif
+
+/**
+ * Compute the pattern of neighbours which differ noticeably from the
+ * center pixel w5. Bits 0 to 7 stand for w1, w2, w3, w4, w6, w7, w8 and
+ * w9. The pointers refer to the YUV values of the pixels above, at and
+ * below the center pixel.
+ */
+static inline int hqPattern(const uint32 *above, const uint32 *current, const uint32 *below) {
+#if defined(SCUMMVM_SSE2)
+	// Same thresholds as in diffYUV()
+	const __m128i threshold = _mm_set1_epi32(0x00300706);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i yuv5 = _mm_set1_epi32(current[0]);
+
+	const __m128i row1 = _mm_loadu_si128((const __m128i *)(above - 1));
+	const __m128i row2 = _mm_loadu_si128((const __m128i *)(current - 1));
+	const __m128i row3 = _mm_loadu_si128((const __m128i *)(below - 1));
+
+	// The absolute difference of every channel, minus the threshold. Lanes
+	// which end up as zero are similar to the center pixel.
+#define HQ_DIFFERS(row) \
+	(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_subs_epu8( \
+		_mm_or_si128(_mm_subs_epu8(row, yuv5), _mm_subs_epu8(yuv5, row)), threshold), zero))) ^ 0xF)
+
+	const int differs1 = HQ_DIFFERS(row1);
+	const int differs2 = HQ_DIFFERS(row2);
+	const int differs3 = HQ_DIFFERS(row3);
+#undef HQ_DIFFERS
+
+	return (differs1 & 0x07) | ((differs2 & 0x01) << 3) | ((differs2 & 0x04) << 2) | ((differs3 & 0x07) << 5);
+#elif defined(SCUMMVM_NEON)
+	const uint8x16_t threshold = vreinterpretq_u8_u32(vdupq_n_u32(0x00300706));
+	const uint8x16_t yuv5 = vreinterpretq_u8_u32(vdupq_n_u32(current[0]));
+
+	const uint32 differs1 = hqDiffers(vld1q_u32(above - 1), yuv5, threshold);
+	const uint32 differs2 = hqDiffers(vld1q_u32(current - 1), yuv5, threshold);
+	const uint32 differs3 = hqDiffers(vld1q_u32(below - 1), yuv5, threshold);
+
+	return (differs1 & 0x07) | ((differs2 & 0x01) << 3) | ((differs2 & 0x04) << 2) | ((differs3 & 0x07) << 5);
+#else
+	const int yuv5 = current[0];
+	int pattern = 0;
+	if (diffYUV(yuv5, above[-1])) pattern |= 0x0001;
+	if (diffYUV(yuv5, above[0])) pattern |= 0x0002;
+	if (diffYUV(yuv5, above[1])) pattern |= 0x0004;
+	if (diffYUV(yuv5, current[-1])) pattern |= 0x0008;
+	if (diffYUV(yuv5, current[1])) pattern |= 0x0010;
+	if (diffYUV(yuv5, below[-1])) pattern |= 0x0020;
+	if (diffYUV(yuv5, below[0])) pattern |= 0x0040;
+	if (diffYUV(yuv5, below[1])) pattern |= 0x0080;
+	return pattern;
+#endif
+}
+
+#endif
@@ -179,6 +179,80 @@ static inline unsigned interpolate16_1_1_1_1(unsigned p1, unsigned p2, unsigned
 	return ((p1+p2+p3+p4) - lowbits) >> 2;
 }
 
+/**
+ * Interpolate up to four 32 bit pixels with 8 bits per channel, i.e.,
+ * (w1*p1+w2*p2+w3*p3+w4*p4) >> shift. The weights must add up to 1 << shift,
+ * which must not exceed 256. Two channels are interpolated at once, the
+ * channel order does not matter.
+ */
+template<int w1, int w2, int w3, int w4, int shift>
+static inline uint32 interpolate32Channels(uint32 p1, uint32 p2, uint32 p3, uint32 p4) {
+	const uint32 rb = ((p1 & 0x00FF00FF) * w1 + (p2 & 0x00FF00FF) * w2
+	                 + (p3 & 0x00FF00FF) * w3 + (p4 & 0x00FF00FF) * w4) >> shift;
+	const uint32 ag = (((p1 >> 8) & 0x00FF00FF) * w1 + ((p2 >> 8) & 0x00FF00FF) * w2
+	                 + ((p3 >> 8) & 0x00FF00FF) * w3 + ((p4 >> 8) & 0x00FF00FF) * w4) >> shift;
+	return (rb & 0x00FF00FF) | ((ag & 0x00FF00FF) << 8);
+}
+
+// The tricks used above for 16 bit pixels need spare bits above every
+// channel, which 32 bit pixels don't have. Those are interpolated channel
+// by channel instead, for every scaler using the functions above.
+
+template<>
+inline unsigned interpolate16_1_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2) {
+	return interpolate32Channels<1, 1, 0, 0, 1>(p1, p2, 0, 0);
+}
+
+template<>
+inline unsigned interpolate16_3_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2) {
+	return interpolate32Channels<3, 1, 0, 0, 2>(p1, p2, 0, 0);
+}
+
+template<>
+inline unsigned interpolate16_5_3<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2) {
+	return interpolate32Channels<5, 3, 0, 0, 3>(p1, p2, 0, 0);
+}
+
+template<>
+inline unsigned interpolate16_7_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2) {
+	return interpolate32Channels<7, 1, 0, 0, 3>(p1, p2, 0, 0);
+}
+
+template<>
+inline unsigned interpolate16_2_1_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Channels<2, 1, 1, 0, 2>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_5_2_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Channels<5, 2, 1, 0, 3>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_6_1_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Channels<6, 1, 1, 0, 3>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_2_3_3<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Channels<2, 3, 3, 0, 3>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_2_7_7<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Channels<2, 7, 7, 0, 4>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_14_1_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3) {
+	return interpolate32Channels<14, 1, 1, 0, 4>(p1, p2, p3, 0);
+}
+
+template<>
+inline unsigned interpolate16_1_1_1_1<Graphics::ColorMasks<8888> >(unsigned p1, unsigned p2, unsigned p3, unsigned p4) {
+	return interpolate32Channels<1, 1, 1, 1, 2>(p1, p2, p3, p4);
+}
+
 /**
  * Compare two YUV values (encoded 8-8-8) and check if they differ by more than
  * a certain hard coded threshold. Used by the hq scaler family.
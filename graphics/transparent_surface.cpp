@@ -31,6 +31,7 @@
 #include "common/endian.h"
 #include "common/util.h"
 #include "common/rect.h"
+#include "common/simd.h"
 #include "common/math.h"
 #include "common/textconsole.h"
 #include "graphics/primitives.h"
@@ -66,6 +67,13 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+void doBlitOpaqueSIMD(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
+void doBlitBinarySIMD(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
+void doBlitAlphaBlendSIMD(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
+void doBlitAdditiveBlendSIMD(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
+void doBlitSubtractiveBlendSIMD(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
+#endif
 
 TransparentSurface::TransparentSurface() : Surface(), _alphaMode(ALPHA_FULL) {}
 
@@ -304,19 +312,19 @@ void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height,
 
 				out[kAIndex] = 255;
 				if (cb != 255) {
-					out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * cb  * (out[kBIndex]) * in[kAIndex]) >> 24), 0);
+					out[kBIndex] = MAX<int>(out[kBIndex] - (((uint32)in[kBIndex] * cb * out[kBIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kBIndex] = MAX(out[kBIndex] - (in[kBIndex] * (out[kBIndex]) * in[kAIndex] >> 16), 0);
 				}
 
 				if (cg != 255) {
-					out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * cg  * (out[kGIndex]) * in[kAIndex]) >> 24), 0);
+					out[kGIndex] = MAX<int>(out[kGIndex] - (((uint32)in[kGIndex] * cg * out[kGIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kGIndex] = MAX(out[kGIndex] - (in[kGIndex] * (out[kGIndex]) * in[kAIndex] >> 16), 0);
 				}
 
 				if (cr != 255) {
-					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * cr * (out[kRIndex]) * in[kAIndex]) >> 24), 0);
+					out[kRIndex] = MAX<int>(out[kRIndex] - (((uint32)in[kRIndex] * cr * out[kRIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kRIndex] = MAX(out[kRIndex] - (in[kRIndex] * (out[kRIndex]) * in[kAIndex] >> 16), 0);
 				}
@@ -330,6 +338,289 @@ void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height,
 	}
 }
 
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+
+/*
+ * Vectorized versions of the blitters above, which handle four pixels at a
+ * time. They produce exactly the same results as the scalar versions, which
+ * are used for the remaining pixels of each row.
+ *
+ * Pixels are kept as 16 bytes, or widened to eight 16 bit lanes (two pixels)
+ * for the arithmetic. In both cases, the alpha component comes first.
+ */
+
+namespace {
+
+#if defined(SCUMMVM_SSE2)
+
+typedef __m128i Pixels;
+typedef __m128i Wide;
+
+inline Pixels loadPixels(const byte *in, int32 inStep) {
+	if (inStep > 0)
+		return _mm_loadu_si128((const __m128i *)in);
+	// Horizontally flipped: the next pixels come before this one
+	Pixels p = _mm_loadu_si128((const __m128i *)(in - 12));
+	return _mm_shuffle_epi32(p, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+inline void storePixels(byte *out, Pixels p) { _mm_storeu_si128((__m128i *)out, p); }
+
+inline Pixels alphaMask() { return _mm_set1_epi32(0xFF << (kAIndex * 8)); }
+inline Pixels orPixels(Pixels a, Pixels b) { return _mm_or_si128(a, b); }
+inline Pixels addSaturate(Pixels a, Pixels b) { return _mm_adds_epu8(a, b); }
+inline Pixels subPixels(Pixels a, Pixels b) { return _mm_sub_epi8(a, b); }
+
+// All bits set for the pixels with an alpha of 0
+inline Pixels transparentMask(Pixels p) {
+	return _mm_cmpeq_epi32(_mm_and_si128(p, alphaMask()), _mm_setzero_si128());
+}
+
+inline Pixels selectPixels(Pixels mask, Pixels a, Pixels b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+inline Wide widenLo(Pixels p) { return _mm_unpacklo_epi8(p, _mm_setzero_si128()); }
+inline Wide widenHi(Pixels p) { return _mm_unpackhi_epi8(p, _mm_setzero_si128()); }
+inline Pixels narrow(Wide lo, Wide hi) { return _mm_packus_epi16(lo, hi); }
+
+// Lanes in memory order, repeated for both pixels
+inline Wide wideConst(uint16 a, uint16 b, uint16 g, uint16 r) {
+	return _mm_set_epi16(r, g, b, a, r, g, b, a);
+}
+
+inline Wide splat(uint16 v) { return _mm_set1_epi16(v); }
+inline Wide add(Wide a, Wide b) { return _mm_add_epi16(a, b); }
+inline Wide sub(Wide a, Wide b) { return _mm_sub_epi16(a, b); }
+inline Wide mul(Wide a, Wide b) { return _mm_mullo_epi16(a, b); }
+// (a * b) >> 16, for unsigned lanes
+inline Wide mulHi(Wide a, Wide b) { return _mm_mulhi_epu16(a, b); }
+inline Wide shr8(Wide a) { return _mm_srli_epi16(a, 8); }
+
+// Copies the alpha lane of each pixel to its other lanes
+inline Wide broadcastAlpha(Wide a) {
+	a = _mm_shufflelo_epi16(a, _MM_SHUFFLE(kAIndex, kAIndex, kAIndex, kAIndex));
+	return _mm_shufflehi_epi16(a, _MM_SHUFFLE(kAIndex, kAIndex, kAIndex, kAIndex));
+}
+
+#elif defined(SCUMMVM_NEON)
+
+typedef uint8x16_t Pixels;
+typedef uint16x8_t Wide;
+
+inline Pixels loadPixels(const byte *in, int32 inStep) {
+	if (inStep > 0)
+		return vld1q_u8(in);
+	// Horizontally flipped: the next pixels come before this one
+	uint32x4_t p = vrev64q_u32(vreinterpretq_u32_u8(vld1q_u8(in - 12)));
+	return vreinterpretq_u8_u32(vcombine_u32(vget_high_u32(p), vget_low_u32(p)));
+}
+
+inline void storePixels(byte *out, Pixels p) { vst1q_u8(out, p); }
+
+inline Pixels alphaMask() { return vreinterpretq_u8_u32(vdupq_n_u32(0xFF << (kAIndex * 8))); }
+inline Pixels orPixels(Pixels a, Pixels b) { return vorrq_u8(a, b); }
+inline Pixels addSaturate(Pixels a, Pixels b) { return vqaddq_u8(a, b); }
+inline Pixels subPixels(Pixels a, Pixels b) { return vsubq_u8(a, b); }
+
+// All bits set for the pixels with an alpha of 0
+inline Pixels transparentMask(Pixels p) {
+	uint32x4_t alpha = vandq_u32(vreinterpretq_u32_u8(p), vreinterpretq_u32_u8(alphaMask()));
+	return vreinterpretq_u8_u32(vceqq_u32(alpha, vdupq_n_u32(0)));
+}
+
+inline Pixels selectPixels(Pixels mask, Pixels a, Pixels b) { return vbslq_u8(mask, a, b); }
+
+inline Wide widenLo(Pixels p) { return vmovl_u8(vget_low_u8(p)); }
+inline Wide widenHi(Pixels p) { return vmovl_u8(vget_high_u8(p)); }
+inline Pixels narrow(Wide lo, Wide hi) { return vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi)); }
+
+// Lanes in memory order, repeated for both pixels
+inline Wide wideConst(uint16 a, uint16 b, uint16 g, uint16 r) {
+	const uint16 lanes[8] = { a, b, g, r, a, b, g, r };
+	return vld1q_u16(lanes);
+}
+
+inline Wide splat(uint16 v) { return vdupq_n_u16(v); }
+inline Wide add(Wide a, Wide b) { return vaddq_u16(a, b); }
+inline Wide sub(Wide a, Wide b) { return vsubq_u16(a, b); }
+inline Wide mul(Wide a, Wide b) { return vmulq_u16(a, b); }
+// (a * b) >> 16, for unsigned lanes
+inline Wide mulHi(Wide a, Wide b) {
+	uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(a), vget_low_u16(b)), 16);
+	uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(a), vget_high_u16(b)), 16);
+	return vcombine_u16(lo, hi);
+}
+inline Wide shr8(Wide a) { return vshrq_n_u16(a, 8); }
+
+// Copies the alpha lane of each pixel to its other lanes
+inline Wide broadcastAlpha(Wide a) {
+	return vcombine_u16(vdup_lane_u16(vget_low_u16(a), kAIndex), vdup_lane_u16(vget_high_u16(a), kAIndex));
+}
+
+#endif
+
+// Color modulation factors as used by the additive and subtractive blitters:
+// 256 leaves the component unchanged when used with mulHi(), unlike 255.
+inline uint16 modFactor(byte c) {
+	return c == 255 ? 256 : c;
+}
+
+} // End of anonymous namespace
+
+void doBlitOpaqueSIMD(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	const Pixels opaque = alphaMask();
+	const uint32 width4 = width & ~3;
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		for (uint32 j = 0; j < width4; j += 4) {
+			storePixels(out, orPixels(loadPixels(in, inStep), opaque));
+			in += inStep * 4;
+			out += 16;
+		}
+		if (width4 < width)
+			doBlitOpaqueFast(in, out, width - width4, 1, pitch, inStep, inoStep);
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+void doBlitBinarySIMD(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	const Pixels opaque = alphaMask();
+	const uint32 width4 = width & ~3;
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		for (uint32 j = 0; j < width4; j += 4) {
+			Pixels src = loadPixels(in, inStep);
+			Pixels dst = loadPixels(out, 4);
+			storePixels(out, selectPixels(transparentMask(src), dst, orPixels(src, opaque)));
+			in += inStep * 4;
+			out += 16;
+		}
+		if (width4 < width)
+			doBlitBinaryFast(in, out, width - width4, 1, pitch, inStep, inoStep);
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+void doBlitAlphaBlendSIMD(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	const Pixels opaque = alphaMask();
+	const uint32 width4 = width & ~3;
+	const bool modulated = (color != 0xffffffff);
+	const Wide alphaMod = splat((color >> kAModShift) & 0xFF);
+	const Wide colorMod = wideConst(0, (color >> kBModShift) & 0xFF, (color >> kGModShift) & 0xFF, (color >> kRModShift) & 0xFF);
+	const Wide full = splat(255);
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		for (uint32 j = 0; j < width4; j += 4) {
+			Pixels src = loadPixels(in, inStep);
+			Pixels dst = loadPixels(out, 4);
+			Wide srcLo = widenLo(src), srcHi = widenHi(src);
+			Wide dstLo = widenLo(dst), dstHi = widenHi(dst);
+			Wide alphaLo = broadcastAlpha(srcLo), alphaHi = broadcastAlpha(srcHi);
+			Pixels result;
+
+			if (!modulated) {
+				// (in * a + out * (255 - a)) >> 8, keeping fully transparent pixels
+				Wide lo = shr8(add(mul(srcLo, alphaLo), mul(dstLo, sub(full, alphaLo))));
+				Wide hi = shr8(add(mul(srcHi, alphaHi), mul(dstHi, sub(full, alphaHi))));
+				result = selectPixels(transparentMask(src), dst, orPixels(narrow(lo, hi), opaque));
+			} else {
+				// (out * (255 - ina) >> 8) + (in * ina * c >> 16)
+				alphaLo = shr8(mul(alphaLo, alphaMod));
+				alphaHi = shr8(mul(alphaHi, alphaMod));
+				Wide lo = add(shr8(mul(dstLo, sub(full, alphaLo))), mulHi(mul(srcLo, alphaLo), colorMod));
+				Wide hi = add(shr8(mul(dstHi, sub(full, alphaHi))), mulHi(mul(srcHi, alphaHi), colorMod));
+				result = orPixels(narrow(lo, hi), opaque);
+			}
+
+			storePixels(out, result);
+			in += inStep * 4;
+			out += 16;
+		}
+		if (width4 < width)
+			doBlitAlphaBlend(in, out, width - width4, 1, pitch, inStep, inoStep, color);
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+void doBlitAdditiveBlendSIMD(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	const uint32 width4 = width & ~3;
+	const bool modulated = (color != 0xffffffff);
+	const Wide alphaMod = splat((color >> kAModShift) & 0xFF);
+	const Wide colorMod = wideConst(0, modFactor((color >> kBModShift) & 0xFF), modFactor((color >> kGModShift) & 0xFF), modFactor((color >> kRModShift) & 0xFF));
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		for (uint32 j = 0; j < width4; j += 4) {
+			Pixels src = loadPixels(in, inStep);
+			Wide srcLo = widenLo(src), srcHi = widenHi(src);
+			Wide alphaLo = broadcastAlpha(srcLo), alphaHi = broadcastAlpha(srcHi);
+
+			if (modulated) {
+				alphaLo = shr8(mul(alphaLo, alphaMod));
+				alphaHi = shr8(mul(alphaHi, alphaMod));
+			}
+
+			// min(out + (in * ina * c >> 16), 255), the alpha of out is kept
+			Wide lo = mulHi(mul(srcLo, alphaLo), colorMod);
+			Wide hi = mulHi(mul(srcHi, alphaHi), colorMod);
+			storePixels(out, addSaturate(loadPixels(out, 4), narrow(lo, hi)));
+			in += inStep * 4;
+			out += 16;
+		}
+		if (width4 < width)
+			doBlitAdditiveBlend(in, out, width - width4, 1, pitch, inStep, inoStep, color);
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+void doBlitSubtractiveBlendSIMD(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	const Pixels opaque = alphaMask();
+	const uint32 width4 = width & ~3;
+	const bool modulated = (color != 0xffffffff);
+	const Wide colorMod = modulated ?
+		wideConst(0, modFactor((color >> kBModShift) & 0xFF), modFactor((color >> kGModShift) & 0xFF), modFactor((color >> kRModShift) & 0xFF)) :
+		wideConst(0, 256, 256, 256);
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		for (uint32 j = 0; j < width4; j += 4) {
+			Pixels src = loadPixels(in, inStep);
+			Pixels dst = loadPixels(out, 4);
+			Wide srcLo = widenLo(src), srcHi = widenHi(src);
+
+			// out - (in * c * out * a >> 24), which never goes below zero
+			Wide lo = shr8(mulHi(mul(srcLo, colorMod), mul(widenLo(dst), broadcastAlpha(srcLo))));
+			Wide hi = shr8(mulHi(mul(srcHi, colorMod), mul(widenHi(dst), broadcastAlpha(srcHi))));
+			Pixels result = subPixels(dst, narrow(lo, hi));
+			if (modulated)
+				result = orPixels(result, opaque);
+
+			storePixels(out, result);
+			in += inStep * 4;
+			out += 16;
+		}
+		if (width4 < width)
+			doBlitSubtractiveBlend(in, out, width - width4, 1, pitch, inStep, inoStep, color);
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+#endif
+
 Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height, TSpriteBlendMode blendMode) {
 
 	Common::Rect retSize;
@@ -435,6 +726,26 @@ Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int p
 		byte *ino = (byte *)img->getBasePtr(xp, yp);
 		byte *outo = (byte *)target.getBasePtr(posX, posY);
 
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
+			// The scalar version copies whole rows, even when flipped
+			if (inStep > 0)
+				doBlitOpaqueSIMD(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
+			else
+				doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
+		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
+			doBlitBinarySIMD(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
+		} else {
+			if (blendMode == BLEND_ADDITIVE) {
+				doBlitAdditiveBlendSIMD(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
+			} else if (blendMode == BLEND_SUBTRACTIVE) {
+				doBlitSubtractiveBlendSIMD(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
+			} else {
+				assert(blendMode == BLEND_NORMAL);
+				doBlitAlphaBlendSIMD(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
+			}
+		}
+#else
 		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
 			doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
 		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
@@ -449,6 +760,7 @@ Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int p
 				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
 			}
 		}
+#endif
 
 	}
 
@@ -83,6 +83,9 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/endian.h"
+#include "common/util.h"
+#include "common/simd.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
@@ -196,6 +199,219 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
 
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+
+/*
+ * Vectorized versions of the converters below, which handle eight pixels at
+ * a time. Instead of going through the lookup tables, they compute the same
+ * values in 16 bit lanes: the truncated chroma products of the color tables,
+ * the clamping and luminance scaling of the rgbToPix table, and the channel
+ * shifts of PixelFormat::RGBToColor(). The results are identical to the
+ * scalar code, which handles the pixels left over at the end of each row.
+ */
+
+namespace {
+
+// ((a << 1) * M) >> 16 gives the magnitude of the color table products for
+// a = |c - 128|, truncated like the (int16) casts do. The sign of c - 128 is
+// applied afterwards.
+static const uint16 kCrRMul = 45901; // 0.419 / 0.299
+static const uint16 kCrGMul = 23386; // 0.299 / 0.419
+static const uint16 kCbGMul = 11283; // 0.114 / 0.331
+static const uint16 kCbBMul = 58110; // 0.587 / 0.331
+
+// x * 255 / 219 is x + ((x * 10774) >> 16), for x in [0, 219]
+static const uint16 kITUMul = 10774;
+
+#if defined(SCUMMVM_SSE2)
+
+typedef __m128i Lanes;
+typedef __m128i Shift;
+
+inline Lanes loadBytes(const byte *src) { return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128()); }
+
+// Each of the first or last four lanes, repeated for two lanes
+inline Lanes duplicateLo(Lanes a) { return _mm_unpacklo_epi16(a, a); }
+inline Lanes duplicateHi(Lanes a) { return _mm_unpackhi_epi16(a, a); }
+
+// Two values, each repeated for four lanes
+inline Lanes loadFourTimes(const int16 *src) {
+	const Lanes w = _mm_cvtsi32_si128(READ_UINT32(src));
+	return _mm_unpacklo_epi32(_mm_unpacklo_epi16(w, w), _mm_unpacklo_epi16(w, w));
+}
+
+inline Lanes lanes(int16 a, int16 b, int16 c, int16 d, int16 e, int16 f, int16 g, int16 h) { return _mm_setr_epi16(a, b, c, d, e, f, g, h); }
+inline Lanes splat(int16 v) { return _mm_set1_epi16(v); }
+inline Lanes add(Lanes a, Lanes b) { return _mm_add_epi16(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return _mm_sub_epi16(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return _mm_mullo_epi16(a, b); }
+inline Lanes clamp(Lanes a, Lanes max) { return _mm_min_epi16(_mm_max_epi16(a, _mm_setzero_si128()), max); }
+// (a * b) >> 16, for unsigned lanes
+inline Lanes mulHi(Lanes a, Lanes b) { return _mm_mulhi_epu16(a, b); }
+inline Lanes shr4(Lanes a) { return _mm_srli_epi16(a, 4); }
+// All bits set for the negative lanes
+inline Lanes signMask(Lanes a) { return _mm_srai_epi16(a, 15); }
+// Negates the lanes with all bits set in the mask
+inline Lanes applySign(Lanes a, Lanes sign) { return _mm_sub_epi16(_mm_xor_si128(a, sign), sign); }
+
+inline Shift makeShift(int count) { return _mm_cvtsi32_si128(count); }
+
+inline Lanes shiftChannel(Lanes c, Shift loss, Shift shift) { return _mm_sll_epi16(_mm_srl_epi16(c, loss), shift); }
+
+inline void storePixels(uint16 *dst, Lanes r, Lanes g, Lanes b, const Shift *loss, const Shift *shift, uint32 alpha) {
+	Lanes p = _mm_or_si128(_mm_set1_epi16((int16)alpha), shiftChannel(r, loss[0], shift[0]));
+	p = _mm_or_si128(p, shiftChannel(g, loss[1], shift[1]));
+	p = _mm_or_si128(p, shiftChannel(b, loss[2], shift[2]));
+	_mm_storeu_si128((__m128i *)dst, p);
+}
+
+inline void storePixels(uint32 *dst, Lanes r, Lanes g, Lanes b, const Shift *loss, const Shift *shift, uint32 alpha) {
+	const Lanes zero = _mm_setzero_si128();
+	r = _mm_srl_epi16(r, loss[0]);
+	g = _mm_srl_epi16(g, loss[1]);
+	b = _mm_srl_epi16(b, loss[2]);
+
+	Lanes lo = _mm_or_si128(_mm_set1_epi32((int32)alpha), _mm_sll_epi32(_mm_unpacklo_epi16(r, zero), shift[0]));
+	lo = _mm_or_si128(lo, _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), shift[1]));
+	lo = _mm_or_si128(lo, _mm_sll_epi32(_mm_unpacklo_epi16(b, zero), shift[2]));
+	Lanes hi = _mm_or_si128(_mm_set1_epi32((int32)alpha), _mm_sll_epi32(_mm_unpackhi_epi16(r, zero), shift[0]));
+	hi = _mm_or_si128(hi, _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), shift[1]));
+	hi = _mm_or_si128(hi, _mm_sll_epi32(_mm_unpackhi_epi16(b, zero), shift[2]));
+	_mm_storeu_si128((__m128i *)dst, lo);
+	_mm_storeu_si128((__m128i *)(dst + 4), hi);
+}
+
+#elif defined(SCUMMVM_NEON)
+
+typedef int16x8_t Lanes;
+typedef int16 Shift;
+
+inline Lanes loadBytes(const byte *src) { return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src))); }
+
+// Each of the first or last four lanes, repeated for two lanes
+inline Lanes duplicateLo(Lanes a) { return vzipq_s16(a, a).val[0]; }
+inline Lanes duplicateHi(Lanes a) { return vzipq_s16(a, a).val[1]; }
+
+// Two values, each repeated for four lanes
+inline Lanes loadFourTimes(const int16 *src) {
+	return vcombine_s16(vdup_n_s16(src[0]), vdup_n_s16(src[1]));
+}
+
+inline Lanes lanes(int16 a, int16 b, int16 c, int16 d, int16 e, int16 f, int16 g, int16 h) {
+	const int16 values[8] = { a, b, c, d, e, f, g, h };
+	return vld1q_s16(values);
+}
+
+inline Lanes splat(int16 v) { return vdupq_n_s16(v); }
+inline Lanes add(Lanes a, Lanes b) { return vaddq_s16(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return vsubq_s16(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return vmulq_s16(a, b); }
+inline Lanes clamp(Lanes a, Lanes max) { return vminq_s16(vmaxq_s16(a, vdupq_n_s16(0)), max); }
+// (a * b) >> 16, for unsigned lanes
+inline Lanes mulHi(Lanes a, Lanes b) {
+	const uint16x8_t ua = vreinterpretq_u16_s16(a), ub = vreinterpretq_u16_s16(b);
+	const uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(ua), vget_low_u16(ub)), 16);
+	const uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(ua), vget_high_u16(ub)), 16);
+	return vreinterpretq_s16_u16(vcombine_u16(lo, hi));
+}
+inline Lanes shr4(Lanes a) { return vreinterpretq_s16_u16(vshrq_n_u16(vreinterpretq_u16_s16(a), 4)); }
+// All bits set for the negative lanes
+inline Lanes signMask(Lanes a) { return vshrq_n_s16(a, 15); }
+// Negates the lanes with all bits set in the mask
+inline Lanes applySign(Lanes a, Lanes sign) { return vsubq_s16(veorq_s16(a, sign), sign); }
+
+inline Shift makeShift(int count) { return count; }
+
+inline uint16x8_t shiftChannel(Lanes c, Shift loss, Shift shift) {
+	return vshlq_u16(vshlq_u16(vreinterpretq_u16_s16(c), vdupq_n_s16(-loss)), vdupq_n_s16(shift));
+}
+
+inline void storePixels(uint16 *dst, Lanes r, Lanes g, Lanes b, const Shift *loss, const Shift *shift, uint32 alpha) {
+	uint16x8_t p = vorrq_u16(vdupq_n_u16((uint16)alpha), shiftChannel(r, loss[0], shift[0]));
+	p = vorrq_u16(p, shiftChannel(g, loss[1], shift[1]));
+	p = vorrq_u16(p, shiftChannel(b, loss[2], shift[2]));
+	vst1q_u16(dst, p);
+}
+
+inline void storePixels(uint32 *dst, Lanes r, Lanes g, Lanes b, const Shift *loss, const Shift *shift, uint32 alpha) {
+	const uint16x8_t c[3] = { shiftChannel(r, loss[0], 0), shiftChannel(g, loss[1], 0), shiftChannel(b, loss[2], 0) };
+	uint32x4_t lo = vdupq_n_u32(alpha), hi = vdupq_n_u32(alpha);
+	for (int i = 0; i < 3; i++) {
+		lo = vorrq_u32(lo, vshlq_u32(vmovl_u16(vget_low_u16(c[i])), vdupq_n_s32(shift[i])));
+		hi = vorrq_u32(hi, vshlq_u32(vmovl_u16(vget_high_u16(c[i])), vdupq_n_s32(shift[i])));
+	}
+	vst1q_u32(dst, lo);
+	vst1q_u32(dst + 4, hi);
+}
+
+#endif
+
+/** The chroma contribution to each channel, as the color tables give it. */
+struct ChromaLanes {
+	Lanes r, g, b;
+};
+
+// trunc(k * c) for the chroma values c - 128
+inline Lanes chromaProduct(Lanes doubleAbs, Lanes sign, uint16 multiplier) {
+	return applySign(mulHi(doubleAbs, splat((int16)multiplier)), sign);
+}
+
+inline ChromaLanes convertChroma(Lanes u, Lanes v) {
+	u = sub(u, splat(128));
+	v = sub(v, splat(128));
+	const Lanes uSign = signMask(u), vSign = signMask(v);
+	const Lanes uAbs = applySign(u, uSign), vAbs = applySign(v, vSign);
+	const Lanes uDoubleAbs = add(uAbs, uAbs), vDoubleAbs = add(vAbs, vAbs);
+
+	ChromaLanes chroma;
+	chroma.r = chromaProduct(vDoubleAbs, vSign, kCrRMul);
+	chroma.g = sub(splat(0), add(chromaProduct(vDoubleAbs, vSign, kCrGMul), chromaProduct(uDoubleAbs, uSign, kCbGMul)));
+	chroma.b = chromaProduct(uDoubleAbs, uSign, kCbBMul);
+	return chroma;
+}
+
+/** What the rgbToPix table of a YUVToRGBLookup does with each channel. */
+class ChannelPacker {
+public:
+	ChannelPacker(const YUVToRGBLookup *lookup) {
+		const Graphics::PixelFormat format = lookup->getFormat();
+		const bool scaleITU = lookup->getScale() == YUVToRGBManager::kScaleITU;
+
+		// Luminance scaling clamps to [16, 235], and stretches that to [0, 255]
+		_low = splat(scaleITU ? 16 : 0);
+		_range = splat(scaleITU ? 235 - 16 : 255);
+		_scale = splat(scaleITU ? kITUMul : 0);
+
+		_loss[0] = makeShift(format.rLoss);
+		_loss[1] = makeShift(format.gLoss);
+		_loss[2] = makeShift(format.bLoss);
+		_shift[0] = makeShift(format.rShift);
+		_shift[1] = makeShift(format.gShift);
+		_shift[2] = makeShift(format.bShift);
+		_alpha = format.RGBToColor(0, 0, 0);
+	}
+
+	template<typename PixelInt>
+	inline void convert(PixelInt *dst, Lanes y, const ChromaLanes &chroma) const {
+		y = sub(y, _low);
+		storePixels(dst, channel(add(y, chroma.r)), channel(add(y, chroma.g)), channel(add(y, chroma.b)), _loss, _shift, _alpha);
+	}
+
+private:
+	inline Lanes channel(Lanes c) const {
+		c = clamp(c, _range);
+		return add(c, mulHi(c, _scale));
+	}
+
+	Lanes _low, _range, _scale;
+	Shift _loss[3], _shift[3];
+	uint32 _alpha;
+};
+
+} // End of anonymous namespace
+
+#endif
+
 template<typename PixelInt>
 void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
@@ -227,6 +443,41 @@ void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	}
 }
 
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+template<typename PixelInt>
+void convertYUV444ToRGBSIMD(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const ChannelPacker packer(lookup);
+	const int vectorWidth = yWidth & ~7;
+
+	for (int h = 0; h < yHeight; h++) {
+		PixelInt *dst = (PixelInt *)dstPtr;
+
+		for (int w = 0; w < vectorWidth; w += 8)
+			packer.convert(dst + w, loadBytes(ySrc + w), convertChroma(loadBytes(uSrc + w), loadBytes(vSrc + w)));
+
+		for (int w = vectorWidth; w < yWidth; w++) {
+			const uint32 *L;
+
+			int16 cr_r  = Cr_r_tab[vSrc[w]];
+			int16 crb_g = Cr_g_tab[vSrc[w]] + Cb_g_tab[uSrc[w]];
+			int16 cb_b  = Cb_b_tab[uSrc[w]];
+
+			PUT_PIXEL(ySrc[w], dst + w);
+		}
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+#endif
+
 void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -236,10 +487,17 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+	if (dst->format.bytesPerPixel == 2)
+		convertYUV444ToRGBSIMD<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	else
+		convertYUV444ToRGBSIMD<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#else
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
 		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#endif
 }
 
 template<typename PixelInt>
@@ -274,28 +532,91 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
-		ySrc += (yPitch << 1) - yWidth;
+		dstPtr += (dstPitch << 1) - (halfWidth << 1) * sizeof(PixelInt);
+		ySrc += (yPitch << 1) - (halfWidth << 1);
 		uSrc += uvPitch - halfWidth;
 		vSrc += uvPitch - halfWidth;
 	}
 }
 
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+template<typename PixelInt>
+void convertYUV420ToRGBSIMD(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	int halfHeight = yHeight >> 1;
+
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const ChannelPacker packer(lookup);
+	const int evenWidth = yWidth & ~1;
+	const int vectorWidth = yWidth & ~15;
+
+	for (int h = 0; h < halfHeight; h++) {
+		PixelInt *dst = (PixelInt *)dstPtr;
+		PixelInt *dstBelow = (PixelInt *)(dstPtr + dstPitch);
+
+		// Each chroma sample covers two pixels of both rows
+		for (int w = 0; w < vectorWidth; w += 16) {
+			const ChromaLanes chroma = convertChroma(loadBytes(uSrc + (w >> 1)), loadBytes(vSrc + (w >> 1)));
+
+			ChromaLanes half;
+			half.r = duplicateLo(chroma.r);
+			half.g = duplicateLo(chroma.g);
+			half.b = duplicateLo(chroma.b);
+			packer.convert(dst + w, loadBytes(ySrc + w), half);
+			packer.convert(dstBelow + w, loadBytes(ySrc + yPitch + w), half);
+
+			half.r = duplicateHi(chroma.r);
+			half.g = duplicateHi(chroma.g);
+			half.b = duplicateHi(chroma.b);
+			packer.convert(dst + w + 8, loadBytes(ySrc + w + 8), half);
+			packer.convert(dstBelow + w + 8, loadBytes(ySrc + yPitch + w + 8), half);
+		}
+
+		for (int w = vectorWidth; w < evenWidth; w += 2) {
+			const uint32 *L;
+
+			int16 cr_r  = Cr_r_tab[vSrc[w >> 1]];
+			int16 crb_g = Cr_g_tab[vSrc[w >> 1]] + Cb_g_tab[uSrc[w >> 1]];
+			int16 cb_b  = Cb_b_tab[uSrc[w >> 1]];
+
+			PUT_PIXEL(ySrc[w], dst + w);
+			PUT_PIXEL(ySrc[w + 1], dst + w + 1);
+			PUT_PIXEL(ySrc[yPitch + w], dstBelow + w);
+			PUT_PIXEL(ySrc[yPitch + w + 1], dstBelow + w + 1);
+		}
+
+		dstPtr += dstPitch << 1;
+		ySrc += yPitch << 1;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+#endif
+
 void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
-	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+	if (dst->format.bytesPerPixel == 2)
+		convertYUV420ToRGBSIMD<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	else
+		convertYUV420ToRGBSIMD<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#else
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
 		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#endif
 }
 
 #define READ_QUAD(ptr, prefix) \
@@ -357,10 +678,73 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 			DO_YUV410_PIXEL();
 		}
 
-		dstPtr += dstPitch - yWidth * sizeof(PixelInt);
-		ySrc += yPitch - yWidth;
+		dstPtr += dstPitch - (quarterWidth << 2) * sizeof(PixelInt);
+		ySrc += yPitch - (quarterWidth << 2);
+	}
+}
+
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+template<typename PixelInt>
+void convertYUV410ToRGBSIMD(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const ChannelPacker packer(lookup);
+	const int quarterWidth = yWidth >> 2;
+	const int vectorWidth = (quarterWidth << 2) & ~7;
+
+	// The bilinear interpolation is done in two steps. The chroma rows are
+	// first interpolated vertically, including the extra column, and the
+	// results are then interpolated horizontally for each pixel. This gives
+	// the same values as DO_INTERPOLATION.
+	int16 *uColumns = new int16[quarterWidth + 1];
+	int16 *vColumns = new int16[quarterWidth + 1];
+	const Lanes leftWeights = lanes(4, 3, 2, 1, 4, 3, 2, 1);
+	const Lanes rightWeights = lanes(0, 1, 2, 3, 0, 1, 2, 3);
+
+	for (int y = 0; y < yHeight; y++) {
+		PixelInt *dst = (PixelInt *)dstPtr;
+		const int yDiff = y & 3;
+		const byte *uRow = uSrc + (y >> 2) * uvPitch;
+		const byte *vRow = vSrc + (y >> 2) * uvPitch;
+
+		for (int x = 0; x <= quarterWidth; x++) {
+			uColumns[x] = uRow[x] * (4 - yDiff) + uRow[x + uvPitch] * yDiff;
+			vColumns[x] = vRow[x] * (4 - yDiff) + vRow[x + uvPitch] * yDiff;
+		}
+
+		// Every eight pixels span two chroma columns, and the one after them
+		for (int w = 0; w < vectorWidth; w += 8) {
+			const int x = w >> 2;
+			const Lanes u = shr4(add(mul(loadFourTimes(uColumns + x), leftWeights), mul(loadFourTimes(uColumns + x + 1), rightWeights)));
+			const Lanes v = shr4(add(mul(loadFourTimes(vColumns + x), leftWeights), mul(loadFourTimes(vColumns + x + 1), rightWeights)));
+			packer.convert(dst + w, loadBytes(ySrc + w), convertChroma(u, v));
+		}
+
+		for (int w = vectorWidth; w < (quarterWidth << 2); w++) {
+			const int x = w >> 2;
+			const int xDiff = w & 3;
+			const byte u = (uColumns[x] * (4 - xDiff) + uColumns[x + 1] * xDiff) >> 4;
+			const byte v = (vColumns[x] * (4 - xDiff) + vColumns[x + 1] * xDiff) >> 4;
+			const uint32 *L;
+
+			int16 cr_r  = Cr_r_tab[v];
+			int16 crb_g = Cr_g_tab[v] + Cb_g_tab[u];
+			int16 cb_b  = Cb_b_tab[u];
+
+			PUT_PIXEL(ySrc[w], dst + w);
+		}
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
 	}
+
+	delete[] uColumns;
+	delete[] vColumns;
 }
+#endif
 
 #undef READ_QUAD
 #undef DO_INTERPOLATION
@@ -371,16 +755,22 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst && dst->getPixels());
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
-	assert((yWidth & 3) == 0);
 	assert((yHeight & 3) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
+#if defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON)
+	if (dst->format.bytesPerPixel == 2)
+		convertYUV410ToRGBSIMD<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	else
+		convertYUV410ToRGBSIMD<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#else
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
 		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#endif
 }
 
 } // End of namespace Graphics
@@ -21,9 +21,13 @@
  */
 
 #include "common/system.h"
+#include "common/algorithm.h"
 #include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/savefile.h"
 #include "common/unzip.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
@@ -633,6 +637,9 @@ bool ThemeEngine::addTextColor(TextColor colorId, int r, int g, int b) {
 }
 
 bool ThemeEngine::addBitmap(const Common::String &filename) {
+	if (Common::find(_themeBitmaps.begin(), _themeBitmaps.end(), filename) == _themeBitmaps.end())
+		_themeBitmaps.push_back(filename);
+
 	// Nothing has to be done if the bitmap already has been loaded.
 	Graphics::Surface *surf = _bitmaps[filename];
 	if (surf)
@@ -710,9 +717,6 @@ void ThemeEngine::loadTheme(const Common::String &themeId) {
 }
 
 void ThemeEngine::unloadTheme() {
-	if (!_themeOk)
-		return;
-
 	for (int i = 0; i < kDrawDataMAX; ++i) {
 		delete _widgets[i];
 		_widgets[i] = 0;
@@ -728,6 +732,7 @@ void ThemeEngine::unloadTheme() {
 		_textColors[i] = 0;
 	}
 
+	_themeBitmaps.clear();
 	_themeEval->reset();
 	_themeOk = false;
 }
@@ -743,16 +748,26 @@ bool ThemeEngine::loadDefaultXML() {
 #include "themes/default.inc"
 	    ;
 
-	if (!_parser->loadBuffer((const byte *)defaultXML, strlen(defaultXML)))
-		return false;
-
 	_themeName = "ScummVM Classic Theme (Builtin Version)";
 	_themeId = "builtin";
 	_themeFile.clear();
 
-	bool result = _parser->parse();
+	const uint32 size = strlen(defaultXML);
+	Common::MemoryReadStream xml((const byte *)defaultXML, size);
+	const Common::String digest = Common::computeStreamMD5AsString(xml);
+	if (loadThemeCache(digest))
+		return true;
+
+	if (!_parser->loadBuffer((const byte *)defaultXML, size))
+		return false;
+
+	Common::MemoryWriteStreamDynamic events(DisposeAfterUse::YES);
+	bool result = parseThemeData(events);
 	_parser->close();
 
+	if (result)
+		saveThemeCache(digest, events.getData(), events.size());
+
 	return result;
 #else
 	warning("The built-in theme is not enabled in the current build. Please load an external theme");
@@ -789,9 +804,28 @@ bool ThemeEngine::loadThemeXML(const Common::String &themeId) {
 		return false;
 	}
 
+	//
+	// The theme cache can be used if the theme did not change. For zip
+	// themes, this is checked with the size and modification time of the
+	// archive, as reading its members would inflate all of them. Other
+	// themes compare the MD5 sums of their STX files and bitmaps.
+	//
+	Common::String digest = getArchiveDigest();
+	if (digest.empty()) {
+		Common::ArchiveMemberList bitmaps;
+		_themeArchive->listMatchingMembers(bitmaps, "*.bmp");
+
+		addMembersToDigest(members, digest);
+		addMembersToDigest(bitmaps, digest);
+	}
+
+	if (loadThemeCache(digest))
+		return true;
+
 	//
 	// Loop over all STX files, load and parse them
 	//
+	Common::MemoryWriteStreamDynamic events(DisposeAfterUse::YES);
 	for (Common::ArchiveMemberList::iterator i = members.begin(); i != members.end(); ++i) {
 		assert((*i)->getName().hasSuffix(".stx"));
 
@@ -801,7 +835,7 @@ bool ThemeEngine::loadThemeXML(const Common::String &themeId) {
 			return false;
 		}
 
-		if (_parser->parse() == false) {
+		if (parseThemeData(events) == false) {
 			warning("Failed to parse STX file '%s'", (*i)->getDisplayName().c_str());
 			_parser->close();
 			return false;
@@ -810,10 +844,204 @@ bool ThemeEngine::loadThemeXML(const Common::String &themeId) {
 		_parser->close();
 	}
 
+	saveThemeCache(digest, events.getData(), events.size());
+
 	assert(!_themeName.empty());
 	return true;
 }
 
+void ThemeEngine::addMembersToDigest(const Common::ArchiveMemberList &members, Common::String &digest) {
+	for (Common::ArchiveMemberList::const_iterator i = members.begin(); i != members.end(); ++i) {
+		Common::SeekableReadStream *stream = (*i)->createReadStream();
+		if (stream) {
+			digest += (*i)->getName() + ":" + Common::computeStreamMD5AsString(*stream) + ";";
+			delete stream;
+		}
+	}
+}
+
+Common::String ThemeEngine::getArchiveDigest() const {
+	if (!_themeFile.matchString("*.zip", true))
+		return Common::String();
+
+	// Find the archive the same way the theme was loaded from it
+	Common::ArchiveMemberPtr member = SearchMan.getMember(_themeFile);
+	if (!member)
+		member = Common::ArchiveMemberPtr(new Common::FSNode(_themeFile));
+
+	const uint32 modificationTime = member->getModificationTime();
+	if (modificationTime == 0)
+		return Common::String();
+
+	Common::SeekableReadStream *stream = member->createReadStream();
+	if (!stream)
+		return Common::String();
+	const int32 size = stream->size();
+	delete stream;
+
+	return Common::String::format("%s:%d:%u", _themeId.c_str(), size, modificationTime);
+}
+
+bool ThemeEngine::parseThemeData(Common::WriteStream &events) {
+	_parser->setRecordStream(&events);
+	bool result = _parser->parse();
+	_parser->setRecordStream(0);
+
+	return result;
+}
+
+
+/**********************************************************
+ * Theme cache
+ *
+ * The cache holds the keys the parser passed to ThemeParser
+ * and the theme bitmaps, converted to the overlay format. The
+ * keys are replayed through ThemeParser on load, so layouts
+ * and draw steps specific to a resolution are still picked
+ * for the current overlay size.
+ *********************************************************/
+enum {
+	kThemeCacheMagic = MKTAG('T', 'H', 'C', 'H'),
+	kThemeCacheVersion = 1
+};
+
+Common::String ThemeEngine::getThemeCacheName() const {
+	return _themeId + ".themecache";
+}
+
+bool ThemeEngine::loadThemeCache(const Common::String &digest) {
+	Common::InSaveFile *file = _system->getSavefileManager()->openForLoading(getThemeCacheName());
+	if (!file)
+		return false;
+
+	// Read the whole cache at once and parse it from memory
+	const uint32 size = file->size();
+	byte *data = (byte *)malloc(size);
+	if (!data || file->read(data, size) != size) {
+		free(data);
+		delete file;
+		return false;
+	}
+	delete file;
+
+	Common::MemoryReadStream cache(data, size, DisposeAfterUse::YES);
+
+	if (cache.readUint32BE() != kThemeCacheMagic || cache.readUint16LE() != kThemeCacheVersion)
+		return false;
+
+	Common::String cachedDigest;
+	if (!Common::XMLParser::readRecordString(cache, cachedDigest) || cachedDigest != digest)
+		return false;
+
+	Graphics::PixelFormat format;
+	format.bytesPerPixel = cache.readByte();
+	format.rLoss = cache.readByte();
+	format.gLoss = cache.readByte();
+	format.bLoss = cache.readByte();
+	format.aLoss = cache.readByte();
+	format.rShift = cache.readByte();
+	format.gShift = cache.readByte();
+	format.bShift = cache.readByte();
+	format.aShift = cache.readByte();
+
+	if (format.bytesPerPixel == 0 || format.bytesPerPixel > 4)
+		return false;
+
+	// The bitmaps are decoded again if the overlay format changed
+	const bool formatMatches = (format == _overlayFormat);
+
+	for (uint32 count = cache.readUint32LE(); count > 0; --count) {
+		Common::String name;
+		if (!Common::XMLParser::readRecordString(cache, name))
+			return false;
+
+		const uint16 w = cache.readUint16LE();
+		const uint16 h = cache.readUint16LE();
+
+		// Checked before multiplying by the pixel size, which could overflow
+		const uint32 pixels = (uint32)w * h;
+		if (cache.eos() || pixels > (uint32)(cache.size() - cache.pos()) / format.bytesPerPixel)
+			return false;
+
+		const uint32 bytes = pixels * format.bytesPerPixel;
+
+		if (!formatMatches || _bitmaps[name]) {
+			cache.skip(bytes);
+			continue;
+		}
+
+		Graphics::Surface *surf = new Graphics::Surface();
+		surf->create(w, h, _overlayFormat);
+		cache.read(surf->getPixels(), bytes);
+		_bitmaps[name] = surf;
+	}
+
+	const uint32 eventsStart = cache.pos();
+	if (cache.eos() || !_parser->replay(cache)) {
+		warning("Invalid cache for theme '%s'", _themeId.c_str());
+		unloadTheme();
+		return false;
+	}
+
+	debug(6, "Loaded theme %s from its cache", _themeId.c_str());
+
+	if (!formatMatches)
+		saveThemeCache(digest, data + eventsStart, size - eventsStart);
+
+	return true;
+}
+
+void ThemeEngine::saveThemeCache(const Common::String &digest, const byte *events, uint32 size) {
+	Common::OutSaveFile *file = _system->getSavefileManager()->openForSaving(getThemeCacheName(), false);
+	if (!file)
+		return;
+
+	file->writeUint32BE(kThemeCacheMagic);
+	file->writeUint16LE(kThemeCacheVersion);
+	Common::XMLParser::writeRecordString(*file, digest);
+
+	file->writeByte(_overlayFormat.bytesPerPixel);
+	file->writeByte(_overlayFormat.rLoss);
+	file->writeByte(_overlayFormat.gLoss);
+	file->writeByte(_overlayFormat.bLoss);
+	file->writeByte(_overlayFormat.aLoss);
+	file->writeByte(_overlayFormat.rShift);
+	file->writeByte(_overlayFormat.gShift);
+	file->writeByte(_overlayFormat.bShift);
+	file->writeByte(_overlayFormat.aShift);
+
+	Common::Array<const Graphics::Surface *> bitmaps;
+	Common::StringArray names;
+	for (Common::StringArray::const_iterator i = _themeBitmaps.begin(); i != _themeBitmaps.end(); ++i) {
+		const Graphics::Surface *surf = _bitmaps.contains(*i) ? _bitmaps[*i] : 0;
+		if (surf && surf->format == _overlayFormat) {
+			bitmaps.push_back(surf);
+			names.push_back(*i);
+		}
+	}
+
+	file->writeUint32LE(bitmaps.size());
+	for (uint i = 0; i < bitmaps.size(); ++i) {
+		const Graphics::Surface *surf = bitmaps[i];
+		Common::XMLParser::writeRecordString(*file, names[i]);
+		file->writeUint16LE(surf->w);
+		file->writeUint16LE(surf->h);
+		for (int y = 0; y < surf->h; ++y)
+			file->write(surf->getBasePtr(0, y), surf->w * surf->format.bytesPerPixel);
+	}
+
+	file->write(events, size);
+
+	file->finalize();
+	const bool failed = file->err();
+	delete file;
+
+	if (failed) {
+		warning("Couldn't write the cache for theme '%s'", _themeId.c_str());
+		_system->getSavefileManager()->removeSavefile(getThemeCacheName());
+	}
+}
+
 
 
 /**********************************************************
@@ -29,6 +29,7 @@
 #include "common/hashmap.h"
 #include "common/list.h"
 #include "common/str.h"
+#include "common/str-array.h"
 #include "common/rect.h"
 
 #include "graphics/surface.h"
@@ -40,6 +41,10 @@
 
 class OSystem;
 
+namespace Common {
+class WriteStream;
+}
+
 namespace Graphics {
 struct DrawStep;
 class VectorRenderer;
@@ -553,6 +558,43 @@ protected:
 	 */
 	bool loadDefaultXML();
 
+	/**
+	 * Appends the names and MD5 sums of the given theme files to the
+	 * digest identifying the theme cache.
+	 */
+	static void addMembersToDigest(const Common::ArchiveMemberList &members, Common::String &digest);
+
+	/**
+	 * Returns the digest identifying the theme cache of a zip theme, made
+	 * of the theme id and the size and modification time of the archive.
+	 * It is empty if the theme is no zip file or its modification time is
+	 * unknown.
+	 */
+	Common::String getArchiveDigest() const;
+
+	/**
+	 * Parses the STX data loaded into the parser, recording the keys
+	 * for the theme cache into the given stream.
+	 */
+	bool parseThemeData(Common::WriteStream &events);
+
+	/**
+	 * Loads the theme from the cache written by saveThemeCache(). The
+	 * cache is only used if it was created from theme data with the
+	 * same digest.
+	 *
+	 * @returns true if the theme was loaded from the cache.
+	 */
+	bool loadThemeCache(const Common::String &digest);
+
+	/**
+	 * Stores the recorded parser keys and the bitmaps of the loaded theme,
+	 * converted to the overlay format, in the theme cache.
+	 */
+	void saveThemeCache(const Common::String &digest, const byte *events, uint32 size);
+
+	Common::String getThemeCacheName() const;
+
 	/**
 	 * Unloads the currently loaded theme so another one can
 	 * be loaded.
@@ -659,6 +701,7 @@ protected:
 	TextColorData *_textColors[kTextColorMAX];
 
 	ImagesMap _bitmaps;
+	Common::StringArray _themeBitmaps; /** Bitmaps used by the loaded theme */
 	Graphics::PixelFormat _overlayFormat;
 #ifdef USE_RGB_COLOR
 	Graphics::PixelFormat _cursorFormat;
@@ -0,0 +1,216 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "helper.h"
+
+class RateTestSuite : public CxxTest::TestSuite
+{
+	static int16 noise(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return (int16)(seed >> 8);
+	}
+
+	static byte nativeFlags(const bool isStereo) {
+		byte flags = Audio::FLAG_16BITS | (isStereo ? Audio::FLAG_STEREO : 0);
+#ifdef SCUMM_LITTLE_ENDIAN
+		flags |= Audio::FLAG_LITTLE_ENDIAN;
+#endif
+		return flags;
+	}
+
+	// Mixes a copy of the input into noise, and compares the result with
+	// what clampedAdd() produces. This covers both the vectorized and the
+	// scalar mixing code, including the frames left over by the former.
+	void testCopyMixing(const bool isStereo, const bool reverseStereo, const int frames, const int volL, const int volR) {
+		const int channels = isStereo ? 2 : 1;
+		uint32 seed = frames;
+
+		int16 *input = (int16 *)malloc(frames * channels * 2);
+		for (int i = 0; i < frames * channels; ++i)
+			input[i] = noise(seed);
+
+		int16 *output = new int16[frames * 2];
+		int16 *expected = new int16[frames * 2];
+		for (int i = 0; i < frames * 2; ++i)
+			output[i] = expected[i] = noise(seed);
+
+		for (int i = 0; i < frames; ++i) {
+			const int16 left = input[i * channels];
+			const int16 right = input[i * channels + channels - 1];
+			Audio::clampedAdd(expected[i * 2 + (reverseStereo ? 1 : 0)], (left * volL) / Audio::Mixer::kMaxMixerVolume);
+			Audio::clampedAdd(expected[i * 2 + (reverseStereo ? 0 : 1)], (right * volR) / Audio::Mixer::kMaxMixerVolume);
+		}
+
+		Audio::AudioStream *stream = Audio::makeRawStream((const byte *)input, frames * channels * 2, 22050, nativeFlags(isStereo));
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 22050, isStereo, reverseStereo);
+
+		TS_ASSERT_EQUALS(converter->flow(*stream, output, frames, volL, volR), frames);
+		TS_ASSERT_EQUALS(memcmp(output, expected, frames * 4), 0);
+
+		delete converter;
+		delete stream;
+		delete[] output;
+		delete[] expected;
+	}
+
+	// Feeds a constant signal through a resampling converter. Whatever the
+	// converter picks or interpolates, every output frame must be the same.
+	void testConstantResampling(const int inRate, const int outRate, const bool isStereo, const bool reverseStereo,
+	                            const Audio::RateConverterQuality quality = Audio::kRateQualityLow) {
+		const int channels = isStereo ? 2 : 1;
+		const int inFrames = inRate;
+		const int outFrames = 1000;
+
+		int16 *input = (int16 *)malloc(inFrames * channels * 2);
+		for (int i = 0; i < inFrames * channels; ++i)
+			input[i] = (isStereo && (i & 1)) ? -20000 : 30000;
+
+		int16 *output = new int16[outFrames * 2];
+		for (int i = 0; i < outFrames * 2; ++i)
+			output[i] = 10000;
+
+		Audio::AudioStream *stream = Audio::makeRawStream((const byte *)input, inFrames * channels * 2, inRate, nativeFlags(isStereo));
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, isStereo, reverseStereo, quality);
+
+		TS_ASSERT_EQUALS(converter->flow(*stream, output, outFrames, 256, 128), outFrames);
+
+		// 30000 at full volume clamps, -20000 at half volume cancels out the
+		// 10000 already in the buffer. The linear and sinc converters start
+		// out from silence, so skip the frames affected by that.
+		int16 left = 32767;
+		int16 right = isStereo ? 0 : 25000;
+		if (reverseStereo)
+			SWAP(left, right);
+
+		const int skip = (quality == Audio::kRateQualityLow) ? outRate / inRate + 1 : 200;
+		for (int i = skip; i < outFrames; ++i) {
+			TS_ASSERT_EQUALS(output[i * 2], left);
+			TS_ASSERT_EQUALS(output[i * 2 + 1], right);
+		}
+
+		delete converter;
+		delete stream;
+		delete[] output;
+	}
+
+	// Resamples a sine wave, and checks that the result stays close to a
+	// sine wave of the same frequency sampled at the output rate.
+	void testSineResampling(const int inRate, const int outRate, const Audio::RateConverterQuality quality, const int maxError) {
+		const double frequency = 1000.0;
+		const double amplitude = 16000.0;
+		const int inFrames = inRate;
+		const int outFrames = outRate / 2;
+
+		int16 *input = (int16 *)malloc(inFrames * 2);
+		for (int i = 0; i < inFrames; ++i)
+			input[i] = (int16)floor(sin(2 * M_PI * frequency * i / inRate) * amplitude + 0.5);
+
+		int16 *output = new int16[outFrames * 2];
+		memset(output, 0, outFrames * 4);
+
+		Audio::AudioStream *stream = Audio::makeRawStream((const byte *)input, inFrames * 2, inRate, nativeFlags(false));
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false, false, quality);
+
+		TS_ASSERT_EQUALS(converter->flow(*stream, output, outFrames, 256, 256), outFrames);
+
+		int error = 0;
+		for (int i = 200; i < outFrames; ++i) {
+			const int expected = (int)floor(sin(2 * M_PI * frequency * i / outRate) * amplitude + 0.5);
+			error = MAX(error, ABS(output[i * 2] - expected));
+		}
+		TS_ASSERT_LESS_THAN_EQUALS(error, maxError);
+
+		delete converter;
+		delete stream;
+		delete[] output;
+	}
+
+	// Resamples a short stream to its end. The sinc converter has to drain
+	// its filter, so that every input frame makes it into the output.
+	void testFiniteLength(const int inRate, const int outRate, const bool isStereo, const Audio::RateConverterQuality quality, const int inFrames) {
+		const int channels = isStereo ? 2 : 1;
+		const int outFrames = (int)(((int64)inFrames * outRate + inRate - 1) / inRate);
+
+		uint32 seed = inFrames;
+		int16 *input = (int16 *)malloc(inFrames * channels * 2);
+		for (int i = 0; i < inFrames * channels; ++i)
+			input[i] = noise(seed);
+
+		int16 *output = new int16[(outFrames + 100) * 2];
+		memset(output, 0, (outFrames + 100) * 4);
+
+		Audio::AudioStream *stream = Audio::makeRawStream((const byte *)input, inFrames * channels * 2, inRate, nativeFlags(isStereo));
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, isStereo, false, quality);
+
+		TS_ASSERT_EQUALS(converter->flow(*stream, output, outFrames + 100, 256, 256), outFrames);
+		TS_ASSERT_EQUALS(converter->flow(*stream, output, outFrames + 100, 256, 256), 0);
+
+		delete converter;
+		delete stream;
+		delete[] output;
+	}
+
+public:
+	void test_copy_mono() {
+		testCopyMixing(false, false, 1000, 256, 256);
+		testCopyMixing(false, false, 13, 100, 3);
+	}
+
+	void test_copy_stereo() {
+		testCopyMixing(true, false, 1000, 256, 256);
+		testCopyMixing(true, false, 13, 0, 255);
+	}
+
+	void test_copy_reverse_stereo() {
+		testCopyMixing(true, true, 1000, 256, 17);
+		testCopyMixing(true, true, 7, 200, 100);
+	}
+
+	void test_copy_loud() {
+		// Volumes above kMaxMixerVolume are never passed by the mixer
+		testCopyMixing(false, false, 100, 1000, 300);
+		testCopyMixing(true, true, 100, 257, 4000);
+	}
+
+	void test_simple_constant() {
+		testConstantResampling(44100, 22050, false, false);
+		testConstantResampling(44100, 22050, true, false);
+		testConstantResampling(44100, 11025, true, true);
+	}
+
+	void test_linear_constant() {
+		testConstantResampling(11025, 44100, false, false);
+		testConstantResampling(22050, 48000, true, false);
+		testConstantResampling(22050, 48000, true, true);
+	}
+
+	void test_sinc_constant() {
+		testConstantResampling(11025, 44100, false, false, Audio::kRateQualityMedium);
+		testConstantResampling(22050, 48000, true, false, Audio::kRateQualityHigh);
+		testConstantResampling(44100, 22050, true, true, Audio::kRateQualityHigh);
+		testConstantResampling(96000, 44100, true, false, Audio::kRateQualityMedium);
+	}
+
+	void test_sinc_sine() {
+		testSineResampling(11025, 44100, Audio::kRateQualityMedium, 100);
+		testSineResampling(11025, 48000, Audio::kRateQualityHigh, 20);
+		testSineResampling(44100, 22050, Audio::kRateQualityHigh, 20);
+		testSineResampling(22050, 96000, Audio::kRateQualityHigh, 20);
+	}
+
+	void test_sinc_finite() {
+		testFiniteLength(22050, 44100, false, Audio::kRateQualityMedium, 1000);
+		testFiniteLength(11025, 48000, true, Audio::kRateQualityHigh, 441);
+		testFiniteLength(44100, 22050, true, Audio::kRateQualityHigh, 1001);
+		testFiniteLength(96000, 44100, false, Audio::kRateQualityMedium, 5000);
+		testFiniteLength(22050, 44100, false, Audio::kRateQualityHigh, 10);
+	}
+
+	void test_high_rates() {
+		// The fixed point converters can not handle these
+		testSineResampling(96000, 44100, Audio::kRateQualityLow, 100);
+		testSineResampling(44100, 192000, Audio::kRateQualityLow, 100);
+	}
+};
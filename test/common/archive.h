@@ -0,0 +1,173 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+
+/**
+ * An archive whose members all contain its tag. Members can be removed
+ * without the archive's member list changing, like files deleted after
+ * an FSDirectory cached them.
+ */
+class TagArchive : public Common::Archive {
+public:
+	Common::String _tag;
+	Common::StringArray _names;
+	Common::StringArray _removed;
+	bool _listsNames;
+	mutable int _lookups;
+
+	TagArchive(const Common::String &tag, bool listsNames) : _tag(tag), _listsNames(listsNames), _lookups(0) {}
+
+	bool hasFile(const Common::String &name) const {
+		_lookups++;
+		for (uint i = 0; i < _removed.size(); ++i) {
+			if (_removed[i].equalsIgnoreCase(name))
+				return false;
+		}
+		for (uint i = 0; i < _names.size(); ++i) {
+			if (_names[i].equalsIgnoreCase(name))
+				return true;
+		}
+		return false;
+	}
+
+	int listMembers(Common::ArchiveMemberList &list) const {
+		for (uint i = 0; i < _names.size(); ++i)
+			list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(_names[i], this)));
+		return _names.size();
+	}
+
+	bool listMemberNames(Common::StringArray &list) const {
+		if (!_listsNames)
+			return false;
+
+		for (uint i = 0; i < _names.size(); ++i)
+			list.push_back(_names[i]);
+		return true;
+	}
+
+	const Common::ArchiveMemberPtr getMember(const Common::String &name) const {
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(name, this));
+	}
+
+	Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const {
+		if (!hasFile(name))
+			return 0;
+		return new Common::MemoryReadStream((const byte *)_tag.c_str(), _tag.size());
+	}
+};
+
+class SearchSetTestSuite : public CxxTest::TestSuite {
+	static Common::String open(const Common::SearchSet &set, const Common::String &name) {
+		Common::SeekableReadStream *stream = set.createReadStreamForMember(name);
+		if (!stream)
+			return "-";
+
+		Common::String tag;
+		while (!stream->eos()) {
+			const char c = stream->readByte();
+			if (!stream->eos())
+				tag += c;
+		}
+		delete stream;
+		return tag;
+	}
+
+public:
+	void test_priorities() {
+		Common::SearchSet set;
+		TagArchive *low = new TagArchive("low", true);
+		TagArchive *high = new TagArchive("high", true);
+		low->_names.push_back("both.dat");
+		low->_names.push_back("low.dat");
+		high->_names.push_back("BOTH.DAT");
+		high->_names.push_back("dir/high.dat");
+
+		set.add("low", low, 0);
+		set.add("high", high, 1);
+
+		TS_ASSERT_EQUALS(open(set, "both.dat"), "high");
+		TS_ASSERT_EQUALS(open(set, "Low.dat"), "low");
+		TS_ASSERT_EQUALS(open(set, "DIR/HIGH.DAT"), "high");
+		TS_ASSERT_EQUALS(open(set, "none.dat"), "-");
+		TS_ASSERT(set.hasFile("both.dat"));
+		TS_ASSERT(!set.hasFile("none.dat"));
+		TS_ASSERT_EQUALS(set.getMember("both.dat")->getName(), "both.dat");
+
+		// Changing the order rebuilds the index
+		set.setPriority("low", 2);
+		TS_ASSERT_EQUALS(open(set, "both.dat"), "low");
+
+		set.remove("low");
+		TS_ASSERT_EQUALS(open(set, "both.dat"), "high");
+		TS_ASSERT(!set.hasFile("low.dat"));
+
+		set.clear();
+		TS_ASSERT(!set.hasFile("both.dat"));
+	}
+
+	void test_unindexed_archives() {
+		Common::SearchSet set;
+		TagArchive *first = new TagArchive("first", true);
+		TagArchive *unindexed = new TagArchive("unindexed", false);
+		TagArchive *last = new TagArchive("last", true);
+		first->_names.push_back("first.dat");
+		unindexed->_names.push_back("first.dat");
+		unindexed->_names.push_back("last.dat");
+		last->_names.push_back("last.dat");
+
+		set.add("first", first, 2);
+		set.add("unindexed", unindexed, 1);
+		set.add("last", last, 0);
+
+		// Archives which can't list their names are only asked before the
+		// indexed archive which has the member
+		TS_ASSERT_EQUALS(open(set, "first.dat"), "first");
+		TS_ASSERT_EQUALS(unindexed->_lookups, 0);
+		TS_ASSERT_EQUALS(open(set, "last.dat"), "unindexed");
+		TS_ASSERT_EQUALS(open(set, "none.dat"), "-");
+	}
+
+	void test_removed_members() {
+		Common::SearchSet set;
+		TagArchive *first = new TagArchive("first", true);
+		TagArchive *second = new TagArchive("second", true);
+		first->_names.push_back("file.dat");
+		second->_names.push_back("file.dat");
+
+		set.add("first", first, 1);
+		set.add("second", second, 0);
+		TS_ASSERT_EQUALS(open(set, "file.dat"), "first");
+
+		first->_removed.push_back("file.dat");
+		TS_ASSERT_EQUALS(open(set, "file.dat"), "second");
+
+		second->_removed.push_back("file.dat");
+		TS_ASSERT_EQUALS(open(set, "file.dat"), "-");
+		TS_ASSERT(!set.hasFile("file.dat"));
+	}
+
+	void test_stats() {
+		Common::SearchSet set;
+		TagArchive *archive = new TagArchive("tag", true);
+		archive->_names.push_back("a.dat");
+		archive->_names.push_back("b.dat");
+		set.add("archive", archive);
+
+		TS_ASSERT(set.hasFile("a.dat"));
+		TS_ASSERT_EQUALS(open(set, "b.dat"), "tag");
+		TS_ASSERT(!set.hasFile("c.dat"));
+
+		const Common::SearchSet::Stats &stats = set.getStats();
+		TS_ASSERT_EQUALS(stats.lookups, 3u);
+		TS_ASSERT_EQUALS(stats.indexHits, 2u);
+		TS_ASSERT_EQUALS(stats.misses, 1u);
+		TS_ASSERT_EQUALS(stats.opens, 1u);
+		TS_ASSERT_EQUALS(stats.indexBuilds, 1u);
+		TS_ASSERT_EQUALS(stats.indexSize, 2u);
+
+		set.resetStats();
+		TS_ASSERT_EQUALS(stats.lookups, 0u);
+		TS_ASSERT_EQUALS(stats.indexSize, 2u);
+	}
+};
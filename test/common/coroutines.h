@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/coroutines.h"
+
+static int s_coroFinished;
+static int s_coroProfileStarts;
+static int s_coroProfileEnds;
+
+static void coroSleeper(CORO_PARAM, int cycles) {
+	CORO_BEGIN_CONTEXT;
+		int i;
+		char padding[100];
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	for (_ctx->i = 0; _ctx->i < cycles; ++_ctx->i)
+		CORO_SLEEP(1);
+
+	CORO_END_CODE;
+}
+
+static void coroProcess(CORO_PARAM, const void *param) {
+	CORO_BEGIN_CONTEXT;
+	CORO_END_CONTEXT(_ctx);
+
+	const int cycles = *(const int *)param;
+
+	CORO_BEGIN_CODE(_ctx);
+
+	CORO_INVOKE_1(coroSleeper, cycles);
+	s_coroFinished++;
+
+	CORO_END_CODE;
+}
+
+static void coroProfile(const Common::PROCESS *pProc, bool bFinished, void *refCon) {
+	if (bFinished)
+		s_coroProfileEnds++;
+	else
+		s_coroProfileStarts++;
+}
+
+class CoroutinesTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		CoroScheduler.reset();
+		s_coroFinished = s_coroProfileStarts = s_coroProfileEnds = 0;
+	}
+
+	void tearDown() {
+		CoroScheduler.setProfileCallback(NULL);
+		CoroScheduler.reset();
+	}
+
+	void test_schedule() {
+		int cycles = 3;
+		for (int i = 0; i < 10; ++i)
+			CoroScheduler.createProcess(coroProcess, &cycles, sizeof(cycles));
+
+		for (int i = 0; i < 3; ++i) {
+			CoroScheduler.schedule();
+			TS_ASSERT_EQUALS(s_coroFinished, 0);
+		}
+
+		CoroScheduler.schedule();
+		TS_ASSERT_EQUALS(s_coroFinished, 10);
+	}
+
+	void test_kill_matching() {
+		int cycles = 100;
+		CoroScheduler.createProcess(5, coroProcess, &cycles, sizeof(cycles));
+		CoroScheduler.createProcess(6, coroProcess, &cycles, sizeof(cycles));
+		CoroScheduler.createProcess(5, coroProcess, &cycles, sizeof(cycles));
+		CoroScheduler.createProcess(0x105, coroProcess, &cycles, sizeof(cycles));
+		CoroScheduler.createProcess(5, coroProcess, &cycles, sizeof(cycles));
+
+		TS_ASSERT_EQUALS(CoroScheduler.killMatchingProcess(5), 3);
+		TS_ASSERT_EQUALS(CoroScheduler.killMatchingProcess(5), 0);
+		TS_ASSERT_EQUALS(CoroScheduler.killMatchingProcess(5, 0xff), 1);
+
+		CoroScheduler.createProcess(5, coroProcess, &cycles, sizeof(cycles));
+		TS_ASSERT_EQUALS(CoroScheduler.killMatchingProcess(0, 0xf0), 2);
+	}
+
+	void test_profile_callback() {
+		int cycles = 2;
+		Common::PROCESS *pProc = CoroScheduler.createProcess(7, coroProcess, &cycles, sizeof(cycles));
+		CoroScheduler.createProcess(coroProcess, &cycles, sizeof(cycles));
+		CoroScheduler.setProfileCallback(coroProfile);
+
+		CoroScheduler.schedule();
+		TS_ASSERT_EQUALS(pProc->resumeCount, 1u);
+		CoroScheduler.schedule();
+		TS_ASSERT_EQUALS(pProc->resumeCount, 2u);
+		CoroScheduler.schedule();
+
+		TS_ASSERT_EQUALS(s_coroFinished, 2);
+		TS_ASSERT_EQUALS(s_coroProfileStarts, 6);
+		TS_ASSERT_EQUALS(s_coroProfileEnds, 6);
+	}
+};
@@ -0,0 +1,96 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/xmlparser.h"
+#include "common/memstream.h"
+
+class XMLRecordTestParser : public Common::XMLParser {
+public:
+	Common::String _log;
+
+protected:
+	CUSTOM_XML_PARSER(XMLRecordTestParser) {
+		XML_KEY(layout)
+			XML_PROP(name, true)
+			XML_KEY(widget)
+				XML_PROP(name, true)
+				XML_PROP(width, false)
+			KEY_END()
+			XML_KEY_RECURSIVE(layout)
+		KEY_END()
+	} PARSER_END()
+
+	bool parserCallback_layout(ParserNode *node) {
+		_log += "layout(" + node->values["name"] + ")";
+		return true;
+	}
+
+	bool parserCallback_widget(ParserNode *node) {
+		_log += "widget(" + node->values["name"] + "," + node->values["width"] + ")";
+		return true;
+	}
+
+	bool closedKeyCallback(ParserNode *node) {
+		_log += "/" + node->name;
+		return true;
+	}
+
+	void cleanup() {
+		_log += "|";
+	}
+};
+
+class XMLParserTestSuite : public CxxTest::TestSuite {
+	static const char *xml() {
+		return
+			"<?xml version = '1.0'?>\n"
+			"<!-- a comment -->\n"
+			"<layout name = 'main'>\n"
+			"  <widget name = 'button' width = '100'/>\n"
+			"  <layout name = 'inner'>\n"
+			"    <widget name = 'list'/>\n"
+			"  </layout>\n"
+			"</layout>\n";
+	}
+
+public:
+	void test_replay() {
+		XMLRecordTestParser parser;
+		Common::MemoryWriteStreamDynamic record(DisposeAfterUse::YES);
+
+		parser.setRecordStream(&record);
+		parser.loadBuffer((const byte *)xml(), strlen(xml()));
+		TS_ASSERT(parser.parse());
+		parser.close();
+		parser.setRecordStream(0);
+
+		TS_ASSERT_EQUALS(parser._log, "|/xmllayout(main)widget(button,100)/widgetlayout(inner)widget(list,)/widget/layout/layout");
+
+		// The recording of two parses replays both
+		parser.setRecordStream(&record);
+		parser.loadBuffer((const byte *)xml(), strlen(xml()));
+		TS_ASSERT(parser.parse());
+		parser.close();
+		parser.setRecordStream(0);
+
+		XMLRecordTestParser replayed;
+		Common::MemoryReadStream stream(record.getData(), record.size());
+		TS_ASSERT(replayed.replay(stream));
+		TS_ASSERT_EQUALS(replayed._log, parser._log);
+	}
+
+	void test_truncated_replay() {
+		XMLRecordTestParser parser;
+		Common::MemoryWriteStreamDynamic record(DisposeAfterUse::YES);
+
+		parser.setRecordStream(&record);
+		parser.loadBuffer((const byte *)xml(), strlen(xml()));
+		TS_ASSERT(parser.parse());
+		parser.close();
+
+		for (uint32 size = 0; size < record.size(); ++size) {
+			XMLRecordTestParser replayed;
+			Common::MemoryReadStream stream(record.getData(), size);
+			TS_ASSERT(!replayed.replay(stream));
+		}
+	}
+};
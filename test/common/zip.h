@@ -0,0 +1,253 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/str.h"
+#include "common/unzip.h"
+#include "common/zlib.h"
+
+/**
+ * Builds a ZIP archive in memory. Deflated members are produced by
+ * stripping the gzip header and trailer from GZipWriteStream's output.
+ */
+class ZipBuilder {
+	struct Entry {
+		Common::String name;
+		uint16 method;
+		uint32 crc;
+		uint32 compressedSize;
+		uint32 uncompressedSize;
+		uint32 offset;
+	};
+
+	Common::MemoryWriteStreamDynamic _out;
+	Common::Array<Entry> _entries;
+
+	static uint32 crc32(const byte *data, uint32 size) {
+		uint32 crc = 0xFFFFFFFF;
+		for (uint32 i = 0; i < size; ++i) {
+			crc ^= data[i];
+			for (int j = 0; j < 8; ++j)
+				crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+		}
+		return ~crc;
+	}
+
+	void addEntry(const Common::String &name, uint16 method, const byte *data, uint32 dataSize, uint32 crc, uint32 uncompressedSize) {
+		Entry entry;
+		entry.name = name;
+		entry.method = method;
+		entry.crc = crc;
+		entry.compressedSize = dataSize;
+		entry.uncompressedSize = uncompressedSize;
+		entry.offset = _out.pos();
+		_entries.push_back(entry);
+
+		_out.writeUint32LE(0x04034b50);
+		_out.writeUint16LE(20);
+		_out.writeUint16LE(0);
+		_out.writeUint16LE(method);
+		_out.writeUint32LE(0);
+		_out.writeUint32LE(crc);
+		_out.writeUint32LE(dataSize);
+		_out.writeUint32LE(uncompressedSize);
+		_out.writeUint16LE(name.size());
+		_out.writeUint16LE(0);
+		_out.write(name.c_str(), name.size());
+		_out.write(data, dataSize);
+	}
+
+public:
+	ZipBuilder() : _out(DisposeAfterUse::NO) {}
+
+	void addStored(const Common::String &name, const byte *data, uint32 size) {
+		addEntry(name, 0, data, size, crc32(data, size), size);
+	}
+
+	void addDeflated(const Common::String &name, const byte *data, uint32 size) {
+		// The compressor takes ownership of the memory stream, but not of
+		// its data.
+		Common::MemoryWriteStreamDynamic *gzip = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *compressor = Common::wrapCompressedWriteStream(gzip);
+		compressor->write(data, size);
+		compressor->finalize();
+
+		byte *gzipData = gzip->getData();
+		const uint32 gzipSize = gzip->size();
+		delete compressor;
+
+		addEntry(name, 8, gzipData + 10, gzipSize - 18, crc32(data, size), size);
+		free(gzipData);
+	}
+
+	Common::SeekableReadStream *finish() {
+		const uint32 centralStart = _out.pos();
+		for (uint i = 0; i < _entries.size(); ++i) {
+			const Entry &entry = _entries[i];
+			_out.writeUint32LE(0x02014b50);
+			_out.writeUint16LE(20);
+			_out.writeUint16LE(20);
+			_out.writeUint16LE(0);
+			_out.writeUint16LE(entry.method);
+			_out.writeUint32LE(0);
+			_out.writeUint32LE(entry.crc);
+			_out.writeUint32LE(entry.compressedSize);
+			_out.writeUint32LE(entry.uncompressedSize);
+			_out.writeUint16LE(entry.name.size());
+			_out.writeUint16LE(0);
+			_out.writeUint16LE(0);
+			_out.writeUint16LE(0);
+			_out.writeUint16LE(0);
+			_out.writeUint32LE(0);
+			_out.writeUint32LE(entry.offset);
+			_out.write(entry.name.c_str(), entry.name.size());
+		}
+		const uint32 centralSize = _out.pos() - centralStart;
+
+		_out.writeUint32LE(0x06054b50);
+		_out.writeUint16LE(0);
+		_out.writeUint16LE(0);
+		_out.writeUint16LE(_entries.size());
+		_out.writeUint16LE(_entries.size());
+		_out.writeUint32LE(centralSize);
+		_out.writeUint32LE(centralStart);
+		_out.writeUint16LE(0);
+
+		return new Common::MemoryReadStream(_out.getData(), _out.size(), DisposeAfterUse::YES);
+	}
+};
+
+class ZipTestSuite : public CxxTest::TestSuite {
+	enum {
+		kLargeSize = 3 * 1024 * 1024 + 123,
+		kSmallSize = 1000
+	};
+
+	byte *_large;
+	byte *_small;
+
+	static void fill(byte *data, uint32 size, uint32 seed) {
+		for (uint32 i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = 'a' + ((seed >> 16) & 0x0F);
+		}
+	}
+
+	Common::Archive *makeArchive() {
+		ZipBuilder builder;
+		builder.addStored("stored.bin", _small, kSmallSize);
+#ifdef USE_ZLIB
+		builder.addDeflated("small.bin", _small, kSmallSize);
+		builder.addDeflated("large.bin", _large, kLargeSize);
+#endif
+		return Common::makeZipArchive(builder.finish());
+	}
+
+	bool checkRange(Common::SeekableReadStream *stream, const byte *expected, uint32 start, uint32 size) {
+		byte *buffer = new byte[size];
+		const bool ok = stream->read(buffer, size) == size && !memcmp(buffer, expected + start, size);
+		delete[] buffer;
+		return ok;
+	}
+
+public:
+	void setUp() {
+		_large = new byte[kLargeSize];
+		_small = new byte[kSmallSize];
+		fill(_large, kLargeSize, 1);
+		fill(_small, kSmallSize, 2);
+	}
+
+	void tearDown() {
+		delete[] _large;
+		delete[] _small;
+	}
+
+	void test_stored() {
+		Common::ScopedPtr<Common::Archive> archive(makeArchive());
+		TS_ASSERT(archive);
+		TS_ASSERT(archive->hasFile("STORED.BIN"));
+
+		Common::ScopedPtr<Common::SeekableReadStream> stream(archive->createReadStreamForMember("stored.bin"));
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), kSmallSize);
+		TS_ASSERT(checkRange(stream.get(), _small, 0, kSmallSize));
+
+		stream->seek(-10, SEEK_END);
+		TS_ASSERT(checkRange(stream.get(), _small, kSmallSize - 10, 10));
+	}
+
+	void test_member_outlives_archive() {
+		Common::Archive *archive = makeArchive();
+		Common::ScopedPtr<Common::SeekableReadStream> stream(archive->createReadStreamForMember("stored.bin"));
+		delete archive;
+
+		TS_ASSERT(stream);
+		TS_ASSERT(checkRange(stream.get(), _small, 0, kSmallSize));
+	}
+
+#ifdef USE_ZLIB
+	void test_deflated_sequential() {
+		Common::ScopedPtr<Common::Archive> archive(makeArchive());
+
+		Common::ScopedPtr<Common::SeekableReadStream> small(archive->createReadStreamForMember("small.bin"));
+		TS_ASSERT(small);
+		TS_ASSERT_EQUALS(small->size(), kSmallSize);
+		TS_ASSERT(checkRange(small.get(), _small, 0, kSmallSize));
+
+		Common::ScopedPtr<Common::SeekableReadStream> large(archive->createReadStreamForMember("large.bin"));
+		TS_ASSERT(large);
+		TS_ASSERT_EQUALS(large->size(), kLargeSize);
+		TS_ASSERT(checkRange(large.get(), _large, 0, kLargeSize));
+		TS_ASSERT(!large->err());
+
+		byte dummy;
+		TS_ASSERT_EQUALS(large->read(&dummy, 1), 0u);
+		TS_ASSERT(large->eos());
+	}
+
+	void test_deflated_seek() {
+		Common::ScopedPtr<Common::Archive> archive(makeArchive());
+		Common::ScopedPtr<Common::SeekableReadStream> large(archive->createReadStreamForMember("large.bin"));
+		TS_ASSERT(large);
+
+		// Forward seek past several checkpoints.
+		TS_ASSERT(large->seek(2500000));
+		TS_ASSERT_EQUALS(large->pos(), 2500000);
+		TS_ASSERT(checkRange(large.get(), _large, 2500000, 4096));
+
+		// Backward seek inside the recent output.
+		TS_ASSERT(large->seek(-8192, SEEK_CUR));
+		TS_ASSERT(checkRange(large.get(), _large, 2500000 - 4096, 4096));
+
+		// Backward seeks which need a checkpoint or a restart.
+		TS_ASSERT(large->seek(1500000));
+		TS_ASSERT(checkRange(large.get(), _large, 1500000, 70000));
+		TS_ASSERT(large->seek(10));
+		TS_ASSERT(checkRange(large.get(), _large, 10, 100));
+
+		// Forward seek which can resume from a checkpoint.
+		TS_ASSERT(large->seek(2200000));
+		TS_ASSERT(checkRange(large.get(), _large, 2200000, 100));
+
+		TS_ASSERT(large->seek(-100, SEEK_END));
+		TS_ASSERT(checkRange(large.get(), _large, kLargeSize - 100, 100));
+		TS_ASSERT(!large->err());
+	}
+
+	void test_deflated_interleaved() {
+		Common::ScopedPtr<Common::Archive> archive(makeArchive());
+		Common::ScopedPtr<Common::SeekableReadStream> first(archive->createReadStreamForMember("large.bin"));
+		Common::ScopedPtr<Common::SeekableReadStream> second(archive->createReadStreamForMember("large.bin"));
+		Common::ScopedPtr<Common::SeekableReadStream> stored(archive->createReadStreamForMember("stored.bin"));
+
+		second->seek(1000000);
+		for (uint32 i = 0; i < 50; ++i) {
+			TS_ASSERT(checkRange(first.get(), _large, i * 5000, 5000));
+			TS_ASSERT(checkRange(second.get(), _large, 1000000 + i * 5000, 5000));
+			TS_ASSERT(checkRange(stored.get(), _small, i * 20, 20));
+		}
+	}
+#endif
+};
@@ -0,0 +1,64 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/zlib.h"
+
+class ZlibTestSuite : public CxxTest::TestSuite {
+	enum {
+		kSize = 256 * 1024
+	};
+
+	byte *_data;
+
+	// Compresses the test data, and returns the size of the result if it
+	// decompresses to the test data again, or 0 otherwise
+	uint32 roundTrip(int level) {
+		Common::MemoryWriteStreamDynamic *out = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *compressor = Common::wrapCompressedWriteStream(out, level);
+		compressor->write(_data, kSize);
+		compressor->finalize();
+		const bool written = !compressor->err();
+
+		byte *compressed = out->getData();
+		const uint32 compressedSize = out->size();
+		delete compressor;
+
+		Common::SeekableReadStream *in = Common::wrapCompressedReadStream(new Common::MemoryReadStream(compressed, compressedSize, DisposeAfterUse::YES));
+		byte *buffer = new byte[kSize + 1];
+		const bool ok = written && in->read(buffer, kSize + 1) == kSize && !memcmp(buffer, _data, kSize);
+		delete[] buffer;
+		delete in;
+
+		return ok ? compressedSize : 0;
+	}
+
+public:
+	void setUp() {
+		_data = new byte[kSize];
+		uint32 seed = 1;
+		for (uint32 i = 0; i < kSize; ++i) {
+			seed = seed * 1103515245 + 12345;
+			_data[i] = (i & 7) ? 'a' + ((seed >> 16) % 12) : 0;
+		}
+	}
+
+	void tearDown() {
+		delete[] _data;
+	}
+
+#ifdef USE_ZLIB
+	void test_compression_levels() {
+		const uint32 stored = roundTrip(0);
+		const uint32 fast = roundTrip(1);
+		const uint32 standard = roundTrip(-1);
+		const uint32 best = roundTrip(9);
+
+		TS_ASSERT_LESS_THAN(kSize, stored);
+		TS_ASSERT_LESS_THAN(0u, fast);
+		TS_ASSERT_LESS_THAN(fast, stored);
+		TS_ASSERT_LESS_THAN(0u, best);
+		TS_ASSERT_LESS_THAN_EQUALS(best, standard);
+		TS_ASSERT_LESS_THAN_EQUALS(standard, fast);
+	}
+#endif
+};
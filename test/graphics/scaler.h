@@ -0,0 +1,227 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scaler.h"
+
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq_intern.h"
+#endif
+
+class ScalerTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 38,
+		kHeight = 22,
+		kBorder = 2,
+		kPitch = kWidth + 2 * kBorder
+	};
+
+	struct Scaler {
+		const char *name;
+		ScalerProc *proc;
+		// 0 stands for the 1.5x scaler, which needs an even width and height
+		int factor;
+		// Darkens some of the pixels on purpose
+		bool darkens;
+	};
+
+	static uint32 noise(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 16;
+	}
+
+	static const Scaler *scalers() {
+		static const Scaler list[] = {
+			{ "Normal1x", Normal1x, 1, false },
+#ifdef USE_SCALERS
+			{ "Normal2x", Normal2x, 2, false },
+			{ "Normal3x", Normal3x, 3, false },
+			{ "Normal1o5x", Normal1o5x, 0, false },
+			{ "2xSaI", _2xSaI, 2, false },
+			{ "Super2xSaI", Super2xSaI, 2, false },
+			{ "SuperEagle", SuperEagle, 2, false },
+			{ "AdvMame2x", AdvMame2x, 2, false },
+			{ "AdvMame3x", AdvMame3x, 3, false },
+			{ "TV2x", TV2x, 2, true },
+			{ "DotMatrix", DotMatrix, 2, true },
+#ifdef USE_HQ_SCALERS
+			{ "HQ2x", HQ2x, 2, false },
+			{ "HQ3x", HQ3x, 3, false },
+#endif
+#endif
+			{ 0, 0, 0, false }
+		};
+		return list;
+	}
+
+	static int scaledSize(int size, int factor) {
+		return factor ? size * factor : size * 3 / 2;
+	}
+
+	// A blocky image with a few colors and some noise, so that the edge
+	// detection of the smarter scalers has something to do. The 32 bit
+	// image contains the same colors as the 16 bit one.
+	static void createImages(const Graphics::PixelFormat &format16, const Graphics::PixelFormat &format32, uint16 *image16, uint32 *image32) {
+		uint32 seed = 1;
+		uint16 palette[16];
+		for (int i = 0; i < 16; ++i)
+			palette[i] = noise(seed);
+
+		for (int y = 0; y < kHeight + 2 * kBorder; ++y) {
+			for (int x = 0; x < kPitch; ++x) {
+				int c = ((x / 5) + (y / 3)) & 15;
+				if ((noise(seed) & 7) == 0)
+					c = noise(seed) & 15;
+
+				uint8 r, g, b;
+				format16.colorToRGB(palette[c], r, g, b);
+				image16[y * kPitch + x] = palette[c];
+				image32[y * kPitch + x] = format32.RGBToColor(r, g, b);
+			}
+		}
+	}
+
+	static void scale(const Scaler &scaler, const Graphics::PixelFormat &format, const void *image, byte *dst, uint32 dstPitch) {
+		const byte *src = (const byte *)image + (kBorder * kPitch + kBorder) * format.bytesPerPixel;
+		InitScalers(format);
+		scaler.proc(src, kPitch * format.bytesPerPixel, dst, dstPitch, kWidth, kHeight);
+	}
+
+public:
+	void tearDown() {
+		DestroyScalers();
+	}
+
+	// The 32 bit scalers make the same decisions as the 16 bit ones on an
+	// image with the same colors, but interpolate with more precision. So
+	// the results may only differ by about one step of a 5 bit channel.
+	void test_32bit_matches_16bit() {
+		const Graphics::PixelFormat format16(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat format32(4, 8, 8, 8, 8, 16, 8, 0, 24);
+
+		uint16 *image16 = new uint16[kPitch * (kHeight + 2 * kBorder)];
+		uint32 *image32 = new uint32[kPitch * (kHeight + 2 * kBorder)];
+		createImages(format16, format32, image16, image32);
+
+		for (const Scaler *scaler = scalers(); scaler->name; ++scaler) {
+			const int width = scaledSize(kWidth, scaler->factor);
+			const int height = scaledSize(kHeight, scaler->factor);
+			uint16 *dst16 = new uint16[width * height];
+			uint32 *dst32 = new uint32[width * height];
+
+			scale(*scaler, format16, image16, (byte *)dst16, width * 2);
+			scale(*scaler, format32, image32, (byte *)dst32, width * 4);
+
+			int maxError = 0;
+			bool opaque = true;
+			for (int i = 0; i < width * height; ++i) {
+				uint8 a, r16, g16, b16, r32, g32, b32;
+				format16.colorToRGB(dst16[i], r16, g16, b16);
+				format32.colorToARGB(dst32[i], a, r32, g32, b32);
+				maxError = MAX(maxError, ABS(r16 - r32));
+				maxError = MAX(maxError, ABS(g16 - g32));
+				maxError = MAX(maxError, ABS(b16 - b32));
+				opaque = opaque && a == 255;
+			}
+
+			TSM_ASSERT_LESS_THAN_EQUALS(scaler->name, maxError, 8);
+			TSM_ASSERT(scaler->name, opaque);
+
+			delete[] dst16;
+			delete[] dst32;
+		}
+
+		delete[] image16;
+		delete[] image32;
+	}
+
+	// Interpolating a single color must not change it
+	void test_32bit_uniform() {
+		const Graphics::PixelFormat format32(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		const uint32 color = format32.ARGBToColor(255, 201, 13, 77);
+
+		uint32 *image = new uint32[kPitch * (kHeight + 2 * kBorder)];
+		for (int i = 0; i < kPitch * (kHeight + 2 * kBorder); ++i)
+			image[i] = color;
+
+		for (const Scaler *scaler = scalers(); scaler->name; ++scaler) {
+			if (scaler->darkens)
+				continue;
+
+			const int width = scaledSize(kWidth, scaler->factor);
+			const int height = scaledSize(kHeight, scaler->factor);
+			uint32 *dst = new uint32[width * height];
+			scale(*scaler, format32, image, (byte *)dst, width * 4);
+
+			int mismatches = 0;
+			for (int i = 0; i < width * height; ++i) {
+				if (dst[i] != color)
+					mismatches++;
+			}
+			TSM_ASSERT_EQUALS(scaler->name, mismatches, 0);
+
+			delete[] dst;
+		}
+
+		delete[] image;
+	}
+
+	static void checkScalerRect(ScalerProc *proc, bool aspectRatioCorrection, int x, int y, int w, int h) {
+		int rx = 10, ry = 20, rw = 30, rh = 40;
+		extendScalerRect(proc, aspectRatioCorrection, rx, ry, rw, rh);
+		TS_ASSERT_EQUALS(rx, x);
+		TS_ASSERT_EQUALS(ry, y);
+		TS_ASSERT_EQUALS(rw, w);
+		TS_ASSERT_EQUALS(rh, h);
+	}
+
+	void test_scaler_rect() {
+		checkScalerRect(Normal1x, false, 10, 20, 30, 40);
+		// The aspect ratio correction reads the line above every line
+		checkScalerRect(Normal1x, true, 10, 19, 30, 42);
+#ifdef USE_SCALERS
+		checkScalerRect(Normal2x, false, 10, 20, 30, 40);
+		checkScalerRect(Normal3x, true, 10, 19, 30, 42);
+		checkScalerRect(TV2x, true, 10, 19, 30, 42);
+		checkScalerRect(DotMatrix, false, 10, 20, 30, 40);
+		checkScalerRect(_2xSaI, false, 9, 19, 32, 42);
+		checkScalerRect(AdvMame3x, true, 9, 19, 32, 42);
+#endif
+	}
+
+#ifdef USE_HQ_SCALERS
+	// Compares the edge detection of the hq scalers with diffYUV(). The
+	// neighbours are close to the center pixel, so that all the channels
+	// end up on both sides of their thresholds.
+	void test_hq_pattern() {
+		uint32 seed = 42;
+		int mismatches = 0;
+
+		for (int i = 0; i < 20000; ++i) {
+			uint32 rows[3][3];
+			const int y = noise(seed) & 0xFF, u = noise(seed) & 0xFF, v = noise(seed) & 0xFF;
+			for (int j = 0; j < 9; ++j) {
+				const int dy = (int)(noise(seed) % 121) - 60;
+				const int du = (int)(noise(seed) % 21) - 10;
+				const int dv = (int)(noise(seed) % 17) - 8;
+				rows[j / 3][j % 3] = (CLIP(y + dy, 0, 255) << 16) | (CLIP(u + du, 0, 255) << 8) | CLIP(v + dv, 0, 255);
+			}
+
+			// hqPattern() may read one entry past every row
+			uint32 above[4] = { rows[0][0], rows[0][1], rows[0][2], 0 };
+			uint32 current[4] = { rows[1][0], rows[1][1], rows[1][2], 0 };
+			uint32 below[4] = { rows[2][0], rows[2][1], rows[2][2], 0 };
+
+			static const int bits[9] = { 0x01, 0x02, 0x04, 0x08, 0, 0x10, 0x20, 0x40, 0x80 };
+			int expected = 0;
+			for (int j = 0; j < 9; ++j) {
+				if (diffYUV(rows[1][1], rows[j / 3][j % 3]))
+					expected |= bits[j];
+			}
+
+			if (hqPattern(above + 1, current + 1, below + 1) != expected)
+				mismatches++;
+		}
+
+		TS_ASSERT_EQUALS(mismatches, 0);
+	}
+#endif
+};
@@ -0,0 +1,168 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transparent_surface.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite {
+	// The format used by the engines which use TransparentSurface
+	static Graphics::PixelFormat format() {
+		return Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+	}
+
+	static uint32 noise(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return (seed >> 16) | (seed << 16);
+	}
+
+	static void fill(Graphics::Surface &surf, uint32 seed) {
+		for (int y = 0; y < surf.h; y++) {
+			for (int x = 0; x < surf.w; x++) {
+				uint32 pixel = noise(seed);
+				// Make sure that the special alpha values are common
+				switch (pixel & 7) {
+				case 0:
+					pixel &= 0xFFFFFF00;
+					break;
+				case 1:
+					pixel |= 0xFF;
+					break;
+				default:
+					break;
+				}
+				*(uint32 *)surf.getBasePtr(x, y) = pixel;
+			}
+		}
+	}
+
+	static byte component(uint32 pixel, int shift) {
+		return (pixel >> shift) & 0xFF;
+	}
+
+	// Per pixel reference of the blending done by TransparentSurface::blit()
+	static uint32 blend(uint32 src, uint32 dst, Graphics::AlphaType alphaMode, uint32 color, Graphics::TSpriteBlendMode blendMode) {
+		const uint ca = color >> 24;
+		const uint cMod[3] = { (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF };
+		const uint a = src & 0xFF;
+		uint outA = dst & 0xFF;
+		uint out[3], in[3];
+		for (int i = 0; i < 3; i++) {
+			in[i] = component(src, 24 - i * 8);
+			out[i] = component(dst, 24 - i * 8);
+		}
+
+		if (color == 0xFFFFFFFF && blendMode == Graphics::BLEND_NORMAL && alphaMode == Graphics::ALPHA_OPAQUE)
+			return src | 0xFF;
+		if (color == 0xFFFFFFFF && blendMode == Graphics::BLEND_NORMAL && alphaMode == Graphics::ALPHA_BINARY)
+			return a ? (src | 0xFF) : dst;
+
+		if (blendMode == Graphics::BLEND_NORMAL) {
+			if (color == 0xFFFFFFFF) {
+				if (!a)
+					return dst;
+				for (int i = 0; i < 3; i++)
+					out[i] = (in[i] * a + out[i] * (255 - a)) >> 8;
+			} else {
+				const uint ina = a * ca >> 8;
+				for (int i = 0; i < 3; i++)
+					out[i] = (out[i] * (255 - ina) >> 8) + (in[i] * ina * cMod[i] >> 16);
+			}
+			outA = 255;
+		} else if (blendMode == Graphics::BLEND_ADDITIVE) {
+			const uint ina = (color == 0xFFFFFFFF) ? a : (a * ca >> 8);
+			for (int i = 0; i < 3; i++) {
+				if (color == 0xFFFFFFFF || cMod[i] == 255)
+					out[i] = MIN<uint>(out[i] + (in[i] * ina >> 8), 255);
+				else
+					out[i] = MIN<uint>(out[i] + (in[i] * cMod[i] * ina >> 16), 255);
+			}
+		} else {
+			for (int i = 0; i < 3; i++) {
+				if (color == 0xFFFFFFFF || cMod[i] == 255)
+					out[i] -= in[i] * out[i] * a >> 16;
+				else
+					out[i] -= in[i] * cMod[i] * out[i] * a >> 24;
+			}
+			if (color != 0xFFFFFFFF)
+				outA = 255;
+		}
+
+		return (out[0] << 24) | (out[1] << 16) | (out[2] << 8) | outA;
+	}
+
+	void testBlit(int width, int height, int flipping, Graphics::AlphaType alphaMode, uint32 color, Graphics::TSpriteBlendMode blendMode) {
+		const int posX = 3, posY = 2;
+
+		Graphics::TransparentSurface src;
+		src.create(width, height, format());
+		fill(src, width * 31 + height);
+		src.setAlphaMode(alphaMode);
+
+		Graphics::Surface dst, expected;
+		dst.create(width + 8, height + 4, format());
+		fill(dst, color ^ blendMode);
+		expected.copyFrom(dst);
+
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				const int srcX = (flipping & Graphics::FLIP_H) ? width - 1 - x : x;
+				const int srcY = (flipping & Graphics::FLIP_V) ? height - 1 - y : y;
+				uint32 *out = (uint32 *)expected.getBasePtr(posX + x, posY + y);
+				*out = blend(*(const uint32 *)src.getBasePtr(srcX, srcY), *out, alphaMode, color, blendMode);
+			}
+		}
+
+		src.blit(dst, posX, posY, flipping, nullptr, color, -1, -1, blendMode);
+
+		for (int y = 0; y < dst.h; y++) {
+			TS_ASSERT_SAME_DATA(dst.getBasePtr(0, y), expected.getBasePtr(0, y), dst.w * 4);
+		}
+
+		src.free();
+		dst.free();
+		expected.free();
+	}
+
+	void testAllSizes(int flipping, Graphics::AlphaType alphaMode, uint32 color, Graphics::TSpriteBlendMode blendMode) {
+		// Sizes which are handled completely by vectorized code, partially,
+		// and not at all
+		static const int sizes[][2] = { { 16, 4 }, { 37, 5 }, { 3, 2 }, { 1, 1 } };
+		for (int i = 0; i < ARRAYSIZE(sizes); i++)
+			testBlit(sizes[i][0], sizes[i][1], flipping, alphaMode, color, blendMode);
+	}
+
+	void testAllFlips(Graphics::AlphaType alphaMode, uint32 color, Graphics::TSpriteBlendMode blendMode) {
+		testAllSizes(Graphics::FLIP_NONE, alphaMode, color, blendMode);
+		testAllSizes(Graphics::FLIP_H, alphaMode, color, blendMode);
+		testAllSizes(Graphics::FLIP_V, alphaMode, color, blendMode);
+		testAllSizes(Graphics::FLIP_HV, alphaMode, color, blendMode);
+	}
+
+public:
+	void test_opaque() {
+		// Horizontal flipping isn't supported by the opaque blitter
+		testAllSizes(Graphics::FLIP_NONE, Graphics::ALPHA_OPAQUE, 0xFFFFFFFF, Graphics::BLEND_NORMAL);
+		testAllSizes(Graphics::FLIP_V, Graphics::ALPHA_OPAQUE, 0xFFFFFFFF, Graphics::BLEND_NORMAL);
+	}
+
+	void test_binary() {
+		testAllFlips(Graphics::ALPHA_BINARY, 0xFFFFFFFF, Graphics::BLEND_NORMAL);
+	}
+
+	void test_alpha_blend() {
+		testAllFlips(Graphics::ALPHA_FULL, 0xFFFFFFFF, Graphics::BLEND_NORMAL);
+		testAllFlips(Graphics::ALPHA_FULL, 0x80FF4020, Graphics::BLEND_NORMAL);
+		testAllFlips(Graphics::ALPHA_OPAQUE, 0xFFFFFF00, Graphics::BLEND_NORMAL);
+		testAllFlips(Graphics::ALPHA_BINARY, 0x01020304, Graphics::BLEND_NORMAL);
+	}
+
+	void test_additive_blend() {
+		testAllFlips(Graphics::ALPHA_FULL, 0xFFFFFFFF, Graphics::BLEND_ADDITIVE);
+		testAllFlips(Graphics::ALPHA_FULL, 0x80FF4020, Graphics::BLEND_ADDITIVE);
+		testAllFlips(Graphics::ALPHA_FULL, 0xFE00FFFE, Graphics::BLEND_ADDITIVE);
+	}
+
+	void test_subtractive_blend() {
+		testAllFlips(Graphics::ALPHA_FULL, 0xFFFFFFFF, Graphics::BLEND_SUBTRACTIVE);
+		testAllFlips(Graphics::ALPHA_FULL, 0x80FF4020, Graphics::BLEND_SUBTRACTIVE);
+		testAllFlips(Graphics::ALPHA_FULL, 0xFEFEFEFE, Graphics::BLEND_SUBTRACTIVE);
+	}
+};
@@ -0,0 +1,284 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_FREETYPE2
+
+#include "common/memstream.h"
+#include "common/ustr.h"
+
+#include "graphics/font.h"
+#include "graphics/surface.h"
+#include "graphics/fonts/ttf.h"
+
+#include <stdio.h>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+class TTFFontTestSuite : public CxxTest::TestSuite {
+	// Draws text the way TTFFont did before it packed its glyphs into an
+	// atlas: every glyph is rendered by FreeType on its own and blended
+	// straight from the FreeType bitmap.
+	class ReferenceFont {
+	public:
+		ReferenceFont(const byte *data, uint32 size, int pointSize) : _library(), _face(), _ascent(0) {
+			FT_Init_FreeType(&_library);
+			FT_New_Memory_Face(_library, data, size, 0, &_face);
+			FT_Set_Char_Size(_face, 0, pointSize * 64, 0, 0);
+			_ascent = ceil26_6(FT_MulFix(_face->ascender, _face->size->metrics.y_scale));
+		}
+
+		~ReferenceFont() {
+			FT_Done_Face(_face);
+			FT_Done_FreeType(_library);
+		}
+
+		int getCharWidth(uint32 chr) const {
+			if (!loadGlyph(chr))
+				return 0;
+			return ceil26_6(_face->glyph->advance.x);
+		}
+
+		int getKerningOffset(uint32 left, uint32 right) const {
+			const FT_UInt leftGlyph = FT_Get_Char_Index(_face, left);
+			const FT_UInt rightGlyph = FT_Get_Char_Index(_face, right);
+			if (!FT_HAS_KERNING(_face) || !leftGlyph || !rightGlyph)
+				return 0;
+
+			FT_Vector kerningVector;
+			FT_Get_Kerning(_face, leftGlyph, rightGlyph, FT_KERNING_DEFAULT, &kerningVector);
+			return kerningVector.x / 64;
+		}
+
+		void drawChar(Graphics::Surface &dst, uint32 chr, int x, int y, uint32 color) const {
+			if (!loadGlyph(chr) || FT_Render_Glyph(_face->glyph, FT_RENDER_MODE_LIGHT))
+				return;
+
+			const FT_Bitmap &bitmap = _face->glyph->bitmap;
+			x += _face->glyph->bitmap_left;
+			y += _ascent - _face->glyph->bitmap_top;
+
+			uint8 sR, sG, sB;
+			dst.format.colorToRGB(color, sR, sG, sB);
+
+			for (int cy = 0; cy < (int)bitmap.rows; ++cy) {
+				for (int cx = 0; cx < (int)bitmap.width; ++cx) {
+					if (x + cx < 0 || x + cx >= dst.w || y + cy < 0 || y + cy >= dst.h)
+						continue;
+
+					const uint a = bitmap.buffer[cy * bitmap.pitch + cx];
+					if (a == 255) {
+						writePixel(dst, x + cx, y + cy, color);
+					} else if (a) {
+						uint8 dR, dG, dB;
+						dst.format.colorToRGB(readPixel(dst, x + cx, y + cy), dR, dG, dB);
+
+						dR = ((255 - a) * dR + a * sR) / 255;
+						dG = ((255 - a) * dG + a * sG) / 255;
+						dB = ((255 - a) * dB + a * sB) / 255;
+
+						writePixel(dst, x + cx, y + cy, dst.format.RGBToColor(dR, dG, dB));
+					}
+				}
+			}
+		}
+
+		void drawString(Graphics::Surface &dst, const Common::U32String &str, int x, int y, int w, uint32 color) const {
+			const int rightX = x + w;
+
+			uint32 last = 0;
+			for (uint i = 0; i < str.size(); ++i) {
+				const uint32 cur = str[i];
+				if (last)
+					x += getKerningOffset(last, cur);
+				last = cur;
+				w = getCharWidth(cur);
+				if (x + w > rightX)
+					break;
+				drawChar(dst, cur, x, y, color);
+				x += w;
+			}
+		}
+
+	private:
+		static int ceil26_6(FT_Pos x) {
+			return (x + 63) / 64;
+		}
+
+		bool loadGlyph(uint32 chr) const {
+			const FT_UInt slot = FT_Get_Char_Index(_face, chr);
+			return slot && !FT_Load_Glyph(_face, slot, FT_LOAD_TARGET_LIGHT);
+		}
+
+		FT_Library _library;
+		FT_Face _face;
+		int _ascent;
+	};
+
+	static uint32 readPixel(const Graphics::Surface &surf, int x, int y) {
+		if (surf.format.bytesPerPixel == 2)
+			return *(const uint16 *)surf.getBasePtr(x, y);
+		return *(const uint32 *)surf.getBasePtr(x, y);
+	}
+
+	static void writePixel(Graphics::Surface &surf, int x, int y, uint32 color) {
+		if (surf.format.bytesPerPixel == 2)
+			*(uint16 *)surf.getBasePtr(x, y) = color;
+		else
+			*(uint32 *)surf.getBasePtr(x, y) = color;
+	}
+
+	// Fills the surface with a pattern, so that blending is visible
+	static void fillBackground(Graphics::Surface &surf) {
+		uint32 seed = 1;
+		for (int y = 0; y < surf.h; ++y) {
+			for (int x = 0; x < surf.w; ++x) {
+				seed = seed * 1103515245 + 12345;
+				writePixel(surf, x, y, surf.format.RGBToColor(seed >> 24, seed >> 16, seed >> 8));
+			}
+		}
+	}
+
+	static int countDifferences(const Graphics::Surface &a, const Graphics::Surface &b) {
+		int differences = 0;
+		for (int y = 0; y < a.h; ++y) {
+			for (int x = 0; x < a.w; ++x) {
+				if (readPixel(a, x, y) != readPixel(b, x, y))
+					++differences;
+			}
+		}
+		return differences;
+	}
+
+	static byte *readFontFile(const char *name, uint32 &size) {
+		const Common::String path = Common::String::format("%s/gui/themes/fonts/%s", TEST_SRCDIR, name);
+		FILE *file = fopen(path.c_str(), "rb");
+		if (!file)
+			return 0;
+
+		Common::MemoryWriteStreamDynamic data(DisposeAfterUse::NO);
+		byte buffer[4096];
+		size_t read;
+		while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+			data.write(buffer, read);
+		fclose(file);
+
+		size = data.size();
+		return data.getData();
+	}
+
+	static Graphics::Font *loadFont(const byte *data, uint32 size, int pointSize) {
+		Common::MemoryReadStream stream(data, size);
+		return Graphics::loadTTFFont(stream, pointSize);
+	}
+
+	static Graphics::PixelFormat format(int bytesPerPixel) {
+		if (bytesPerPixel == 2)
+			return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		return Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24);
+	}
+
+public:
+	void test_draw_string_matches_reference() {
+		// Kerning pairs and ISO-8859-1 characters, which are loaded along
+		// with the font
+		static const char text[] = "AVATAR To Yves: Wolf's \"quay\" L'T, P. F. \xC4rger \xFC\xDF \xE9t\xE9 \xA9 1.7";
+
+		uint32 size;
+		byte *data = readFontFile("FreeSans.ttf", size);
+		TS_ASSERT(data);
+		if (!data)
+			return;
+
+		static const int pointSizes[] = { 9, 12, 24 };
+		for (int i = 0; i < ARRAYSIZE(pointSizes); ++i) {
+			Graphics::Font *font = loadFont(data, size, pointSizes[i]);
+			TS_ASSERT(font);
+			if (!font)
+				continue;
+			ReferenceFont reference(data, size, pointSizes[i]);
+
+			Common::U32String str;
+			for (const char *c = text; *c; ++c)
+				str += (uint32)(byte)*c;
+
+			for (int bytesPerPixel = 2; bytesPerPixel <= 4; bytesPerPixel += 2) {
+				Graphics::Surface expected, actual;
+				expected.create(800, 48, format(bytesPerPixel));
+				actual.create(800, 48, format(bytesPerPixel));
+				fillBackground(expected);
+				fillBackground(actual);
+
+				const uint32 color = expected.format.RGBToColor(0xE0, 0x40, 0x20);
+				reference.drawString(expected, str, 4, 4, 792, color);
+				font->drawString(&actual, str, 4, 4, 792, color);
+
+				TS_ASSERT_EQUALS(countDifferences(expected, actual), 0);
+
+				expected.free();
+				actual.free();
+			}
+
+			delete font;
+		}
+
+		free(data);
+	}
+
+	void test_evicted_glyphs_match_reference() {
+		// Far more glyphs than fit into the cache pages, and more characters
+		// than the font keeps glyphs for, drawn twice so that the second
+		// round draws glyphs, which were evicted or dropped and loaded again
+		static const struct {
+			uint32 first, last;
+		} ranges[] = {
+			{ 0x0100, 0x024F }, // Latin Extended-A and B
+			{ 0x0370, 0x03FF }, // Greek
+			{ 0x0400, 0x04FF }, // Cyrillic
+			{ 0x4E00, 0x55FF }  // CJK ideographs, which the font lacks
+		};
+
+		uint32 size;
+		byte *data = readFontFile("FreeSans.ttf", size);
+		TS_ASSERT(data);
+		if (!data)
+			return;
+
+		Graphics::Font *font = loadFont(data, size, 48);
+		TS_ASSERT(font);
+		ReferenceFont reference(data, size, 48);
+
+		Graphics::Surface background, expected, actual;
+		background.create(96, 96, format(4));
+		expected.create(96, 96, format(4));
+		actual.create(96, 96, format(4));
+		fillBackground(background);
+
+		const uint32 color = background.format.RGBToColor(0x20, 0x40, 0xE0);
+
+		for (int round = 0; font && round < 2; ++round) {
+			for (int range = 0; range < ARRAYSIZE(ranges); ++range) {
+				for (uint32 chr = ranges[range].first; chr <= ranges[range].last; ++chr) {
+					expected.copyFrom(background);
+					actual.copyFrom(background);
+
+					reference.drawChar(expected, chr, 8, 8, color);
+					font->drawChar(&actual, chr, 8, 8, color);
+
+					TS_ASSERT_EQUALS(font->getCharWidth(chr), reference.getCharWidth(chr));
+					TS_ASSERT_EQUALS(countDifferences(expected, actual), 0);
+				}
+			}
+		}
+
+		background.free();
+		expected.free();
+		actual.free();
+
+		delete font;
+		free(data);
+	}
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	static byte noise(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return (byte)(seed >> 16);
+	}
+
+	// Values at the edges of the luminance and chroma ranges
+	static byte extremeNoise(uint32 &seed) {
+		static const byte values[] = { 0, 1, 15, 16, 127, 128, 235, 236, 254, 255 };
+		return values[noise(seed) % ARRAYSIZE(values)];
+	}
+
+	static int clampChannel(int value, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		if (scale == Graphics::YUVToRGBManager::kScaleFull)
+			return CLIP(value, 0, 255);
+		return (CLIP(value, 16, 235) - 16) * 255 / 219;
+	}
+
+	// Straightforward per pixel version of what the lookup tables compute
+	static uint32 referenceColor(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, byte y, byte u, byte v) {
+		const int16 CR = v - 128, CB = u - 128;
+		const int r = y + (int16)((0.419 / 0.299) * CR);
+		const int g = y + (int16)(-(0.299 / 0.419) * CR) + (int16)(-(0.114 / 0.331) * CB);
+		const int b = y + (int16)((0.587 / 0.331) * CB);
+		return format.RGBToColor(clampChannel(r, scale), clampChannel(g, scale), clampChannel(b, scale));
+	}
+
+	static uint32 getPixel(const Graphics::Surface &surface, int x, int y) {
+		if (surface.format.bytesPerPixel == 2)
+			return *(const uint16 *)surface.getBasePtr(x, y);
+		return *(const uint32 *)surface.getBasePtr(x, y);
+	}
+
+	// Converts a noise image with the given chroma subsampling, and checks
+	// every pixel against referenceColor(), which computes what the scalar
+	// converters output. The widths used below leave pixels for the scalar
+	// code after the vectorized part of each row. Columns that do not fill
+	// a whole chroma sample are not converted and must stay untouched.
+	void testConversion(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, int shift, int width, int height, bool extremes = false) {
+		const int uvWidth = (width >> shift) + 1;
+		const int uvHeight = (height >> shift) + 1;
+		const int yPitch = width + 3;
+		uint32 seed = width * height + shift;
+
+		byte *yPlane = new byte[yPitch * height];
+		byte *uPlane = new byte[uvWidth * uvHeight];
+		byte *vPlane = new byte[uvWidth * uvHeight];
+		for (int i = 0; i < yPitch * height; i++)
+			yPlane[i] = extremes ? extremeNoise(seed) : noise(seed);
+		for (int i = 0; i < uvWidth * uvHeight; i++) {
+			uPlane[i] = extremes ? extremeNoise(seed) : noise(seed);
+			vPlane[i] = extremes ? extremeNoise(seed) : noise(seed);
+		}
+
+		Graphics::Surface surface;
+		surface.create(width, height, format);
+		memset(surface.getPixels(), 0xA5, surface.pitch * height);
+		const uint32 untouched = getPixel(surface, 0, 0);
+		const int convertedWidth = width & ~((1 << shift) - 1);
+
+		if (shift == 0)
+			YUVToRGBMan.convert444(&surface, scale, yPlane, uPlane, vPlane, width, height, yPitch, uvWidth);
+		else if (shift == 1)
+			YUVToRGBMan.convert420(&surface, scale, yPlane, uPlane, vPlane, width, height, yPitch, uvWidth);
+		else
+			YUVToRGBMan.convert410(&surface, scale, yPlane, uPlane, vPlane, width, height, yPitch, uvWidth);
+
+		int mismatches = 0;
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				byte u, v;
+				if (shift == 2) {
+					// Bilinear interpolation, see convert410()
+					const int xDiff = x & 3, yDiff = y & 3;
+					const int index = (y >> 2) * uvWidth + (x >> 2);
+					u = (uPlane[index] * (4 - xDiff) * (4 - yDiff) + uPlane[index + 1] * xDiff * (4 - yDiff) +
+					     uPlane[index + uvWidth] * yDiff * (4 - xDiff) + uPlane[index + uvWidth + 1] * xDiff * yDiff) >> 4;
+					v = (vPlane[index] * (4 - xDiff) * (4 - yDiff) + vPlane[index + 1] * xDiff * (4 - yDiff) +
+					     vPlane[index + uvWidth] * yDiff * (4 - xDiff) + vPlane[index + uvWidth + 1] * xDiff * yDiff) >> 4;
+				} else {
+					u = uPlane[(y >> shift) * uvWidth + (x >> shift)];
+					v = vPlane[(y >> shift) * uvWidth + (x >> shift)];
+				}
+
+				if (x >= convertedWidth) {
+					if (getPixel(surface, x, y) != untouched)
+						mismatches++;
+				} else if (getPixel(surface, x, y) != referenceColor(format, scale, yPlane[y * yPitch + x], u, v)) {
+					mismatches++;
+				}
+			}
+		}
+		TS_ASSERT_EQUALS(mismatches, 0);
+
+		surface.free();
+		delete[] yPlane;
+		delete[] uPlane;
+		delete[] vPlane;
+	}
+
+	void testAllFormats(int shift, int width, int height) {
+		const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat argb4444(2, 4, 4, 4, 4, 8, 4, 0, 12);
+		const Graphics::PixelFormat argb8888(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		const Graphics::PixelFormat bgr888(4, 8, 8, 8, 0, 0, 8, 16, 0);
+
+		testConversion(rgb565, Graphics::YUVToRGBManager::kScaleFull, shift, width, height);
+		testConversion(rgb565, Graphics::YUVToRGBManager::kScaleITU, shift, width, height);
+		testConversion(argb4444, Graphics::YUVToRGBManager::kScaleITU, shift, width, height);
+		testConversion(argb8888, Graphics::YUVToRGBManager::kScaleFull, shift, width, height);
+		testConversion(argb8888, Graphics::YUVToRGBManager::kScaleITU, shift, width, height);
+		testConversion(bgr888, Graphics::YUVToRGBManager::kScaleFull, shift, width, height);
+	}
+
+public:
+	void test_yuv444() {
+		testAllFormats(0, 37, 5);
+		testAllFormats(0, 300, 2);
+	}
+
+	void test_yuv420() {
+		testAllFormats(1, 38, 6);
+		testAllFormats(1, 270, 4);
+		testAllFormats(1, 39, 4);
+		testAllFormats(1, 17, 2);
+		testAllFormats(1, 271, 2);
+	}
+
+	void test_yuv410() {
+		testAllFormats(2, 36, 8);
+		testAllFormats(2, 268, 4);
+		testAllFormats(2, 37, 4);
+		testAllFormats(2, 38, 4);
+		testAllFormats(2, 39, 8);
+		testAllFormats(2, 15, 4);
+		testAllFormats(2, 270, 4);
+	}
+
+	void test_extremes() {
+		const Graphics::PixelFormat argb8888(4, 8, 8, 8, 8, 16, 8, 0, 24);
+
+		testConversion(argb8888, Graphics::YUVToRGBManager::kScaleFull, 0, 512, 16, true);
+		testConversion(argb8888, Graphics::YUVToRGBManager::kScaleITU, 0, 512, 16, true);
+		testConversion(argb8888, Graphics::YUVToRGBManager::kScaleITU, 1, 512, 16, true);
+	}
+};
@@ -5,12 +5,23 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h
+TEST_LIBS    := audio/libaudio.a graphics/libgraphics.a common/libcommon.a
+
+ifdef USE_BINK
+TESTS        += $(srcdir)/test/video/*.h
+TEST_LIBS    := video/libvideo.a $(TEST_LIBS)
+endif
 
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
 TEST_CFLAGS  := -I$(srcdir)/test/cxxtest
+
+# test/graphics/ttf.h reads one of the fonts shipped with the GUI themes,
+# and includes the FreeType headers, which use setjmp.
+TEST_CFLAGS  += -DTEST_SRCDIR=\"$(srcdir)\" -DFORBIDDEN_SYMBOL_EXCEPTION_FILE \
+	-DFORBIDDEN_SYMBOL_EXCEPTION_fopen -DFORBIDDEN_SYMBOL_EXCEPTION_fread -DFORBIDDEN_SYMBOL_EXCEPTION_fclose \
+	-DFORBIDDEN_SYMBOL_EXCEPTION_setjmp -DFORBIDDEN_SYMBOL_EXCEPTION_longjmp
 TEST_LDFLAGS := $(LIBS)
 TEST_CXXFLAGS := $(filter-out -Wglobal-constructors,$(CXXFLAGS))
 
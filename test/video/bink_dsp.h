@@ -0,0 +1,123 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/bink_dsp.h"
+
+// Compares the Bink block functions with their generic versions, on
+// random coefficients and pixels. The generic versions are the original
+// decoder code.
+class BinkDSPTestSuite : public CxxTest::TestSuite {
+	enum {
+		kPitch = 40,
+		kRows = 20
+	};
+
+	uint32 _seed;
+
+	uint32 noise() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	// Sparse coefficients like the decoder reads them. A large range lets
+	// the transform overflow 16 bits, which must wrap like in the generic
+	// code. Every other block only has a DC value, for the IDCT shortcuts.
+	void fillBlock(int16 *block, int i) {
+		memset(block, 0, 64 * sizeof(int16));
+		for (int j = 0; j < 64; j++) {
+			if (j == 0 || ((i & 1) && (noise() & 3) == 0))
+				block[j] = (int16)noise();
+		}
+		if (i & 2) {
+			for (int j = 0; j < 64; j++)
+				block[j] >>= 6;
+		}
+	}
+
+	void fillPixels(byte *pixels) {
+		for (int j = 0; j < kPitch * kRows; j++)
+			pixels[j] = (byte)noise();
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+	}
+
+	void test_idct_put() {
+		for (int i = 0; i < 2000; i++) {
+			int16 block[64], copy[64];
+			byte expected[kPitch * kRows], result[kPitch * kRows];
+
+			fillBlock(block, i);
+			fillPixels(expected);
+			memcpy(copy, block, sizeof(block));
+			memcpy(result, expected, sizeof(expected));
+
+			Video::binkIDCTPutGeneric(expected + 3, kPitch, block);
+			Video::binkIDCTPut(result + 3, kPitch, copy);
+			TS_ASSERT_EQUALS(memcmp(result, expected, sizeof(expected)), 0);
+		}
+	}
+
+	void test_idct_add() {
+		for (int i = 0; i < 2000; i++) {
+			int16 block[64], copy[64];
+			byte expected[kPitch * kRows], result[kPitch * kRows];
+
+			fillBlock(block, i);
+			fillPixels(expected);
+			memcpy(copy, block, sizeof(block));
+			memcpy(result, expected, sizeof(expected));
+
+			Video::binkIDCTAddGeneric(expected + 5, kPitch, block);
+			Video::binkIDCTAdd(result + 5, kPitch, copy);
+			TS_ASSERT_EQUALS(memcmp(result, expected, sizeof(expected)), 0);
+		}
+	}
+
+	void test_idct_put_scaled() {
+		for (int i = 0; i < 2000; i++) {
+			int16 block[64], copy[64];
+			byte expected[kPitch * kRows], result[kPitch * kRows];
+
+			fillBlock(block, i);
+			fillPixels(expected);
+			memcpy(copy, block, sizeof(block));
+			memcpy(result, expected, sizeof(expected));
+
+			Video::binkIDCTPutScaledGeneric(expected + 7, kPitch, block);
+			Video::binkIDCTPutScaled(result + 7, kPitch, copy);
+			TS_ASSERT_EQUALS(memcmp(result, expected, sizeof(expected)), 0);
+		}
+	}
+
+	void test_add_residue() {
+		for (int i = 0; i < 2000; i++) {
+			int16 block[64];
+			byte expected[kPitch * kRows], result[kPitch * kRows];
+
+			for (int j = 0; j < 64; j++)
+				block[j] = (int16)noise();
+			fillPixels(expected);
+			memcpy(result, expected, sizeof(expected));
+
+			Video::binkAddResidueGeneric(expected + 1, kPitch, block);
+			Video::binkAddResidue(result + 1, kPitch, block);
+			TS_ASSERT_EQUALS(memcmp(result, expected, sizeof(expected)), 0);
+		}
+	}
+
+	void test_copy_block() {
+		for (int size = 8; size <= 16; size += 8) {
+			byte src[kPitch * kRows], expected[kPitch * kRows], result[kPitch * kRows];
+
+			fillPixels(src);
+			fillPixels(expected);
+			memcpy(result, expected, sizeof(expected));
+
+			Video::binkCopyBlockGeneric(expected + 2, kPitch, src + 9, kPitch - 1, size);
+			Video::binkCopyBlock(result + 2, kPitch, src + 9, kPitch - 1, size);
+			TS_ASSERT_EQUALS(memcmp(result, expected, sizeof(expected)), 0);
+		}
+	}
+};
@@ -0,0 +1,328 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The IDCT is based on the Bink decoder found in FFmpeg.
+
+#include "common/scummsys.h"
+
+#ifdef USE_BINK
+
+#include "video/bink_dsp.h"
+#include "common/simd.h"
+
+namespace Video {
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
+#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
+    const int a0 = (src)[s0] + (src)[s4]; \
+    const int a1 = (src)[s0] - (src)[s4]; \
+    const int a2 = (src)[s2] + (src)[s6]; \
+    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
+    const int a4 = (src)[s5] + (src)[s3]; \
+    const int a5 = (src)[s5] - (src)[s3]; \
+    const int a6 = (src)[s1] + (src)[s7]; \
+    const int a7 = (src)[s1] - (src)[s7]; \
+    const int b0 = a4 + a6; \
+    const int b1 = (A3*(a5 + a7)) >> 11; \
+    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
+    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
+    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
+    (dest)[d0] = munge(a0+a2   +b0); \
+    (dest)[d1] = munge(a1+a3-a2+b2); \
+    (dest)[d2] = munge(a1-a3+a2+b3); \
+    (dest)[d3] = munge(a0-a2   -b4); \
+    (dest)[d4] = munge(a0-a2   +b4); \
+    (dest)[d5] = munge(a1-a3+a2-b3); \
+    (dest)[d6] = munge(a1+a3-a2-b2); \
+    (dest)[d7] = munge(a0+a2   -b0); \
+}
+/* end IDCT_TRANSFORM macro */
+
+#define MUNGE_NONE(x) (x)
+#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
+
+#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
+#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
+
+static inline void IDCTCol(int16 *dest, const int16 *src) {
+	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+		dest[ 0] =
+		dest[ 8] =
+		dest[16] =
+		dest[24] =
+		dest[32] =
+		dest[40] =
+		dest[48] =
+		dest[56] = src[0];
+	} else {
+		IDCT_COL(dest, src);
+	}
+}
+
+/** The IDCT of a block, in place. */
+static void IDCT(int16 *block) {
+	int i;
+	int16 temp[64];
+
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	}
+}
+
+void binkIDCTPutGeneric(byte *dest, uint32 pitch, int16 *block) {
+	int i;
+	int16 temp[64];
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+void binkIDCTAddGeneric(byte *dest, uint32 pitch, int16 *block) {
+	int i, j;
+
+	IDCT(block);
+	for (i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (j = 0; j < 8; j++)
+			 dest[j] += block[j];
+}
+
+void binkIDCTPutScaledGeneric(byte *dest, uint32 pitch, int16 *block) {
+	IDCT(block);
+
+	int16 *src   = block;
+	byte  *dest1 = dest;
+	byte  *dest2 = dest + pitch;
+	for (int j = 0; j < 8; j++, dest1 += (pitch << 1) - 16, dest2 += (pitch << 1) - 16, src += 8) {
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
+
+	}
+}
+
+void binkAddResidueGeneric(byte *dest, uint32 pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += block[j];
+}
+
+void binkCopyBlockGeneric(byte *dest, uint32 destPitch, const byte *src, uint32 srcPitch, int size) {
+	for (int i = 0; i < size; i++, dest += destPitch, src += srcPitch)
+		memcpy(dest, src, size);
+}
+
+// The SSE2 IDCT needs two transposes and 32 bit intermediate values, so
+// for a plain 8x8 block it is not faster than the generic code. It only
+// pays off for the scaled put, which writes four times as many pixels.
+
+void binkIDCTPut(byte *dest, uint32 pitch, int16 *block) {
+	binkIDCTPutGeneric(dest, pitch, block);
+}
+
+void binkIDCTAdd(byte *dest, uint32 pitch, int16 *block) {
+	binkIDCTAddGeneric(dest, pitch, block);
+}
+
+#ifdef SCUMMVM_SSE2
+
+/** One row of an 8x8 block: eight 16 bit values. */
+typedef __m128i IDCTRow;
+
+/** The low 32 bits of the products of four 32 bit values with c. SSE2 lacks _mm_mullo_epi32(). */
+static inline __m128i IDCTMul(__m128i a, int c) {
+	const __m128i factor = _mm_set1_epi32(c);
+	const __m128i even = _mm_mul_epu32(a, factor);
+	const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), factor);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+/** IDCT_TRANSFORM on four columns at once, one in every 32 bit lane. */
+static inline void IDCTTransform(__m128i *d, const __m128i *s) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = _mm_srai_epi32(IDCTMul(_mm_sub_epi32(s[2], s[6]), A1), 11);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(IDCTMul(_mm_add_epi32(a5, a7), A3), 11);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(IDCTMul(a5, A4), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(IDCTMul(_mm_sub_epi32(a6, a4), A1), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(IDCTMul(a7, A2), 11), b3), b1);
+	const __m128i e0 = _mm_add_epi32(a0, a2);
+	const __m128i e1 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i e2 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	const __m128i e3 = _mm_sub_epi32(a0, a2);
+	d[0] = _mm_add_epi32(e0, b0);
+	d[1] = _mm_add_epi32(e1, b2);
+	d[2] = _mm_add_epi32(e2, b3);
+	d[3] = _mm_sub_epi32(e3, b4);
+	d[4] = _mm_add_epi32(e3, b4);
+	d[5] = _mm_sub_epi32(e2, b3);
+	d[6] = _mm_sub_epi32(e1, b2);
+	d[7] = _mm_sub_epi32(e0, b0);
+}
+
+/**
+ * Transform the columns of eight rows. Like the scalar code, every result
+ * is truncated to 16 bits, and MUNGE_ROW is applied before if munge is set.
+ */
+static inline void IDCTPass(IDCTRow *rows, bool munge) {
+	__m128i lo[8], hi[8], dLo[8], dHi[8];
+
+	for (int i = 0; i < 8; i++) {
+		lo[i] = _mm_srai_epi32(_mm_unpacklo_epi16(rows[i], rows[i]), 16);
+		hi[i] = _mm_srai_epi32(_mm_unpackhi_epi16(rows[i], rows[i]), 16);
+	}
+
+	IDCTTransform(dLo, lo);
+	IDCTTransform(dHi, hi);
+
+	const __m128i round = _mm_set1_epi32(0x7F);
+	for (int i = 0; i < 8; i++) {
+		if (munge) {
+			dLo[i] = _mm_srai_epi32(_mm_add_epi32(dLo[i], round), 8);
+			dHi[i] = _mm_srai_epi32(_mm_add_epi32(dHi[i], round), 8);
+		}
+
+		// Sign extend the low halves, so that the saturating pack keeps them as they are
+		dLo[i] = _mm_srai_epi32(_mm_slli_epi32(dLo[i], 16), 16);
+		dHi[i] = _mm_srai_epi32(_mm_slli_epi32(dHi[i], 16), 16);
+		rows[i] = _mm_packs_epi32(dLo[i], dHi[i]);
+	}
+}
+
+static inline void IDCTTranspose(IDCTRow *rows) {
+	const __m128i t0 = _mm_unpacklo_epi16(rows[0], rows[1]);
+	const __m128i t1 = _mm_unpackhi_epi16(rows[0], rows[1]);
+	const __m128i t2 = _mm_unpacklo_epi16(rows[2], rows[3]);
+	const __m128i t3 = _mm_unpackhi_epi16(rows[2], rows[3]);
+	const __m128i t4 = _mm_unpacklo_epi16(rows[4], rows[5]);
+	const __m128i t5 = _mm_unpackhi_epi16(rows[4], rows[5]);
+	const __m128i t6 = _mm_unpacklo_epi16(rows[6], rows[7]);
+	const __m128i t7 = _mm_unpackhi_epi16(rows[6], rows[7]);
+
+	const __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+	const __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+	const __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+	const __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+	const __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+	const __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+	const __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+	const __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+	rows[0] = _mm_unpacklo_epi64(u0, u4);
+	rows[1] = _mm_unpackhi_epi64(u0, u4);
+	rows[2] = _mm_unpacklo_epi64(u1, u5);
+	rows[3] = _mm_unpackhi_epi64(u1, u5);
+	rows[4] = _mm_unpacklo_epi64(u2, u6);
+	rows[5] = _mm_unpackhi_epi64(u2, u6);
+	rows[6] = _mm_unpacklo_epi64(u3, u7);
+	rows[7] = _mm_unpackhi_epi64(u3, u7);
+}
+
+static inline IDCTRow loadRow(const int16 *src) {
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+/** The low bytes of a row, like assigning its values to bytes. */
+static inline __m128i rowBytes(IDCTRow row) {
+	return _mm_packus_epi16(_mm_and_si128(row, _mm_set1_epi16(0xFF)), _mm_setzero_si128());
+}
+
+static inline void addRow(byte *dest, IDCTRow row) {
+	_mm_storel_epi64((__m128i *)dest, _mm_add_epi8(_mm_loadl_epi64((const __m128i *)dest), rowBytes(row)));
+}
+
+/** Put a row at double width. */
+static inline void putScaledRow(byte *dest, IDCTRow row) {
+	const __m128i bytes = rowBytes(row);
+	_mm_storeu_si128((__m128i *)dest, _mm_unpacklo_epi8(bytes, bytes));
+}
+
+/**
+ * The IDCT of a block, as rows of 16 bit values. Both passes work on
+ * eight columns at once, with the block transposed in between.
+ */
+static inline void IDCTRows(IDCTRow *rows, const int16 *block) {
+	for (int i = 0; i < 8; i++)
+		rows[i] = loadRow(block + 8 * i);
+
+	IDCTPass(rows, false);
+	IDCTTranspose(rows);
+	IDCTPass(rows, true);
+	IDCTTranspose(rows);
+}
+void binkIDCTPutScaled(byte *dest, uint32 pitch, int16 *block) {
+	IDCTRow rows[8];
+	IDCTRows(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch << 1) {
+		putScaledRow(dest, rows[i]);
+		putScaledRow(dest + pitch, rows[i]);
+	}
+}
+
+void binkAddResidue(byte *dest, uint32 pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		addRow(dest, loadRow(block));
+}
+
+void binkCopyBlock(byte *dest, uint32 destPitch, const byte *src, uint32 srcPitch, int size) {
+	if (size == 16) {
+		for (int i = 0; i < 16; i++, dest += destPitch, src += srcPitch)
+			_mm_storeu_si128((__m128i *)dest, _mm_loadu_si128((const __m128i *)src));
+	} else {
+		for (int i = 0; i < 8; i++, dest += destPitch, src += srcPitch)
+			_mm_storel_epi64((__m128i *)dest, _mm_loadl_epi64((const __m128i *)src));
+	}
+}
+
+#else
+
+void binkIDCTPutScaled(byte *dest, uint32 pitch, int16 *block) {
+	binkIDCTPutScaledGeneric(dest, pitch, block);
+}
+
+void binkAddResidue(byte *dest, uint32 pitch, const int16 *block) {
+	binkAddResidueGeneric(dest, pitch, block);
+}
+
+void binkCopyBlock(byte *dest, uint32 destPitch, const byte *src, uint32 srcPitch, int size) {
+	binkCopyBlockGeneric(dest, destPitch, src, srcPitch, size);
+}
+
+#endif // SCUMMVM_SSE2
+
+} // End of namespace Video
+
+#endif // USE_BINK
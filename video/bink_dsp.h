@@ -0,0 +1,73 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The IDCT is based on the Bink decoder found in FFmpeg.
+
+#include "common/scummsys.h"
+
+#ifdef USE_BINK
+
+#ifndef VIDEO_BINK_DSP_H
+#define VIDEO_BINK_DSP_H
+
+namespace Video {
+
+/**
+ * @name Bink video block functions
+ *
+ * The inner loops of the Bink video decoder, for 8x8 blocks of 8 bit
+ * pixels. The scaled IDCT, the residue and the block copies are
+ * vectorized with SSE2 where it is available. The *Generic variants are
+ * the plain C++ versions. They are always built, so that the vectorized
+ * versions can be tested against them.
+ *
+ * The IDCT functions may use the coefficient block as scratch space.
+ * @{
+ */
+
+/** Put the IDCT of the coefficients into the block at dest. */
+void binkIDCTPut(byte *dest, uint32 pitch, int16 *block);
+void binkIDCTPutGeneric(byte *dest, uint32 pitch, int16 *block);
+
+/** Add the IDCT of the coefficients to the block at dest. */
+void binkIDCTAdd(byte *dest, uint32 pitch, int16 *block);
+void binkIDCTAddGeneric(byte *dest, uint32 pitch, int16 *block);
+
+/** Put the IDCT of the coefficients into the 16x16 block at dest, doubling every pixel. */
+void binkIDCTPutScaled(byte *dest, uint32 pitch, int16 *block);
+void binkIDCTPutScaledGeneric(byte *dest, uint32 pitch, int16 *block);
+
+/** Add the residue values to the block at dest. */
+void binkAddResidue(byte *dest, uint32 pitch, const int16 *block);
+void binkAddResidueGeneric(byte *dest, uint32 pitch, const int16 *block);
+
+/** Copy a block of size x size pixels, size is either 8 or 16. */
+void binkCopyBlock(byte *dest, uint32 destPitch, const byte *src, uint32 srcPitch, int size);
+void binkCopyBlockGeneric(byte *dest, uint32 destPitch, const byte *src, uint32 srcPitch, int size);
+
+/** @} */
+
+} // End of namespace Video
+
+#endif // VIDEO_BINK_DSP_H
+
+#endif // USE_BINK